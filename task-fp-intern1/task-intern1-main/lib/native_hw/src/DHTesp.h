@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Arduino.h>
+
+struct TempAndHumidity {
+    float temperature;
+    float humidity;
+};
+
+// DHTesp palsu: nilai diatur lewat fakeHw::setDht(), setiap pembacaan
+// memakan waktu virtual seperti protokol bit-bang aslinya.
+class DHTesp {
+public:
+    typedef enum { AUTO_DETECT, DHT11, DHT22, AM2302, RHT03 } DHT_MODEL_t;
+    typedef enum { ERROR_NONE = 0, ERROR_TIMEOUT, ERROR_CHECKSUM } DHT_ERROR_t;
+
+    void setup(uint8_t pin, DHT_MODEL_t model = AUTO_DETECT) { pin_ = pin; model_ = model; }
+    TempAndHumidity getTempAndHumidity();
+    float getTemperature() { return getTempAndHumidity().temperature; }
+    float getHumidity() { return getTempAndHumidity().humidity; }
+    DHT_ERROR_t getStatus() const { return error_; }
+    const char* getStatusString() const { return error_ == ERROR_NONE ? "OK" : "TIMEOUT"; }
+    int getMinimumSamplingPeriod() const { return model_ == DHT11 ? 1000 : 2000; }
+
+private:
+    uint8_t pin_ = 0;
+    DHT_MODEL_t model_ = AUTO_DETECT;
+    DHT_ERROR_t error_ = ERROR_NONE;
+};
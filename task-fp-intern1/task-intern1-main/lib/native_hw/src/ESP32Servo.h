@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define MIN_PULSE_WIDTH 544
+#define MAX_PULSE_WIDTH 2400
+#define DEFAULT_PULSE_WIDTH 1500
+
+// Servo palsu: mencatat posisi terakhir dan jumlah penulisan
+class Servo {
+public:
+    int attach(int pin, int min = MIN_PULSE_WIDTH, int max = MAX_PULSE_WIDTH);
+    void detach() { pin_ = -1; }
+    void write(int value);
+    void writeMicroseconds(int value);
+    int read() const;
+    int readMicroseconds() const { return us_; }
+    bool attached() const { return pin_ >= 0; }
+    uint32_t writeCount() const { return writes_; }
+
+private:
+    int pin_ = -1;
+    int min_ = MIN_PULSE_WIDTH;
+    int max_ = MAX_PULSE_WIDTH;
+    int us_ = DEFAULT_PULSE_WIDTH;
+    uint32_t writes_ = 0;
+};
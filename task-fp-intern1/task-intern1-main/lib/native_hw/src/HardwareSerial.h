@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Stream.h"
+
+// Serial palsu: output ditampung di buffer (atau diteruskan ke stdout),
+// input diisi dari fake_hw.
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { baud_ = baud; }
+    void end() {}
+    unsigned long baudRate() const { return baud_; }
+    size_t setTxBufferSize(size_t size) { txBufferSize_ = size; return size; }
+    size_t setRxBufferSize(size_t size) { return size; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    int availableForWrite() override;
+    void flush() {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    operator bool() const { return true; }
+
+private:
+    unsigned long baud_ = 0;
+    size_t txBufferSize_ = 0;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Preferences (NVS) palsu: disimpan di memori proses, bertahan melewati
+// fakeHw::reset() supaya skenario "reboot" bisa diuji.
+
+namespace fakeHw {
+namespace detail {
+std::map<std::string, std::vector<uint8_t>>& nvsStore();
+}  // namespace detail
+}  // namespace fakeHw
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        ns_ = name;
+        readOnly_ = readOnly;
+        return true;
+    }
+    void end() {}
+    bool clear() {
+        auto& store = fakeHw::detail::nvsStore();
+        for (auto it = store.begin(); it != store.end();) {
+            it = it->first.compare(0, ns_.size() + 1, ns_ + "/") == 0 ? store.erase(it) : std::next(it);
+        }
+        return true;
+    }
+    bool remove(const char* key) { return fakeHw::detail::nvsStore().erase(path(key)) > 0; }
+    bool isKey(const char* key) { return fakeHw::detail::nvsStore().count(path(key)) > 0; }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        if (readOnly_) return 0;
+        const uint8_t* p = static_cast<const uint8_t*>(value);
+        fakeHw::detail::nvsStore()[path(key)].assign(p, p + len);
+        writes_++;
+        return len;
+    }
+    size_t getBytesLength(const char* key) {
+        auto& store = fakeHw::detail::nvsStore();
+        auto it = store.find(path(key));
+        return it == store.end() ? 0 : it->second.size();
+    }
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        auto& store = fakeHw::detail::nvsStore();
+        auto it = store.find(path(key));
+        if (it == store.end() || it->second.size() > maxLen) return 0;
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+    size_t putUChar(const char* key, uint8_t value) { return putBytes(key, &value, 1); }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) {
+        uint8_t v = defaultValue;
+        return getBytes(key, &v, 1) ? v : defaultValue;
+    }
+    size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, 4); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) {
+        uint32_t v = defaultValue;
+        return getBytes(key, &v, 4) ? v : defaultValue;
+    }
+
+    static uint32_t writes_;
+
+private:
+    std::string path(const char* key) const { return ns_ + "/" + key; }
+    std::string ns_;
+    bool readOnly_ = false;
+};
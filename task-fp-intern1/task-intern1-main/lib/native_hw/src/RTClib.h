@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SECONDS_FROM_1970_TO_2000 946684800
+
+class TimeSpan;
+
+// DateTime dan RTC_DS1307 versi ringkas dengan API yang sama dengan RTClib
+class DateTime {
+public:
+    DateTime(uint32_t t = SECONDS_FROM_1970_TO_2000);
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+    DateTime(const char* date, const char* time);
+
+    uint16_t year() const { return 2000U + yOff; }
+    uint8_t month() const { return m; }
+    uint8_t day() const { return d; }
+    uint8_t hour() const { return hh; }
+    uint8_t minute() const { return mm; }
+    uint8_t second() const { return ss; }
+    uint8_t dayOfTheWeek() const;
+    uint32_t secondstime() const;
+    uint32_t unixtime() const;
+    bool isValid() const;
+
+    DateTime operator+(const TimeSpan& span) const;
+    DateTime operator-(const TimeSpan& span) const;
+    TimeSpan operator-(const DateTime& right) const;
+    bool operator<(const DateTime& right) const { return unixtime() < right.unixtime(); }
+    bool operator>(const DateTime& right) const { return right < *this; }
+    bool operator==(const DateTime& right) const { return unixtime() == right.unixtime(); }
+    bool operator!=(const DateTime& right) const { return !(*this == right); }
+
+protected:
+    uint8_t yOff;
+    uint8_t m;
+    uint8_t d;
+    uint8_t hh;
+    uint8_t mm;
+    uint8_t ss;
+};
+
+class TimeSpan {
+public:
+    TimeSpan(int32_t seconds = 0) : _seconds(seconds) {}
+    TimeSpan(int16_t days, int8_t hours, int8_t minutes, int8_t seconds)
+        : _seconds((int32_t)days * 86400L + (int32_t)hours * 3600 + (int32_t)minutes * 60 + seconds) {}
+    int16_t days() const { return _seconds / 86400L; }
+    int8_t hours() const { return _seconds / 3600 % 24; }
+    int8_t minutes() const { return _seconds / 60 % 60; }
+    int8_t seconds() const { return _seconds % 60; }
+    int32_t totalseconds() const { return _seconds; }
+
+protected:
+    int32_t _seconds;
+};
+
+enum Ds1307SqwPinMode {
+    DS1307_OFF = 0x00,
+    DS1307_ON = 0x80,
+    DS1307_SquareWave1HZ = 0x10,
+    DS1307_SquareWave4kHz = 0x11,
+    DS1307_SquareWave8kHz = 0x12,
+    DS1307_SquareWave32kHz = 0x13
+};
+
+class RTC_DS1307 {
+public:
+    bool begin(TwoWire* wireInstance = &Wire);
+    void adjust(const DateTime& dt);
+    uint8_t isrunning();
+    DateTime now();
+    Ds1307SqwPinMode readSqwPinMode();
+    void writeSqwPinMode(Ds1307SqwPinMode mode);
+
+private:
+    TwoWire* wire_ = &Wire;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+
+// String minimal ala Arduino. Sengaja selalu mengalokasi di heap
+// (seperti WString asli) supaya pelacakan alokasi di build native realistis.
+class String {
+public:
+    String(const char* str = "");
+    String(const String& other);
+    ~String();
+    String& operator=(const String& other);
+    String& operator=(const char* str);
+    String& operator+=(const char* str);
+    String& operator+=(const String& other) { return *this += other.c_str(); }
+
+    const char* c_str() const { return buffer_; }
+    unsigned int length() const { return length_; }
+    bool operator==(const char* str) const;
+
+private:
+    void assign(const char* str, size_t len);
+    char* buffer_ = nullptr;
+    unsigned int length_ = 0;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Stream.h"
+
+#define I2C_BUFFER_LENGTH 128
+
+// TwoWire palsu. Transaksi diteruskan ke perangkat I2C palsu (panel SSD1306
+// dan DS1307) dan memakan waktu virtual sesuai clock bus.
+class TwoWire : public Stream {
+public:
+    bool begin();
+    bool begin(int sda, int scl, uint32_t frequency = 0);
+    bool end();
+    bool setClock(uint32_t frequency);
+    uint32_t getClock() const { return clock_; }
+    void setTimeOut(uint16_t timeoutMs) { (void)timeoutMs; }
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t quantity) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+
+private:
+    uint32_t clock_ = 100000;
+    uint8_t address_ = 0;
+    uint8_t txBuffer_[I2C_BUFFER_LENGTH];
+    size_t txLength_ = 0;
+    bool txOverflow_ = false;
+    uint8_t rxBuffer_[I2C_BUFFER_LENGTH];
+    size_t rxLength_ = 0;
+    size_t rxIndex_ = 0;
+};
+
+extern TwoWire Wire;
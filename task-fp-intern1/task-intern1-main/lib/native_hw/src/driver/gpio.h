@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Bagian driver GPIO ESP-IDF yang dipakai untuk wake dari light sleep.
+// Seperti di IDF, gpio_wakeup_enable() mengganti tipe interupsi pin menjadi
+// level; interupsi tepi dari attachInterrupt() baru berjalan lagi setelah
+// gpio_set_intr_type() memasang tipe tepi kembali.
+
+typedef int gpio_num_t;
+
+typedef enum {
+    GPIO_INTR_DISABLE,
+    GPIO_INTR_POSEDGE,
+    GPIO_INTR_NEGEDGE,
+    GPIO_INTR_ANYEDGE,
+    GPIO_INTR_LOW_LEVEL,
+    GPIO_INTR_HIGH_LEVEL,
+} gpio_int_type_t;
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type);
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num);
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num);
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type);
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "esp_err.h"
+
+// Bagian driver UART ESP-IDF untuk wake dari light sleep; Serial palsu tidak
+// memodelkan RX selama tidur, jadi hanya diterima dan diabaikan.
+
+typedef int uart_port_t;
+
+#define UART_NUM_0 0
+
+esp_err_t uart_set_wakeup_threshold(uart_port_t uart_num, int wakeup_threshold);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Light sleep palsu: esp_light_sleep_start() memajukan jam virtual sampai
+// timer wakeup, atau lebih awal jika pin yang diaktifkan gpio_wakeup_enable()
+// mencapai level wake-nya (lihat fakeHw::setPinAt). esp_timer tidak dijalankan
+// selama tidur, sama seperti di ESP32; yang terlambat jalan saat jam dimajukan lagi.
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART,
+} esp_sleep_source_t;
+
+typedef esp_sleep_source_t esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+esp_err_t esp_sleep_enable_gpio_wakeup();
+esp_err_t esp_sleep_enable_uart_wakeup(int uart_num);
+esp_err_t esp_light_sleep_start();
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
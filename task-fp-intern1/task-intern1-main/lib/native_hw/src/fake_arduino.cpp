@@ -0,0 +1,610 @@
+#include <Arduino.h>
+
+#include "driver/gpio.h"
+#include "driver/uart.h"
+#include "esp_sleep.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "fake_hw.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace {
+
+const int PIN_COUNT = 40;
+
+struct PinState {
+    uint8_t mode;
+    int input;
+    int output;
+    uint16_t analog;
+    uint32_t writes;
+    void (*isr)();
+    void (*isrArg)(void*);
+    void* arg;
+    int isrMode;
+    bool intrEnabled;
+    int wakeLevel;  // -1 = bukan sumber wake
+};
+
+// Perubahan level pin terjadwal (fakeHw::setPinAt)
+struct PinEvent {
+    uint64_t atUs;
+    uint8_t pin;
+    int level;
+    bool used;
+};
+
+const int MAX_PIN_EVENTS = 16;
+PinEvent pinEvents[MAX_PIN_EVENTS];
+
+// Light sleep
+const uint64_t LIGHT_SLEEP_EXIT_US = 200;  // Keluar dari light sleep: PLL dan flash menyala lagi
+uint64_t sleepTimerUs = 0;
+bool gpioWakeEnabled = false;
+esp_sleep_wakeup_cause_t wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+fakeHw::SleepStats sleepStats = {};
+esp_reset_reason_t resetReason = ESP_RST_POWERON;
+
+uint64_t clockUs = 0;
+PinState pins[PIN_COUNT];
+uint32_t randomState = 1;
+
+const size_t SERIAL_BUFFER = 64 * 1024;
+uint8_t serialRx[SERIAL_BUFFER];
+size_t serialRxHead = 0;
+size_t serialRxTail = 0;
+uint8_t serialTx[SERIAL_BUFFER];
+size_t serialTxLength = 0;
+bool serialEchoEnabled = true;
+
+float dhtTemperature = 24.0f;
+float dhtHumidity = 40.0f;
+bool dhtFailing = false;
+uint32_t dhtReads = 0;
+
+}  // namespace
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    uint64_t dueUs;
+    uint64_t periodUs;
+    bool active;
+    bool used;
+};
+
+namespace {
+
+const int MAX_TIMERS = 16;
+esp_timer timers[MAX_TIMERS];
+
+// Timer aktif dengan jatuh tempo paling awal yang <= limitUs
+esp_timer* nextDueTimer(uint64_t limitUs) {
+    esp_timer* next = nullptr;
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        esp_timer& t = timers[i];
+        if (t.used && t.active && t.dueUs <= limitUs && (next == nullptr || t.dueUs < next->dueUs)) {
+            next = &t;
+        }
+    }
+    return next;
+}
+
+// Perubahan pin terjadwal paling awal yang <= limitUs
+PinEvent* nextPinEvent(uint64_t limitUs) {
+    PinEvent* next = nullptr;
+    for (int i = 0; i < MAX_PIN_EVENTS; i++) {
+        PinEvent& e = pinEvents[i];
+        if (e.used && e.atUs <= limitUs && (next == nullptr || e.atUs < next->atUs)) {
+            next = &e;
+        }
+    }
+    return next;
+}
+
+bool wakePinActive() {
+    for (int i = 0; i < PIN_COUNT; i++) {
+        if (pins[i].wakeLevel >= 0 && pins[i].input == pins[i].wakeLevel) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+namespace fakeHw {
+
+uint64_t nowUs() { return clockUs; }
+void setNowUs(uint64_t us) { clockUs = us; }
+void advanceUs(uint64_t us) {
+    uint64_t target = clockUs + us;
+    for (;;) {
+        esp_timer* t = nextDueTimer(target);
+        PinEvent* e = nextPinEvent(target);
+        if (e != nullptr && (t == nullptr || e->atUs <= t->dueUs)) {
+            if (e->atUs > clockUs) clockUs = e->atUs;
+            e->used = false;
+            setPin(e->pin, e->level);
+            continue;
+        }
+        if (t == nullptr) break;
+        if (t->dueUs > clockUs) clockUs = t->dueUs;
+        if (t->periodUs > 0) {
+            t->dueUs += t->periodUs;
+        } else {
+            t->active = false;
+        }
+        t->callback(t->arg);
+    }
+    if (target > clockUs) clockUs = target;
+}
+void spendUs(uint64_t us) { clockUs += us; }
+
+void setPin(uint8_t pin, int level) {
+    if (pin >= PIN_COUNT) return;
+    PinState& p = pins[pin];
+    int previous = p.input;
+    p.input = level ? HIGH : LOW;
+    if ((p.isr == nullptr && p.isrArg == nullptr) || !p.intrEnabled || previous == p.input) return;
+    bool rising = p.input == HIGH;
+    if (p.isrMode == CHANGE || (p.isrMode == RISING && rising) || (p.isrMode == FALLING && !rising)) {
+        if (p.isrArg != nullptr) {
+            p.isrArg(p.arg);
+        } else {
+            p.isr();
+        }
+    }
+}
+
+void setPinAt(uint64_t atUs, uint8_t pin, int level) {
+    for (int i = 0; i < MAX_PIN_EVENTS; i++) {
+        if (!pinEvents[i].used) {
+            pinEvents[i] = PinEvent{atUs, pin, level, true};
+            return;
+        }
+    }
+}
+
+int pinOutput(uint8_t pin) { return pin < PIN_COUNT ? pins[pin].output : LOW; }
+uint32_t pinWriteCount(uint8_t pin) { return pin < PIN_COUNT ? pins[pin].writes : 0; }
+void setAnalog(uint8_t pin, uint16_t value) {
+    if (pin < PIN_COUNT) pins[pin].analog = value;
+}
+
+void setDht(float temperature, float humidity) {
+    dhtTemperature = temperature;
+    dhtHumidity = humidity;
+}
+void setDhtFailing(bool failing) { dhtFailing = failing; }
+uint32_t dhtReadCount() { return dhtReads; }
+
+bool detail::dhtRead(float& temperature, float& humidity) {
+    dhtReads++;
+    temperature = dhtTemperature;
+    humidity = dhtHumidity;
+    return !dhtFailing;
+}
+
+void serialInput(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        serialRx[serialRxHead] = data[i];
+        serialRxHead = (serialRxHead + 1) % SERIAL_BUFFER;
+    }
+}
+
+size_t serialOutput(uint8_t* data, size_t capacity) {
+    size_t n = serialTxLength < capacity ? serialTxLength : capacity;
+    memcpy(data, serialTx, n);
+    memmove(serialTx, serialTx + n, serialTxLength - n);
+    serialTxLength -= n;
+    return n;
+}
+
+void serialEcho(bool enabled) { serialEchoEnabled = enabled; }
+
+SleepStats lightSleepStats() { return sleepStats; }
+
+void setResetReason(int reason) { resetReason = (esp_reset_reason_t)reason; }
+
+void reset() {
+    clockUs = 0;
+    for (int i = 0; i < PIN_COUNT; i++) {
+        pins[i] = PinState{INPUT, HIGH, LOW, 0, 0, nullptr, nullptr, nullptr, 0, true, -1};
+    }
+    memset(pinEvents, 0, sizeof(pinEvents));
+    sleepTimerUs = 0;
+    gpioWakeEnabled = false;
+    wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+    sleepStats = {};
+    resetReason = ESP_RST_POWERON;
+    randomState = 1;
+    memset(timers, 0, sizeof(timers));
+    serialRxHead = serialRxTail = 0;
+    serialTxLength = 0;
+    dhtTemperature = 24.0f;
+    dhtHumidity = 40.0f;
+    dhtFailing = false;
+    dhtReads = 0;
+    detail::resetDevices();
+    detail::resetFlash();
+}
+
+}  // namespace fakeHw
+
+unsigned long millis() { return (unsigned long)(clockUs / 1000); }
+unsigned long micros() { return (unsigned long)clockUs; }
+void delay(uint32_t ms) { fakeHw::advanceUs((uint64_t)ms * 1000); }
+void delayMicroseconds(uint32_t us) { fakeHw::advanceUs(us); }
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < PIN_COUNT) pins[pin].mode = mode;
+}
+
+int digitalRead(uint8_t pin) { return pin < PIN_COUNT ? pins[pin].input : LOW; }
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= PIN_COUNT) return;
+    pins[pin].output = val ? HIGH : LOW;
+    pins[pin].writes++;
+}
+
+uint16_t analogRead(uint8_t pin) {
+    fakeHw::spendUs(10);  // Konversi SAR ADC ESP32 kira-kira 10 us
+    return pin < PIN_COUNT ? pins[pin].analog : 0;
+}
+
+void analogReadResolution(uint8_t bits) { (void)bits; }
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    if (pin >= PIN_COUNT) return;
+    pins[pin].isr = isr;
+    pins[pin].isrArg = nullptr;
+    pins[pin].isrMode = mode;
+}
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+    if (pin >= PIN_COUNT) return;
+    pins[pin].isr = nullptr;
+    pins[pin].isrArg = isr;
+    pins[pin].arg = arg;
+    pins[pin].isrMode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin >= PIN_COUNT) return;
+    pins[pin].isr = nullptr;
+    pins[pin].isrArg = nullptr;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    if (in_max == in_min) return out_min;
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    // xorshift32, deterministik supaya hasil benchmark bisa diulang
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) randomState = seed;
+}
+
+// ---- Print ----
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::write(const char* str) {
+    if (str == nullptr) return 0;
+    return write((const uint8_t*)str, strlen(str));
+}
+
+// Sama dengan Arduino-ESP32: buffer stack 64 byte, teks lebih panjang lewat malloc()
+size_t Print::printf(const char* format, ...) {
+    char local[64];
+    char* buffer = local;
+    va_list args;
+    va_list copy;
+    va_start(args, format);
+    va_copy(copy, args);
+    int len = vsnprintf(local, sizeof(local), format, copy);
+    va_end(copy);
+    if (len < 0) {
+        va_end(args);
+        return 0;
+    }
+    if ((size_t)len >= sizeof(local)) {
+        buffer = (char*)malloc(len + 1);
+        if (buffer == nullptr) {
+            va_end(args);
+            return 0;
+        }
+        vsnprintf(buffer, len + 1, format, args);
+    }
+    va_end(args);
+    size_t written = write((const uint8_t*)buffer, len);
+    if (buffer != local) free(buffer);
+    return written;
+}
+
+size_t Print::print(const char* str) { return write(str); }
+size_t Print::print(const String& str) { return write(str.c_str()); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char n, int base) { return printNumber(n, base); }
+size_t Print::print(int n, int base) { return print((long long)n, base); }
+size_t Print::print(unsigned int n, int base) { return printNumber(n, base); }
+size_t Print::print(long n, int base) { return print((long long)n, base); }
+size_t Print::print(unsigned long n, int base) { return printNumber(n, base); }
+size_t Print::print(unsigned long long n, int base) { return printNumber(n, base); }
+
+size_t Print::print(long long n, int base) {
+    if (n < 0 && base == DEC) {
+        size_t t = write('-');
+        return t + printNumber((unsigned long long)(-n), base);
+    }
+    return printNumber((unsigned long long)n, base);
+}
+
+size_t Print::print(double n, int digits) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+    return write(buffer);
+}
+
+size_t Print::println() { return write("\r\n"); }
+
+size_t Print::printNumber(unsigned long long n, int base) {
+    char buffer[66];
+    char* str = &buffer[sizeof(buffer) - 1];
+    *str = '\0';
+    if (base < 2) base = 10;
+    do {
+        int digit = n % base;
+        n /= base;
+        *--str = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    } while (n);
+    return write(str);
+}
+
+// ---- String ----
+
+String::String(const char* str) { assign(str, strlen(str)); }
+String::String(const String& other) { assign(other.buffer_, other.length_); }
+String::~String() { free(buffer_); }
+
+String& String::operator=(const String& other) {
+    if (this != &other) assign(other.buffer_, other.length_);
+    return *this;
+}
+
+String& String::operator=(const char* str) {
+    assign(str, strlen(str));
+    return *this;
+}
+
+String& String::operator+=(const char* str) {
+    size_t extra = strlen(str);
+    char* grown = (char*)realloc(buffer_, length_ + extra + 1);
+    if (grown == nullptr) return *this;
+    memcpy(grown + length_, str, extra + 1);
+    buffer_ = grown;
+    length_ += extra;
+    return *this;
+}
+
+bool String::operator==(const char* str) const { return strcmp(buffer_, str) == 0; }
+
+void String::assign(const char* str, size_t len) {
+    char* copy = (char*)malloc(len + 1);
+    if (copy == nullptr) return;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    free(buffer_);
+    buffer_ = copy;
+    length_ = len;
+}
+
+// ---- HardwareSerial ----
+
+int HardwareSerial::available() {
+    return (int)((serialRxHead + SERIAL_BUFFER - serialRxTail) % SERIAL_BUFFER);
+}
+
+int HardwareSerial::read() {
+    if (serialRxHead == serialRxTail) return -1;
+    uint8_t c = serialRx[serialRxTail];
+    serialRxTail = (serialRxTail + 1) % SERIAL_BUFFER;
+    return c;
+}
+
+int HardwareSerial::peek() {
+    if (serialRxHead == serialRxTail) return -1;
+    return serialRx[serialRxTail];
+}
+
+int HardwareSerial::availableForWrite() {
+    return (int)(SERIAL_BUFFER - serialTxLength);
+}
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (serialEchoEnabled) {
+        fwrite(buffer, 1, size, stdout);
+        return size;
+    }
+    size_t room = SERIAL_BUFFER - serialTxLength;
+    if (size > room) size = room;
+    memcpy(serialTx + serialTxLength, buffer, size);
+    serialTxLength += size;
+    return size;
+}
+
+// ---- EspClass ----
+
+uint32_t EspClass::getCycleCount() { return (uint32_t)(clockUs * 240); }
+uint32_t EspClass::getFreeHeap() { return 200 * 1024; }
+uint32_t EspClass::getMinFreeHeap() { return 200 * 1024; }
+uint32_t EspClass::getMaxAllocHeap() { return 110 * 1024; }
+void EspClass::restart() { abort(); }
+
+// ---- esp_timer ----
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle) {
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (!timers[i].used) {
+            timers[i] = esp_timer{create_args->callback, create_args->arg, 0, 0, false, true};
+            *out_handle = &timers[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    if (timer->active) return ESP_ERR_INVALID_STATE;
+    timer->dueUs = clockUs + timeout_us;
+    timer->periodUs = 0;
+    timer->active = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+    if (timer->active) return ESP_ERR_INVALID_STATE;
+    timer->dueUs = clockUs + period;
+    timer->periodUs = period;
+    timer->active = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (!timer->active) return ESP_ERR_INVALID_STATE;
+    timer->active = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    timer->used = false;
+    timer->active = false;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) { return timer->active; }
+
+int64_t esp_timer_get_time() { return (int64_t)clockUs; }
+
+int64_t esp_timer_get_next_alarm() {
+    esp_timer* next = nextDueTimer(UINT64_MAX);
+    return next ? (int64_t)next->dueUs : INT64_MAX;
+}
+
+// ---- esp_sleep ----
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+    sleepTimerUs = time_in_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup() {
+    gpioWakeEnabled = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_uart_wakeup(int uart_num) {
+    (void)uart_num;  // Serial palsu tidak memodelkan RX selama tidur
+    return ESP_OK;
+}
+
+esp_err_t uart_set_wakeup_threshold(uart_port_t uart_num, int wakeup_threshold) {
+    (void)uart_num;
+    (void)wakeup_threshold;
+    return ESP_OK;
+}
+
+// Jam dimajukan ke timer wakeup; perubahan pin terjadwal diterapkan di
+// tengah jalan (tanpa ISR jika interupsinya mati) dan bisa membangunkan lebih awal
+esp_err_t esp_light_sleep_start() {
+    uint64_t start = clockUs;
+    uint64_t wakeUs = sleepTimerUs > 0 ? clockUs + sleepTimerUs : UINT64_MAX;
+    wakeCause = ESP_SLEEP_WAKEUP_TIMER;
+    for (;;) {
+        if (gpioWakeEnabled && wakePinActive()) {
+            wakeCause = ESP_SLEEP_WAKEUP_GPIO;
+            break;
+        }
+        PinEvent* e = nextPinEvent(wakeUs);
+        if (e == nullptr) break;
+        if (e->atUs > clockUs) clockUs = e->atUs;
+        e->used = false;
+        fakeHw::setPin(e->pin, e->level);
+    }
+    if (wakeCause == ESP_SLEEP_WAKEUP_TIMER) {
+        if (wakeUs == UINT64_MAX) {
+            wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+            return ESP_ERR_INVALID_STATE;  // Tidak ada sumber wake, ESP32 akan tidur selamanya
+        }
+        clockUs = wakeUs;
+    }
+    sleepStats.sleeps++;
+    sleepStats.sleepUs += clockUs - start;
+    if (wakeCause == ESP_SLEEP_WAKEUP_GPIO) sleepStats.gpioWakes++;
+    clockUs += LIGHT_SLEEP_EXIT_US;
+    return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return wakeCause; }
+
+esp_reset_reason_t esp_reset_reason() { return resetReason; }
+
+// ---- driver/gpio ----
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+    if (gpio_num < 0 || gpio_num >= PIN_COUNT) return ESP_ERR_INVALID_ARG;
+    static const int modes[] = {0, RISING, FALLING, CHANGE, 0, 0};  // Interupsi level tidak dimodelkan
+    pins[gpio_num].isrMode = modes[intr_type];
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num) {
+    if (gpio_num < 0 || gpio_num >= PIN_COUNT) return ESP_ERR_INVALID_ARG;
+    pins[gpio_num].intrEnabled = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num) {
+    if (gpio_num < 0 || gpio_num >= PIN_COUNT) return ESP_ERR_INVALID_ARG;
+    pins[gpio_num].intrEnabled = false;
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+    if (gpio_num < 0 || gpio_num >= PIN_COUNT) return ESP_ERR_INVALID_ARG;
+    if (intr_type != GPIO_INTR_LOW_LEVEL && intr_type != GPIO_INTR_HIGH_LEVEL) return ESP_ERR_INVALID_ARG;
+    pins[gpio_num].wakeLevel = intr_type == GPIO_INTR_LOW_LEVEL ? LOW : HIGH;
+    gpio_set_intr_type(gpio_num, intr_type);
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num) {
+    if (gpio_num < 0 || gpio_num >= PIN_COUNT) return ESP_ERR_INVALID_ARG;
+    pins[gpio_num].wakeLevel = -1;
+    gpio_set_intr_type(gpio_num, GPIO_INTR_DISABLE);
+    return ESP_OK;
+}
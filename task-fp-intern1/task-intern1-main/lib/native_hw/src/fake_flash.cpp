@@ -0,0 +1,90 @@
+#include <esp_partition.h>
+#include <string.h>
+
+#include <vector>
+
+#include "fake_hw.h"
+
+namespace {
+
+// Sama dengan baris "history" di partitions.csv
+const esp_partition_t historyPartition = {
+    ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x290000, 0x100000, "history", false,
+};
+
+// Perkiraan waktu flash SPI ESP32 (cache dimatikan selama operasi)
+const uint32_t FLASH_READ_BYTES_PER_US = 16;
+const uint32_t FLASH_PROGRAM_US_PER_PAGE = 500;
+const uint32_t FLASH_ERASE_US_PER_SECTOR = 30000;
+
+std::vector<uint8_t>& flash() {
+    static std::vector<uint8_t> data(historyPartition.size, 0xFF);
+    return data;
+}
+
+fakeHw::FlashStats stats = {};
+size_t powerCutBytes = SIZE_MAX;  // Sisa byte yang masih tertulis sebelum "listrik padam"
+
+bool inRange(const esp_partition_t* partition, size_t offset, size_t size) {
+    return partition == &historyPartition && offset + size <= partition->size && offset + size >= offset;
+}
+
+}  // namespace
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    if (type != historyPartition.type) return nullptr;
+    if (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != historyPartition.subtype) return nullptr;
+    if (label && strcmp(label, historyPartition.label) != 0) return nullptr;
+    return &historyPartition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size) {
+    if (!inRange(partition, src_offset, size)) return ESP_ERR_INVALID_ARG;
+    memcpy(dst, flash().data() + src_offset, size);
+    stats.reads++;
+    stats.bytesRead += size;
+    fakeHw::spendUs(2 + size / FLASH_READ_BYTES_PER_US);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset, const void* src, size_t size) {
+    if (!inRange(partition, dst_offset, size)) return ESP_ERR_INVALID_ARG;
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < size && powerCutBytes > 0; i++, powerCutBytes--) {
+        flash()[dst_offset + i] &= in[i];  // NOR: bit hanya bisa turun ke 0
+    }
+    stats.writes++;
+    stats.bytesWritten += size;
+    fakeHw::spendUs((size + 255) / 256 * FLASH_PROGRAM_US_PER_PAGE);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    if (!inRange(partition, offset, size) || offset % SPI_FLASH_SEC_SIZE || size % SPI_FLASH_SEC_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (powerCutBytes > 0) {
+        memset(flash().data() + offset, 0xFF, size);
+    }
+    stats.erases += size / SPI_FLASH_SEC_SIZE;
+    fakeHw::spendUs(size / SPI_FLASH_SEC_SIZE * FLASH_ERASE_US_PER_SECTOR);
+    return ESP_OK;
+}
+
+namespace fakeHw {
+
+FlashStats flashStats() { return stats; }
+void resetFlashStats() { stats = {}; }
+void cutFlashPowerAfter(size_t bytes) { powerCutBytes = bytes; }
+
+void clearFlash() {
+    flash().assign(historyPartition.size, 0xFF);
+    stats = {};
+}
+
+namespace detail {
+void resetFlash() { powerCutBytes = SIZE_MAX; }
+}  // namespace detail
+
+}  // namespace fakeHw
@@ -0,0 +1,380 @@
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+
+#include "fake_hw.h"
+
+namespace {
+
+// Glyph 5x7 sintetis: pola bit deterministik per karakter (spasi kosong)
+uint8_t glyphColumn(unsigned char c, int column) {
+    if (c == ' ' || column >= 5) return 0;
+    uint32_t h = (c * 2654435761u) ^ (column * 40503u);
+    h ^= h >> 13;
+    return (uint8_t)((h & 0x7F) | 0x01);
+}
+
+void swap16(int16_t& a, int16_t& b) {
+    int16_t t = a;
+    a = b;
+    b = t;
+}
+
+}  // namespace
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        swap16(x0, y0);
+        swap16(x1, y1);
+    }
+    if (x0 > x1) {
+        swap16(x0, x1);
+        swap16(y0, y1);
+    }
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+        if (steep) {
+            drawPixel(y0, x0, color);
+        } else {
+            drawPixel(x0, y0, color);
+        }
+        err -= dy;
+        if (err < 0) {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+    drawPixel(x0, y0 + r, color);
+    drawPixel(x0, y0 - r, color);
+    drawPixel(x0 + r, y0, color);
+    drawPixel(x0 - r, y0, color);
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        drawPixel(x0 + x, y0 + y, color);
+        drawPixel(x0 - x, y0 + y, color);
+        drawPixel(x0 + x, y0 - y, color);
+        drawPixel(x0 - x, y0 - y, color);
+        drawPixel(x0 + y, y0 + x, color);
+        drawPixel(x0 - y, y0 + x, color);
+        drawPixel(x0 + y, y0 - x, color);
+        drawPixel(x0 - y, y0 - x, color);
+    }
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+    int16_t px = x;
+    int16_t py = y;
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        if (x < (y + 1)) {
+            drawFastVLine(x0 + x, y0 - y, 2 * y + 1, color);
+            drawFastVLine(x0 - x, y0 - y, 2 * y + 1, color);
+        }
+        if (y != py) {
+            drawFastVLine(x0 + py, y0 - px, 2 * px + 1, color);
+            drawFastVLine(x0 - py, y0 - px, 2 * px + 1, color);
+            py = y;
+        }
+        px = x;
+    }
+}
+
+void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+                                uint16_t color) {
+    // Scanline sederhana berbasis bounding box
+    int16_t minY = min(y0, min(y1, y2));
+    int16_t maxY = max(y0, max(y1, y2));
+    int16_t minX = min(x0, min(x1, x2));
+    int16_t maxX = max(x0, max(x1, x2));
+    for (int16_t y = minY; y <= maxY; y++) {
+        for (int16_t x = minX; x <= maxX; x++) {
+            int32_t d1 = (int32_t)(x - x1) * (y0 - y1) - (int32_t)(x0 - x1) * (y - y1);
+            int32_t d2 = (int32_t)(x - x2) * (y1 - y2) - (int32_t)(x1 - x2) * (y - y2);
+            int32_t d3 = (int32_t)(x - x0) * (y2 - y0) - (int32_t)(x2 - x0) * (y - y0);
+            bool neg = d1 < 0 || d2 < 0 || d3 < 0;
+            bool pos = d1 > 0 || d2 > 0 || d3 > 0;
+            if (!(neg && pos)) drawPixel(x, y, color);
+        }
+    }
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    (void)r;
+    drawRect(x, y, w, h, color);
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                              uint16_t color) {
+    int16_t byteWidth = (w + 7) / 8;
+    for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) {
+            if (bitmap[j * byteWidth + i / 8] & (0x80 >> (i & 7))) drawPixel(x + i, y + j, color);
+        }
+    }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                              uint16_t color, uint16_t bg) {
+    int16_t byteWidth = (w + 7) / 8;
+    for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) {
+            bool on = bitmap[j * byteWidth + i / 8] & (0x80 >> (i & 7));
+            drawPixel(x + i, y + j, on ? color : bg);
+        }
+    }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                            uint8_t size) {
+    drawChar(x, y, c, color, bg, size, size);
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                            uint8_t size_x, uint8_t size_y) {
+    if (x >= _width || y >= _height || (x + 6 * size_x - 1) < 0 || (y + 8 * size_y - 1) < 0) return;
+    for (int8_t i = 0; i < 6; i++) {
+        uint8_t line = glyphColumn(c, i);
+        for (int8_t j = 0; j < 8; j++, line >>= 1) {
+            if (line & 1) {
+                if (size_x == 1 && size_y == 1) {
+                    drawPixel(x + i, y + j, color);
+                } else {
+                    fillRect(x + i * size_x, y + j * size_y, size_x, size_y, color);
+                }
+            } else if (bg != color) {
+                if (size_x == 1 && size_y == 1) {
+                    drawPixel(x + i, y + j, bg);
+                } else {
+                    fillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);
+                }
+            }
+        }
+    }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+        if (wrap && (cursor_x + textsize_x * 6) > _width) {
+            cursor_x = 0;
+            cursor_y += textsize_y * 8;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+        cursor_x += textsize_x * 6;
+    }
+    return 1;
+}
+
+void Adafruit_GFX::getTextBounds(const char* str, int16_t x, int16_t y, int16_t* x1, int16_t* y1,
+                                 uint16_t* w, uint16_t* h) {
+    int16_t maxx = x;
+    int16_t cx = x;
+    int16_t cy = y;
+    for (const char* p = str; *p; p++) {
+        if (*p == '\n') {
+            cx = 0;
+            cy += textsize_y * 8;
+        } else if (*p != '\r') {
+            if (wrap && (cx + textsize_x * 6) > _width) {
+                cx = 0;
+                cy += textsize_y * 8;
+            }
+            cx += textsize_x * 6;
+            if (cx - 1 > maxx) maxx = cx - 1;
+        }
+    }
+    *x1 = x;
+    *y1 = y;
+    *w = maxx > x ? maxx - x + 1 : 0;
+    *h = cy - y + textsize_y * 8;
+}
+
+// ---- Adafruit_SSD1306 ----
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin, uint32_t clkDuring,
+                                   uint32_t clkAfter)
+    : Adafruit_GFX(w, h), wire(twi), wireClk(clkDuring), restoreClk(clkAfter) {
+    (void)rst_pin;
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() { free(buffer); }
+
+bool Adafruit_SSD1306::begin(uint8_t vcs, uint8_t addr, bool reset, bool periphBegin) {
+    (void)reset;
+    if (buffer == nullptr) {
+        buffer = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8));
+        if (buffer == nullptr) return false;
+    }
+    clearDisplay();
+    vccstate = vcs;
+    i2caddr = addr ? addr : 0x3C;
+    if (periphBegin) wire->begin();
+
+    static const uint8_t init[] = {SSD1306_DISPLAYOFF, SSD1306_SETDISPLAYCLOCKDIV, 0x80, SSD1306_SETMULTIPLEX,
+                                   (uint8_t)(HEIGHT - 1), SSD1306_SETDISPLAYOFFSET, 0x00, SSD1306_SETSTARTLINE,
+                                   SSD1306_CHARGEPUMP, 0x14, SSD1306_MEMORYMODE, 0x00, SSD1306_SEGREMAP | 0x1,
+                                   SSD1306_COMSCANDEC, SSD1306_SETCOMPINS, 0x12, SSD1306_SETCONTRAST, 0xCF,
+                                   SSD1306_SETPRECHARGE, 0xF1, SSD1306_SETVCOMDETECT, 0x40,
+                                   SSD1306_DISPLAYALLON_RESUME, SSD1306_NORMALDISPLAY, SSD1306_DISPLAYON};
+    wire->setClock(wireClk);
+    ssd1306_commandList(init, sizeof(init));
+    wire->setClock(restoreClk);
+    return true;
+}
+
+void Adafruit_SSD1306::display() {
+    static const uint8_t dlist1[] = {SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0};
+    wire->setClock(wireClk);
+    ssd1306_commandList(dlist1, sizeof(dlist1));
+    ssd1306_command1(WIDTH - 1);
+
+    uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+    uint8_t* ptr = buffer;
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x40);
+    uint16_t bytesOut = 1;
+    while (count--) {
+        if (bytesOut >= I2C_BUFFER_LENGTH) {
+            wire->endTransmission();
+            wire->beginTransmission(i2caddr);
+            wire->write((uint8_t)0x40);
+            bytesOut = 1;
+        }
+        wire->write(*ptr++);
+        bytesOut++;
+    }
+    wire->endTransmission();
+    wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::clearDisplay() { memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8)); }
+
+void Adafruit_SSD1306::invertDisplay(bool i) {
+    wire->setClock(wireClk);
+    ssd1306_command1(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
+    wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::dim(bool dim) {
+    contrast = dim ? 0 : (vccstate == SSD1306_EXTERNALVCC ? 0x9F : 0xCF);
+    wire->setClock(wireClk);
+    ssd1306_command1(SSD1306_SETCONTRAST);
+    ssd1306_command1(contrast);
+    wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) return;
+    uint8_t& b = buffer[x + (y / 8) * WIDTH];
+    uint8_t bit = 1 << (y & 7);
+    switch (color) {
+        case SSD1306_WHITE:
+            b |= bit;
+            break;
+        case SSD1306_BLACK:
+            b &= ~bit;
+            break;
+        case SSD1306_INVERSE:
+            b ^= bit;
+            break;
+    }
+}
+
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) return false;
+    return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+    wire->setClock(wireClk);
+    ssd1306_command1(c);
+    wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::ssd1306_command1(uint8_t c) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00);
+    wire->write(c);
+    wire->endTransmission();
+}
+
+void Adafruit_SSD1306::ssd1306_commandList(const uint8_t* c, uint8_t n) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00);
+    uint16_t bytesOut = 1;
+    while (n--) {
+        if (bytesOut >= I2C_BUFFER_LENGTH) {
+            wire->endTransmission();
+            wire->beginTransmission(i2caddr);
+            wire->write((uint8_t)0x00);
+            bytesOut = 1;
+        }
+        wire->write(*c++);
+        bytesOut++;
+    }
+    wire->endTransmission();
+}
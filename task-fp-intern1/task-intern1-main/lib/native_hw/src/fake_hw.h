@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Kontrol perangkat keras palsu untuk build native: jam virtual,
+// level pin, nilai ADC, dan sensor. Dipakai oleh benchmark dan test.
+namespace fakeHw {
+
+// Jam virtual dalam mikrodetik. Semua millis()/micros() membaca jam ini.
+uint64_t nowUs();
+void setNowUs(uint64_t us);
+// Majukan jam; timer dan interupsi yang jatuh tempo ikut dijalankan
+void advanceUs(uint64_t us);
+// Biaya waktu operasi hardware (I2C, DHT, ADC) dimodelkan dengan menambah jam
+void spendUs(uint64_t us);
+
+// Pin digital: level input yang dibaca digitalRead(), memicu ISR jika terpasang
+void setPin(uint8_t pin, int level);
+// Level pin berganti saat jam mencapai atUs, juga di tengah light sleep
+void setPinAt(uint64_t atUs, uint8_t pin, int level);
+int pinOutput(uint8_t pin);
+uint32_t pinWriteCount(uint8_t pin);
+void setAnalog(uint8_t pin, uint16_t value);
+
+// Sensor DHT22 palsu
+void setDht(float temperature, float humidity);
+void setDhtFailing(bool failing);
+uint32_t dhtReadCount();
+
+// Serial palsu
+void serialInput(const uint8_t* data, size_t length);
+size_t serialOutput(uint8_t* data, size_t capacity);  // Ambil dan kosongkan buffer TX
+void serialEcho(bool enabled);                        // Teruskan output ke stdout
+
+// Light sleep (esp_light_sleep_start)
+struct SleepStats {
+    uint32_t sleeps;
+    uint64_t sleepUs;
+    uint32_t gpioWakes;
+};
+SleepStats lightSleepStats();
+
+// Alasan reset yang dilaporkan esp_reset_reason() (esp_reset_reason_t) untuk setup() berikutnya
+void setResetReason(int reason);
+
+// Statistik bus I2C
+struct I2CStats {
+    uint32_t transactions;
+    uint32_t bytesWritten;
+    uint32_t bytesRead;
+    uint64_t busyUs;
+    uint32_t longestUs;  // Transaksi terlama (bus dipegang satu START..STOP)
+};
+I2CStats i2cStats();
+void resetI2CStats();
+// Clock bus pada transaksi terakhir ke alamat ini, 0 jika belum pernah
+uint32_t i2cClock(uint8_t address);
+// count transaksi berikutnya ke alamat ini gagal dengan kode endTransmission()
+// (2 NACK alamat, 5 timeout)
+void failI2C(uint8_t address, uint8_t error, uint32_t count);
+
+// Panel SSD1306 palsu di 0x3C: isi GDDRAM hasil transfer I2C
+const uint8_t* panelRam();
+bool panelOn();
+uint8_t panelContrast();
+
+// DS1307 palsu di 0x68
+void setRtc(uint32_t unixtime);
+void setRtcPresent(bool present);
+
+// Isi NVS (Preferences) bertahan melewati reset(), seperti flash sungguhan
+void clearNvs();
+
+// Partisi flash "history" (esp_partition), juga bertahan melewati reset()
+struct FlashStats {
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t erases;  // Sektor 4 KB
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+};
+FlashStats flashStats();
+void resetFlashStats();
+void clearFlash();
+// Simulasi listrik padam: setelah bytes byte berikutnya, tulis/erase tidak
+// lagi mengubah isi flash sampai reset()
+void cutFlashPowerAfter(size_t bytes);
+
+// Reset seluruh state hardware palsu ke kondisi awal
+void reset();
+
+}  // namespace fakeHw
+
+namespace fakeHw {
+namespace detail {
+
+// Dipakai antar file fake, bukan oleh kode firmware
+bool dhtRead(float& temperature, float& humidity);
+void resetDevices();
+void resetFlash();
+
+}  // namespace detail
+}  // namespace fakeHw
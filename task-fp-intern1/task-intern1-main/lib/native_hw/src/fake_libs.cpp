@@ -0,0 +1,235 @@
+#include <DHTesp.h>
+#include <ESP32Servo.h>
+#include <RTClib.h>
+
+#include "fake_hw.h"
+
+// ---- RTClib ----
+
+namespace {
+
+const uint8_t daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+uint16_t date2days(uint16_t y, uint8_t m, uint8_t d) {
+    if (y >= 2000U) y -= 2000U;
+    uint16_t days = d;
+    for (uint8_t i = 1; i < m; ++i) days += daysInMonth[i - 1];
+    if (m > 2 && y % 4 == 0) ++days;
+    return days + 365 * y + (y + 3) / 4 - 1;
+}
+
+uint8_t conv2d(const char* p) {
+    uint8_t v = 0;
+    if ('0' <= *p && *p <= '9') v = *p - '0';
+    return 10 * v + *++p - '0';
+}
+
+uint8_t bcd2bin(uint8_t val) { return val - 6 * (val >> 4); }
+uint8_t bin2bcd(uint8_t val) { return val + 6 * (val / 10); }
+
+const uint8_t DS1307_ADDRESS = 0x68;
+
+}  // namespace
+
+DateTime::DateTime(uint32_t t) {
+    t -= SECONDS_FROM_1970_TO_2000;
+    ss = t % 60;
+    t /= 60;
+    mm = t % 60;
+    t /= 60;
+    hh = t % 24;
+    uint16_t days = t / 24;
+    uint8_t leap;
+    for (yOff = 0;; ++yOff) {
+        leap = yOff % 4 == 0;
+        if (days < 365U + leap) break;
+        days -= 365 + leap;
+    }
+    for (m = 1; m < 12; ++m) {
+        uint8_t dim = daysInMonth[m - 1];
+        if (leap && m == 2) ++dim;
+        if (days < dim) break;
+        days -= dim;
+    }
+    d = days + 1;
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec) {
+    if (year >= 2000U) year -= 2000U;
+    yOff = year;
+    m = month;
+    d = day;
+    hh = hour;
+    mm = min;
+    ss = sec;
+}
+
+DateTime::DateTime(const char* date, const char* time) {
+    yOff = conv2d(date + 9);
+    switch (date[0]) {
+        case 'J':
+            m = (date[1] == 'a') ? 1 : ((date[2] == 'n') ? 6 : 7);
+            break;
+        case 'F':
+            m = 2;
+            break;
+        case 'A':
+            m = date[2] == 'r' ? 4 : 8;
+            break;
+        case 'M':
+            m = date[2] == 'r' ? 3 : 5;
+            break;
+        case 'S':
+            m = 9;
+            break;
+        case 'O':
+            m = 10;
+            break;
+        case 'N':
+            m = 11;
+            break;
+        default:
+            m = 12;
+            break;
+    }
+    d = conv2d(date + 4);
+    hh = conv2d(time);
+    mm = conv2d(time + 3);
+    ss = conv2d(time + 6);
+}
+
+uint8_t DateTime::dayOfTheWeek() const {
+    uint16_t day = date2days(yOff, m, d);
+    return (day + 6) % 7;
+}
+
+uint32_t DateTime::secondstime() const {
+    uint16_t days = date2days(yOff, m, d);
+    return ((days * 24UL + hh) * 60 + mm) * 60 + ss;
+}
+
+uint32_t DateTime::unixtime() const { return secondstime() + SECONDS_FROM_1970_TO_2000; }
+
+bool DateTime::isValid() const {
+    if (yOff >= 100) return false;
+    DateTime other(unixtime());
+    return yOff == other.yOff && m == other.m && d == other.d && hh == other.hh && mm == other.mm &&
+           ss == other.ss;
+}
+
+DateTime DateTime::operator+(const TimeSpan& span) const { return DateTime(unixtime() + span.totalseconds()); }
+DateTime DateTime::operator-(const TimeSpan& span) const { return DateTime(unixtime() - span.totalseconds()); }
+TimeSpan DateTime::operator-(const DateTime& right) const {
+    return TimeSpan((int32_t)(unixtime() - right.unixtime()));
+}
+
+bool RTC_DS1307::begin(TwoWire* wireInstance) {
+    wire_ = wireInstance;
+    wire_->begin();
+    wire_->beginTransmission(DS1307_ADDRESS);
+    return wire_->endTransmission() == 0;
+}
+
+uint8_t RTC_DS1307::isrunning() {
+    wire_->beginTransmission(DS1307_ADDRESS);
+    wire_->write((uint8_t)0);
+    wire_->endTransmission();
+    wire_->requestFrom(DS1307_ADDRESS, (uint8_t)1);
+    return !(wire_->read() >> 7);
+}
+
+void RTC_DS1307::adjust(const DateTime& dt) {
+    wire_->beginTransmission(DS1307_ADDRESS);
+    wire_->write((uint8_t)0);
+    wire_->write(bin2bcd(dt.second()));
+    wire_->write(bin2bcd(dt.minute()));
+    wire_->write(bin2bcd(dt.hour()));
+    wire_->write(bin2bcd(0));
+    wire_->write(bin2bcd(dt.day()));
+    wire_->write(bin2bcd(dt.month()));
+    wire_->write(bin2bcd(dt.year() - 2000U));
+    wire_->endTransmission();
+}
+
+DateTime RTC_DS1307::now() {
+    wire_->beginTransmission(DS1307_ADDRESS);
+    wire_->write((uint8_t)0);
+    wire_->endTransmission();
+    wire_->requestFrom(DS1307_ADDRESS, (uint8_t)7);
+    uint8_t buffer[7];
+    for (int i = 0; i < 7; i++) buffer[i] = (uint8_t)wire_->read();
+    return DateTime(bcd2bin(buffer[6]) + 2000U, bcd2bin(buffer[5]), bcd2bin(buffer[4]), bcd2bin(buffer[2]),
+                    bcd2bin(buffer[1]), bcd2bin(buffer[0] & 0x7F));
+}
+
+Ds1307SqwPinMode RTC_DS1307::readSqwPinMode() {
+    wire_->beginTransmission(DS1307_ADDRESS);
+    wire_->write((uint8_t)0x07);
+    wire_->endTransmission();
+    wire_->requestFrom(DS1307_ADDRESS, (uint8_t)1);
+    return (Ds1307SqwPinMode)(wire_->read() & 0x93);
+}
+
+void RTC_DS1307::writeSqwPinMode(Ds1307SqwPinMode mode) {
+    wire_->beginTransmission(DS1307_ADDRESS);
+    wire_->write((uint8_t)0x07);
+    wire_->write((uint8_t)mode);
+    wire_->endTransmission();
+}
+
+// ---- DHTesp ----
+
+TempAndHumidity DHTesp::getTempAndHumidity() {
+    TempAndHumidity result;
+    fakeHw::spendUs(5000);  // Protokol bit-bang DHT22 kira-kira 5 ms dengan interupsi mati
+    if (fakeHw::detail::dhtRead(result.temperature, result.humidity)) {
+        error_ = ERROR_NONE;
+    } else {
+        error_ = ERROR_TIMEOUT;
+        result.temperature = NAN;
+        result.humidity = NAN;
+    }
+    return result;
+}
+
+// ---- Servo ----
+
+int Servo::attach(int pin, int min, int max) {
+    pin_ = pin;
+    min_ = min;
+    max_ = max;
+    return 1;
+}
+
+void Servo::write(int value) {
+    if (value < 200) {
+        value = constrain(value, 0, 180);
+        value = map(value, 0, 180, min_, max_);
+    }
+    writeMicroseconds(value);
+}
+
+void Servo::writeMicroseconds(int value) {
+    us_ = constrain(value, min_, max_);
+    writes_++;
+}
+
+int Servo::read() const { return map(us_ + 1, min_, max_, 0, 180); }
+
+// ---- Preferences (NVS) ----
+#include <Preferences.h>
+
+uint32_t Preferences::writes_ = 0;
+
+namespace fakeHw {
+namespace detail {
+std::map<std::string, std::vector<uint8_t>>& nvsStore() {
+    static std::map<std::string, std::vector<uint8_t>> store;
+    return store;
+}
+}  // namespace detail
+}  // namespace fakeHw
+
+namespace fakeHw {
+void clearNvs() { detail::nvsStore().clear(); }
+}  // namespace fakeHw
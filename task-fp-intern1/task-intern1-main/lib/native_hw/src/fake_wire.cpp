@@ -0,0 +1,285 @@
+#include <RTClib.h>
+#include <Wire.h>
+
+#include "fake_hw.h"
+
+TwoWire Wire;
+
+namespace {
+
+const uint8_t PANEL_ADDRESS = 0x3C;
+const uint8_t RTC_ADDRESS = 0x68;
+
+// Model panel SSD1306: GDDRAM 8 page x 128 kolom, mode alamat horizontal
+struct Panel {
+    uint8_t ram[8 * 128];
+    uint8_t colStart, colEnd, pageStart, pageEnd;
+    uint8_t col, page;
+    bool on;
+    uint8_t contrast;
+    uint8_t pendingCommand;
+    uint8_t pendingArgs;
+    uint8_t argIndex;
+    uint8_t args[2];
+};
+
+// Model DS1307: waktu = baseUnix + (jam virtual - baseUs)
+struct Ds1307 {
+    bool present;
+    bool halted;
+    uint32_t baseUnix;
+    uint64_t baseUs;
+    uint8_t pointer;
+    uint8_t control;
+    uint8_t ram[56];
+};
+
+Panel panel;
+Ds1307 ds1307;
+fakeHw::I2CStats stats;
+uint32_t lastClock[128];
+uint8_t failAddress;
+uint8_t failError;
+uint32_t failCount;
+
+uint8_t toBcd(uint8_t v) { return ((v / 10) << 4) | (v % 10); }
+uint8_t fromBcd(uint8_t v) { return (v >> 4) * 10 + (v & 0x0F); }
+
+uint32_t rtcUnix() {
+    if (ds1307.halted) return ds1307.baseUnix;
+    return ds1307.baseUnix + (uint32_t)((fakeHw::nowUs() - ds1307.baseUs) / 1000000ULL);
+}
+
+void panelCommand(uint8_t c) {
+    if (panel.pendingArgs > 0) {
+        panel.args[panel.argIndex++] = c;
+        if (--panel.pendingArgs > 0) return;
+        switch (panel.pendingCommand) {
+            case 0x21:
+                panel.colStart = panel.args[0] & 0x7F;
+                panel.colEnd = panel.args[1] & 0x7F;
+                panel.col = panel.colStart;
+                break;
+            case 0x22:
+                panel.pageStart = panel.args[0] & 0x07;
+                panel.pageEnd = panel.args[1] & 0x07;
+                panel.page = panel.pageStart;
+                break;
+            case 0x81:
+                panel.contrast = panel.args[0];
+                break;
+        }
+        return;
+    }
+    switch (c) {
+        case 0x21:
+        case 0x22:
+            panel.pendingCommand = c;
+            panel.pendingArgs = 2;
+            panel.argIndex = 0;
+            break;
+        case 0x20:
+        case 0x81:
+        case 0x8D:
+        case 0xA8:
+        case 0xD3:
+        case 0xD5:
+        case 0xD9:
+        case 0xDA:
+        case 0xDB:
+            panel.pendingCommand = c;
+            panel.pendingArgs = 1;
+            panel.argIndex = 0;
+            break;
+        case 0xAE:
+            panel.on = false;
+            break;
+        case 0xAF:
+            panel.on = true;
+            break;
+    }
+}
+
+void panelData(uint8_t d) {
+    panel.ram[panel.page * 128 + panel.col] = d;
+    if (panel.col >= panel.colEnd) {
+        panel.col = panel.colStart;
+        panel.page = panel.page >= panel.pageEnd ? panel.pageStart : panel.page + 1;
+    } else {
+        panel.col++;
+    }
+}
+
+bool deviceWrite(uint8_t address, const uint8_t* data, size_t length) {
+    if (address == PANEL_ADDRESS) {
+        if (length == 0) return true;
+        bool isData = (data[0] & 0x40) != 0;
+        for (size_t i = 1; i < length; i++) {
+            if (isData) {
+                panelData(data[i]);
+            } else {
+                panelCommand(data[i]);
+            }
+        }
+        return true;
+    }
+    if (address == RTC_ADDRESS && ds1307.present) {
+        if (length == 0) return true;
+        ds1307.pointer = data[0];
+        if (length >= 8 && data[0] == 0) {
+            DateTime dt(2000 + fromBcd(data[7]), fromBcd(data[6] & 0x1F), fromBcd(data[5] & 0x3F),
+                        fromBcd(data[3] & 0x3F), fromBcd(data[2] & 0x7F), fromBcd(data[1] & 0x7F));
+            ds1307.baseUnix = dt.unixtime();
+            ds1307.baseUs = fakeHw::nowUs();
+            ds1307.halted = (data[1] & 0x80) != 0;
+        } else if (length >= 2 && data[0] == 0x07) {
+            ds1307.control = data[1];
+        }
+        return true;
+    }
+    return false;
+}
+
+size_t deviceRead(uint8_t address, uint8_t* data, size_t length) {
+    if (address != RTC_ADDRESS || !ds1307.present) return 0;
+    DateTime now(rtcUnix());
+    uint8_t regs[64];
+    regs[0] = toBcd(now.second()) | (ds1307.halted ? 0x80 : 0);
+    regs[1] = toBcd(now.minute());
+    regs[2] = toBcd(now.hour());
+    regs[3] = now.dayOfTheWeek() + 1;
+    regs[4] = toBcd(now.day());
+    regs[5] = toBcd(now.month());
+    regs[6] = toBcd(now.year() - 2000);
+    regs[7] = ds1307.control;
+    memcpy(regs + 8, ds1307.ram, sizeof(ds1307.ram));
+    for (size_t i = 0; i < length; i++) {
+        data[i] = regs[(ds1307.pointer + i) % 64];
+    }
+    ds1307.pointer = (ds1307.pointer + length) % 64;
+    return length;
+}
+
+void chargeBus(size_t bytes, uint32_t clock) {
+    // Start + alamat + data (9 bit per byte) + stop
+    uint64_t bits = 9 * (bytes + 1) + 2;
+    uint64_t us = (bits * 1000000ULL + clock - 1) / clock;
+    stats.transactions++;
+    stats.busyUs += us;
+    if (us > stats.longestUs) stats.longestUs = (uint32_t)us;
+    fakeHw::spendUs(us);
+}
+
+// Kode error tersisa untuk alamat ini, 0 jika transaksi berjalan normal
+uint8_t takeFailure(uint8_t address) {
+    if (failCount == 0 || address != failAddress) return 0;
+    failCount--;
+    return failError;
+}
+
+}  // namespace
+
+namespace fakeHw {
+
+I2CStats i2cStats() { return stats; }
+void resetI2CStats() { stats = I2CStats{0, 0, 0, 0, 0}; }
+
+uint32_t i2cClock(uint8_t address) { return lastClock[address & 0x7F]; }
+
+void failI2C(uint8_t address, uint8_t error, uint32_t count) {
+    failAddress = address;
+    failError = error;
+    failCount = count;
+}
+
+const uint8_t* panelRam() { return panel.ram; }
+bool panelOn() { return panel.on; }
+uint8_t panelContrast() { return panel.contrast; }
+
+void setRtc(uint32_t unixtime) {
+    ds1307.baseUnix = unixtime;
+    ds1307.baseUs = nowUs();
+    ds1307.halted = false;
+}
+
+void setRtcPresent(bool present) { ds1307.present = present; }
+
+void detail::resetDevices() {
+    memset(&panel, 0, sizeof(panel));
+    panel.colEnd = 127;
+    panel.pageEnd = 7;
+    panel.contrast = 0xCF;
+    memset(&ds1307, 0, sizeof(ds1307));
+    ds1307.present = true;
+    ds1307.baseUnix = DateTime(2024, 1, 1, 12, 0, 0).unixtime();
+    memset(lastClock, 0, sizeof(lastClock));
+    failCount = 0;
+    resetI2CStats();
+}
+
+}  // namespace fakeHw
+
+bool TwoWire::begin() { return true; }
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    if (frequency) clock_ = frequency;
+    return true;
+}
+bool TwoWire::end() { return true; }
+bool TwoWire::setClock(uint32_t frequency) {
+    clock_ = frequency;
+    return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    address_ = address;
+    txLength_ = 0;
+    txOverflow_ = false;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    if (txOverflow_) return 1;
+    chargeBus(txLength_, clock_);
+    lastClock[address_ & 0x7F] = clock_;
+    uint8_t error = takeFailure(address_);
+    if (error != 0) return error;
+    stats.bytesWritten += txLength_;
+    return deviceWrite(address_, txBuffer_, txLength_) ? 0 : 2;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+    (void)sendStop;
+    if (quantity > I2C_BUFFER_LENGTH) quantity = I2C_BUFFER_LENGTH;
+    chargeBus(quantity, clock_);
+    lastClock[address & 0x7F] = clock_;
+    if (takeFailure(address) != 0) {
+        rxLength_ = rxIndex_ = 0;
+        return 0;
+    }
+    rxLength_ = deviceRead(address, rxBuffer_, quantity);
+    rxIndex_ = 0;
+    stats.bytesRead += rxLength_;
+    return (uint8_t)rxLength_;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (txLength_ >= I2C_BUFFER_LENGTH) {
+        txOverflow_ = true;
+        return 0;
+    }
+    txBuffer_[txLength_++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+    for (size_t i = 0; i < quantity; i++) {
+        if (!write(data[i])) return i;
+    }
+    return quantity;
+}
+
+int TwoWire::available() { return (int)(rxLength_ - rxIndex_); }
+int TwoWire::read() { return rxIndex_ < rxLength_ ? rxBuffer_[rxIndex_++] : -1; }
+int TwoWire::peek() { return rxIndex_ < rxLength_ ? rxBuffer_[rxIndex_] : -1; }
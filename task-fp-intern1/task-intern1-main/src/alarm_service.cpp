@@ -0,0 +1,197 @@
+#include "alarm_service.h"
+
+#include "alloc_guard.h"
+#include "fixed_print.h"
+
+AlarmService alarmService;
+
+static const uint8_t ALARM_NVS_VERSION = 1;
+
+void AlarmService::begin(uint32_t now) {
+    prefs_.begin("alarms", false);
+    if (prefs_.getUChar("ver", 0) == ALARM_NVS_VERSION && prefs_.getBytesLength("list") == sizeof(alarms_)) {
+        prefs_.getBytes("list", alarms_, sizeof(alarms_));
+    }
+    reschedule(now);
+}
+
+void AlarmService::tick(uint32_t now) {
+    if (ringing_ >= 0) {
+        if (now - ringingSince_ < ALARM_RING_TIMEOUT_S) {
+            return;  // Alarm berikutnya menunggu sampai yang ini selesai
+        }
+        stats_.timedOut++;
+        ringing_ = -1;
+    }
+
+    // Cukup lihat puncak heap; biasanya belum jatuh tempo dan langsung keluar
+    while (heapSize_ > 0 && heap_[0].fireAt <= now) {
+        Entry entry = heap_[0];
+        pop();
+
+        AlarmSpec& spec = alarms_[entry.slot];
+        if (!entry.snooze) {
+            if (spec.days == ALARM_DAYS_ONCE) {
+                spec.enabled = 0;  // Alarm sekali selesai setelah berbunyi
+                save();
+            } else {
+                schedule(entry.slot, now > entry.fireAt ? now : entry.fireAt);
+            }
+        }
+
+        if (now - entry.fireAt > ALARM_MISS_S) {
+            stats_.missed++;
+            continue;
+        }
+
+        ringing_ = entry.slot;
+        ringingSince_ = now;
+        stats_.fired++;
+        if (onRing_) {
+            onRing_(entry.slot);
+        }
+        return;
+    }
+}
+
+bool AlarmService::set(int slot, const AlarmSpec& spec, uint32_t now) {
+    if (slot < 0 || slot >= ALARM_MAX || spec.hour > 23 || spec.minute > 59 || spec.days > ALARM_DAYS_DAILY) {
+        return false;
+    }
+    AlarmSpec& target = alarms_[slot];
+    target = spec;
+    if (target.days == ALARM_DAYS_ONCE && target.onceAt == 0) {
+        AlarmSpec daily = target;
+        daily.days = ALARM_DAYS_DAILY;
+        target.onceAt = nextOccurrence(daily, now);
+    }
+    save();
+
+    // Buang jadwal lama slot ini (termasuk snooze), lalu susun ulang heap
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < heapSize_; i++) {
+        if (heap_[i].slot != slot) {
+            heap_[kept++] = heap_[i];
+        }
+    }
+    heapSize_ = 0;
+    for (uint8_t i = 0; i < kept; i++) {
+        Entry entry = heap_[i];  // push() hanya menulis indeks <= i
+        push(entry);
+    }
+    schedule(slot, now);
+    return true;
+}
+
+void AlarmService::clear(int slot, uint32_t now) {
+    AlarmSpec empty = {};
+    set(slot, empty, now);
+}
+
+void AlarmService::reschedule(uint32_t now) {
+    heapSize_ = 0;
+    bool expired = false;
+    for (int slot = 0; slot < ALARM_MAX; slot++) {
+        AlarmSpec& spec = alarms_[slot];
+        // Waktu alarm sekali lewat saat mati/reset: tidak akan dijadwalkan lagi, jadi matikan
+        if (spec.enabled && spec.days == ALARM_DAYS_ONCE && spec.onceAt <= now) {
+            spec.enabled = 0;
+            stats_.missed++;
+            expired = true;
+            continue;
+        }
+        schedule(slot, now);
+    }
+    if (expired) {
+        save();
+    }
+}
+
+void AlarmService::snooze(uint32_t now) {
+    if (ringing_ < 0) return;
+    Entry entry = {now + ALARM_SNOOZE_S, (uint8_t)ringing_, true};
+    push(entry);
+    ringing_ = -1;
+    stats_.snoozed++;
+}
+
+void AlarmService::dismiss() {
+    if (ringing_ < 0) return;
+    ringing_ = -1;
+    stats_.dismissed++;
+}
+
+uint32_t AlarmService::nextOccurrence(const AlarmSpec& spec, uint32_t after) {
+    if (!spec.enabled) {
+        return 0;
+    }
+    if (spec.days == ALARM_DAYS_ONCE) {
+        return spec.onceAt > after ? spec.onceAt : 0;
+    }
+    DateTime t(after);
+    uint32_t base = DateTime(t.year(), t.month(), t.day(), spec.hour, spec.minute, 0).unixtime();
+    uint8_t dow = t.dayOfTheWeek();
+    // Hari ini sampai 7 hari ke depan (hari yang sama minggu depan)
+    for (uint8_t i = 0; i <= 7; i++) {
+        uint32_t candidate = base + i * 86400UL;
+        if ((spec.days & (1 << ((dow + i) % 7))) && candidate > after) {
+            return candidate;
+        }
+    }
+    return 0;
+}
+
+void AlarmService::schedule(int slot, uint32_t after) {
+    uint32_t fireAt = nextOccurrence(alarms_[slot], after);
+    if (fireAt != 0) {
+        Entry entry = {fireAt, (uint8_t)slot, false};
+        push(entry);
+    }
+}
+
+void AlarmService::push(const Entry& entry) {
+    if (heapSize_ >= ALARM_MAX * 2) return;
+    uint8_t i = heapSize_++;
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (heap_[parent].fireAt <= entry.fireAt) break;
+        heap_[i] = heap_[parent];
+        i = parent;
+    }
+    heap_[i] = entry;
+}
+
+void AlarmService::pop() {
+    if (heapSize_ == 0) return;
+    Entry last = heap_[--heapSize_];
+    uint8_t i = 0;
+    while (true) {
+        uint8_t child = i * 2 + 1;
+        if (child >= heapSize_) break;
+        if (child + 1 < heapSize_ && heap_[child + 1].fireAt < heap_[child].fireAt) child++;
+        if (last.fireAt <= heap_[child].fireAt) break;
+        heap_[i] = heap_[child];
+        i = child;
+    }
+    heap_[i] = last;
+}
+
+// Hanya ditulis saat alarm diubah atau alarm sekali selesai, bukan tiap tick
+void AlarmService::save() {
+    AllocGuard::Allow allow;  // Driver NVS memakai heap; hanya saat event, bukan per frame
+    prefs_.putBytes("list", alarms_, sizeof(alarms_));
+    prefs_.putUChar("ver", ALARM_NVS_VERSION);
+    stats_.saves++;
+}
+
+void AlarmService::report(Print& out) const {
+    fixedPrintf(out, "alarm: %u scheduled, next %lu, fired %lu, snoozed %lu, dismissed %lu, "
+                "timeout %lu, missed %lu, saves %lu\n",
+                heapSize_, (unsigned long)nextFireTime(), (unsigned long)stats_.fired, (unsigned long)stats_.snoozed,
+                (unsigned long)stats_.dismissed, (unsigned long)stats_.timedOut, (unsigned long)stats_.missed,
+                (unsigned long)stats_.saves);
+}
+
+void AlarmService::resetStats() {
+    stats_ = {};
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <RTClib.h>
+
+// Mesin alarm: banyak alarm (sekali, harian, atau per hari dalam seminggu),
+// disimpan di NVS supaya bertahan setelah reset. Waktu bunyi berikutnya
+// disimpan di min-heap, jadi tick() cukup melihat puncak heap (O(1)) dan
+// alarm berbunyi di mode apa pun, bukan hanya saat layar alarm terbuka.
+
+#define ALARM_MAX 8
+#define ALARM_SNOOZE_S 300        // Tunda 5 menit
+#define ALARM_RING_TIMEOUT_S 60   // Tanpa respons, alarm berhenti sendiri
+#define ALARM_MISS_S 300          // Lebih telat dari ini (mis. jam loncat) dianggap terlewat
+
+// Bit hari mengikuti DateTime::dayOfTheWeek(): bit 0 = Minggu ... bit 6 = Sabtu
+#define ALARM_DAYS_ONCE 0x00
+#define ALARM_DAYS_DAILY 0x7F
+#define ALARM_DAYS_WEEKDAYS 0x3E
+#define ALARM_DAYS_WEEKEND 0x41
+
+struct AlarmSpec {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t days;      // Mask hari, 0 = sekali (pakai onceAt)
+    uint8_t enabled;
+    uint32_t onceAt;   // Unixtime untuk alarm sekali
+};
+
+struct AlarmStats {
+    uint32_t fired;
+    uint32_t snoozed;
+    uint32_t dismissed;
+    uint32_t timedOut;
+    uint32_t missed;
+    uint32_t saves;
+};
+
+typedef void (*AlarmCallback)(int slot);
+
+class AlarmService {
+public:
+    // Muat alarm dari NVS dan susun heap relatif terhadap waktu sekarang
+    void begin(uint32_t now);
+    // Dipanggil periodik; membunyikan alarm yang jatuh tempo
+    void tick(uint32_t now);
+
+    const AlarmSpec& get(int slot) const { return alarms_[slot]; }
+    // Simpan alarm ke slot (langsung ditulis ke NVS). Untuk alarm sekali,
+    // onceAt diisi otomatis dengan kemunculan hour:minute berikutnya jika 0.
+    bool set(int slot, const AlarmSpec& spec, uint32_t now);
+    void clear(int slot, uint32_t now);
+    // Hitung ulang semua jadwal, mis. setelah jam diubah. Alarm sekali yang
+    // waktunya sudah lewat dimatikan dan dihitung terlewat.
+    void reschedule(uint32_t now);
+
+    bool isRinging() const { return ringing_ >= 0; }
+    int ringingSlot() const { return ringing_; }
+    void snooze(uint32_t now);
+    void dismiss();
+    // Dipanggil saat alarm mulai berbunyi
+    void onRing(AlarmCallback callback) { onRing_ = callback; }
+
+    // Waktu bunyi terdekat (unixtime), 0 jika tidak ada; untuk perencanaan idle
+    uint32_t nextFireTime() const { return heapSize_ ? heap_[0].fireAt : 0; }
+
+    // Kemunculan berikutnya setelah `after`, 0 jika tidak ada lagi
+    static uint32_t nextOccurrence(const AlarmSpec& spec, uint32_t after);
+
+    const AlarmStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    struct Entry {
+        uint32_t fireAt;
+        uint8_t slot;
+        bool snooze;
+    };
+
+    void push(const Entry& entry);
+    void pop();
+    void schedule(int slot, uint32_t after);
+    void save();
+
+    AlarmSpec alarms_[ALARM_MAX] = {};
+    // Satu jadwal normal + satu snooze per slot
+    Entry heap_[ALARM_MAX * 2];
+    uint8_t heapSize_ = 0;
+
+    int ringing_ = -1;
+    uint32_t ringingSince_ = 0;
+    AlarmCallback onRing_ = nullptr;
+
+    Preferences prefs_;
+    AlarmStats stats_ = {};
+};
+
+extern AlarmService alarmService;
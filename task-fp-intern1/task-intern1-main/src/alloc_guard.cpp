@@ -0,0 +1,136 @@
+#include "alloc_guard.h"
+
+#include <new>
+
+#include "fixed_print.h"
+
+AllocGuard allocGuard;
+
+AllocGuard::Allow::Allow() {
+    allocGuard.allowDepth_++;
+}
+
+AllocGuard::Allow::~Allow() {
+    allocGuard.allowDepth_--;
+}
+
+void AllocGuard::record(size_t size, void* caller) {
+    AllocGuardMode mode = mode_.load(std::memory_order_relaxed);
+    if (mode == ALLOC_GUARD_OFF) {
+        return;
+    }
+    if (allowDepth_.load(std::memory_order_relaxed) > 0) {
+        allowed_++;
+        return;
+    }
+    allocations_++;
+    bytes_ += size;
+    lastSize_ = size;
+    lastCaller_ = (uintptr_t)caller;
+    if (mode == ALLOC_GUARD_TRAP) {
+        abort();  // Backtrace panic handler menunjuk ke pemanggil alokasi
+    }
+}
+
+AllocStats AllocGuard::stats() const {
+    AllocStats s;
+    s.allocations = allocations_;
+    s.bytes = bytes_;
+    s.allowed = allowed_;
+    s.lastSize = lastSize_;
+    s.lastCaller = lastCaller_;
+    return s;
+}
+
+HeapStats AllocGuard::heap() {
+    HeapStats h;
+    h.freeHeap = ESP.getFreeHeap();
+    h.minFreeHeap = ESP.getMinFreeHeap();
+    h.largestFreeBlock = ESP.getMaxAllocHeap();
+    return h;
+}
+
+void AllocGuard::report(Print& out) const {
+    HeapStats h = heap();
+    AllocStats s = stats();
+    fixedPrintf(out, "heap: free %lu B, min %lu B, largest block %lu B\n", (unsigned long)h.freeHeap,
+                (unsigned long)h.minFreeHeap, (unsigned long)h.largestFreeBlock);
+    fixedPrintf(out, "alloc: %lu after setup (%lu B), last %lu B from 0x%08lx, %lu allowed\n",
+                (unsigned long)s.allocations, (unsigned long)s.bytes, (unsigned long)s.lastSize,
+                (unsigned long)s.lastCaller, (unsigned long)s.allowed);
+}
+
+void AllocGuard::resetStats() {
+    allocations_ = 0;
+    bytes_ = 0;
+    allowed_ = 0;
+    lastSize_ = 0;
+    lastCaller_ = 0;
+}
+
+// ---- Hook ----
+
+#if ALLOC_GUARD_WRAP
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocGuard.record(size, __builtin_return_address(0));
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocGuard.record(count * size, __builtin_return_address(0));
+    return __real_calloc(count, size);
+}
+
+// realloc(ptr, 0) adalah free, bukan alokasi
+void* __wrap_realloc(void* ptr, size_t size) {
+    if (size > 0) {
+        allocGuard.record(size, __builtin_return_address(0));
+    }
+    return __real_realloc(ptr, size);
+}
+}
+#define ALLOC_GUARD_RAW_MALLOC __real_malloc
+#else
+#define ALLOC_GUARD_RAW_MALLOC malloc
+#endif
+
+// operator new bawaan memanggil malloc dari dalam libstdc++; diganti supaya
+// alamat pemanggil yang tercatat adalah kode firmware, bukan libstdc++
+void* operator new(size_t size) {
+    allocGuard.record(size, __builtin_return_address(0));
+    void* ptr = ALLOC_GUARD_RAW_MALLOC(size ? size : 1);
+    if (ptr == nullptr) {
+        abort();  // Build tanpa exception: tidak ada std::bad_alloc
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    allocGuard.record(size, __builtin_return_address(0));
+    void* ptr = ALLOC_GUARD_RAW_MALLOC(size ? size : 1);
+    if (ptr == nullptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+// Penjaga alokasi heap setelah setup().
+// Firmware ini tidak boleh memakai heap di loop: semua objek statis dan
+// string memakai buffer berukuran tetap, jadi heap tidak terfragmentasi
+// setelah berminggu-minggu menyala. malloc/calloc/realloc dibungkus lewat
+// linker (-Wl,--wrap=..., lihat platformio.ini) dan operator new diganti di
+// alloc_guard.cpp; setelah arm() setiap alokasi dihitung (REPORT) atau
+// langsung abort() dengan backtrace ke pemanggilnya (TRAP).
+// Alokasi yang memang berasal dari event (tulis NVS) dibungkus
+// AllocGuard::Allow dan dihitung terpisah.
+
+#ifndef ALLOC_GUARD_WRAP
+#define ALLOC_GUARD_WRAP 0  // 1 jika build memakai -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+#endif
+
+#ifndef ALLOC_GUARD_MODE
+#define ALLOC_GUARD_MODE ALLOC_GUARD_REPORT
+#endif
+
+enum AllocGuardMode : uint8_t {
+    ALLOC_GUARD_OFF,
+    ALLOC_GUARD_REPORT,  // Hitung dan catat pemanggil terakhir
+    ALLOC_GUARD_TRAP,    // abort() pada alokasi pertama
+};
+
+struct AllocStats {
+    uint32_t allocations;  // Setelah arm(), di luar Allow
+    uint32_t bytes;
+    uint32_t allowed;      // Di dalam Allow
+    uint32_t lastSize;
+    uintptr_t lastCaller;  // Alamat return; addr2line -e firmware.elf
+};
+
+struct HeapStats {
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;       // Titik terendah sejak boot
+    uint32_t largestFreeBlock;  // Jauh di bawah freeHeap = heap terfragmentasi
+};
+
+class AllocGuard {
+public:
+    // Izinkan alokasi selama scope ini (event jarang, bukan jalur per frame)
+    class Allow {
+    public:
+        Allow();
+        ~Allow();
+    };
+
+    // Dipanggil di akhir setup(): alokasi berikutnya dihitung atau di-trap
+    void arm(AllocGuardMode mode) { mode_ = mode; }
+    void disarm() { mode_ = ALLOC_GUARD_OFF; }
+    AllocGuardMode mode() const { return mode_; }
+
+    // Dari hook malloc/new; tidak boleh mengalokasikan apa pun
+    void record(size_t size, void* caller);
+
+    AllocStats stats() const;
+    static HeapStats heap();
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    std::atomic<AllocGuardMode> mode_{ALLOC_GUARD_OFF};
+    std::atomic<int> allowDepth_{0};
+    std::atomic<uint32_t> allocations_{0};
+    std::atomic<uint32_t> bytes_{0};
+    std::atomic<uint32_t> allowed_{0};
+    std::atomic<uint32_t> lastSize_{0};
+    std::atomic<uintptr_t> lastCaller_{0};
+};
+
+extern AllocGuard allocGuard;
@@ -0,0 +1,23 @@
+#include "animation.h"
+
+namespace anim {
+
+void Transition::start(uint16_t durationMs) {
+    startMs_ = millis();
+    durationMs_ = durationMs > 0 ? durationMs : 1;
+    active_ = true;
+}
+
+uint8_t Transition::progress() {
+    if (!active_) {
+        return 255;
+    }
+    uint32_t elapsed = millis() - startMs_;
+    if (elapsed >= durationMs_) {
+        active_ = false;
+        return 255;
+    }
+    return easeInOut((uint8_t)(elapsed * 255 / durationMs_));
+}
+
+}  // namespace anim
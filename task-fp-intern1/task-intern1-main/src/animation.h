@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Mesin animasi: tabel sinus, easing dan sprite dihitung saat compile
+// (constexpr, tersimpan di flash), interpolasi fixed-point, dan transisi
+// berbasis timeline yang maju satu langkah per tick tanpa memblokir.
+
+namespace anim {
+
+// ---- Generator tabel saat compile ----
+
+constexpr double PI_D = 3.14159265358979323846;
+
+// Deret Taylor cukup akurat untuk |x| <= pi (error < 1e-9 dengan 12 suku)
+constexpr double sinTaylor(double x) {
+    while (x > PI_D) x -= 2 * PI_D;
+    while (x < -PI_D) x += 2 * PI_D;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr int16_t roundQ15(double v) { return (int16_t)(v >= 0 ? v * 32767 + 0.5 : v * 32767 - 0.5); }
+
+template <size_t N>
+struct SineTable {
+    int16_t value[N];
+    constexpr SineTable() : value() {
+        for (size_t i = 0; i < N; i++) {
+            value[i] = roundQ15(sinTaylor(2 * PI_D * i / N));
+        }
+    }
+};
+
+// Ease-in-out (smoothstep) 0..255 -> 0..255
+template <size_t N>
+struct EaseTable {
+    uint8_t value[N];
+    constexpr EaseTable() : value() {
+        for (size_t i = 0; i < N; i++) {
+            uint32_t t = i * 255 / (N - 1);
+            value[i] = (uint8_t)((t * t * (3 * 255 - 2 * t) + 255 * 255 / 2) / (255 * 255));
+        }
+    }
+};
+
+// Urutan pseudo-acak (LCG) dalam rentang [lo, hi], pengganti random() per frame
+template <size_t N>
+struct NoiseTable {
+    uint8_t value[N];
+    constexpr NoiseTable(uint8_t lo, uint8_t hi, uint32_t seed) : value() {
+        uint32_t state = seed;
+        for (size_t i = 0; i < N; i++) {
+            state = state * 1664525u + 1013904223u;
+            value[i] = (uint8_t)(lo + (state >> 24) % (hi - lo + 1));
+        }
+    }
+};
+
+constexpr size_t SINE_STEPS = 256;  // Satu periode penuh
+inline constexpr SineTable<SINE_STEPS> SINE{};
+inline constexpr EaseTable<256> EASE_IN_OUT{};
+inline constexpr NoiseTable<64> FLAME_HEIGHTS(3, 7, 0x5EED);  // Sama dengan random(3, 8)
+inline constexpr NoiseTable<64> STAR_X(0, 127, 0x57A1);
+inline constexpr NoiseTable<64> STAR_Y(0, 63, 0xC0DE);
+
+static_assert(SINE.value[0] == 0, "sin(0)");
+static_assert(SINE.value[SINE_STEPS / 4] == 32767, "sin(pi/2)");
+static_assert(EASE_IN_OUT.value[0] == 0 && EASE_IN_OUT.value[255] == 255, "easing");
+
+// ---- Fixed-point ----
+
+// sin dengan fase 0..255 per periode, hasil Q15
+inline int16_t sinQ15(uint8_t phase) { return SINE.value[phase]; }
+
+// a + (b - a) * t / 256, t dalam Q8 (0..256)
+inline int32_t lerpQ8(int32_t a, int32_t b, uint16_t t) { return a + (((b - a) * (int32_t)t) >> 8); }
+
+inline uint8_t easeInOut(uint8_t t) { return EASE_IN_OUT.value[t]; }
+
+// ---- Timeline ----
+
+// Transisi berbasis waktu: progress() dihitung dari waktu sejak start(),
+// jadi kecepatan animasi tidak tergantung frame rate. Bisa dibatalkan input.
+class Transition {
+public:
+    void start(uint16_t durationMs);
+    void cancel() { active_ = false; }
+    bool isActive() const { return active_; }
+    // Progress ter-easing 0..255; otomatis selesai saat durasi habis
+    uint8_t progress();
+
+private:
+    uint32_t startMs_ = 0;
+    uint16_t durationMs_ = 0;
+    bool active_ = false;
+};
+
+}  // namespace anim
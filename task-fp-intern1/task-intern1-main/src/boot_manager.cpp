@@ -0,0 +1,120 @@
+#include "boot_manager.h"
+
+#include <esp_system.h>
+
+#include "alloc_guard.h"
+#include "cobs.h"
+#include "fixed_print.h"
+
+BootManager bootManager;
+
+static const uint32_t BOOT_RECORD_MAGIC = 0x54534B42;  // "BKST"
+static const uint16_t BOOT_RECORD_VERSION = 1;
+
+// RTC slow memory, tidak di-nol-kan startup code
+static RTC_NOINIT_ATTR BootRecord rtcRecord;
+
+void BootManager::begin(Display& display) {
+    display_ = &display;
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (reason == ESP_RST_POWERON || reason == ESP_RST_UNKNOWN) {
+        kind_ = BOOT_COLD;
+    } else if (reason == ESP_RST_DEEPSLEEP) {
+        kind_ = BOOT_WAKE;
+    } else {
+        kind_ = BOOT_RESET;
+    }
+
+    source_ = BOOT_SOURCE_NONE;
+    if (kind_ != BOOT_COLD) {
+        if (valid(rtcRecord)) {
+            saved_ = rtcRecord;
+            source_ = BOOT_SOURCE_RTC;
+        } else {
+            stats_.rejected++;
+        }
+    }
+
+    prefs_.begin("boot", false);
+    size_t length = prefs_.getBytesLength("state");
+    if (length > 0) {
+        BootRecord nvs = {};
+        bool ok = length <= sizeof(nvs) && prefs_.getBytes("state", &nvs, length) == length && valid(nvs) &&
+                  length == recordLength(nvs);
+        if (!ok) {
+            stats_.rejected++;
+        } else if (source_ == BOOT_SOURCE_NONE || nvs.seq > saved_.seq) {
+            saved_ = nvs;  // Reset sebelum RTC sempat ditulis ulang, atau listrik padam
+            source_ = BOOT_SOURCE_NVS;
+        }
+    }
+}
+
+bool BootManager::restore(void* state, size_t size) {
+    if (source_ == BOOT_SOURCE_NONE) {
+        return false;
+    }
+    if (saved_.size != size) {
+        stats_.rejected++;  // Firmware dengan layout state lain
+        return false;
+    }
+    memcpy(state, saved_.data, size);
+    return true;
+}
+
+void BootManager::save(const void* state, size_t size) {
+    if (size > BOOT_STATE_MAX) {
+        return;
+    }
+    if (saved_.magic == BOOT_RECORD_MAGIC && saved_.size == size && memcmp(saved_.data, state, size) == 0) {
+        return;
+    }
+    saved_.magic = BOOT_RECORD_MAGIC;
+    saved_.version = BOOT_RECORD_VERSION;
+    saved_.seq++;
+    saved_.size = size;
+    memcpy(saved_.data, state, size);
+    saved_.crc = recordCrc(saved_);
+    rtcRecord = saved_;
+    stats_.rtcWrites++;
+    nvsPending_ = true;
+    changedMs_ = millis();
+}
+
+void BootManager::tick() {
+    if (!nvsPending_ || millis() - changedMs_ < BOOT_NVS_DELAY_MS) {
+        return;
+    }
+    nvsPending_ = false;
+    AllocGuard::Allow allow;  // Driver NVS memakai heap; hanya setelah state berubah
+    prefs_.putBytes("state", &saved_, recordLength(saved_));
+    stats_.nvsWrites++;
+}
+
+void BootManager::poll() {
+    if (stats_.firstFrameUs == 0) {
+        stats_.firstFrameUs = display_->firstFrameUs();
+    }
+}
+
+uint16_t BootManager::recordCrc(const BootRecord& record) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+    return crc16(bytes + sizeof(record.crc), recordLength(record) - sizeof(record.crc));
+}
+
+bool BootManager::valid(const BootRecord& record) {
+    return record.magic == BOOT_RECORD_MAGIC && record.version == BOOT_RECORD_VERSION &&
+           record.size <= BOOT_STATE_MAX && record.crc == recordCrc(record);
+}
+
+void BootManager::report(Print& out) const {
+    static const char* const KINDS[] = {"cold", "reset", "wake"};
+    static const char* const SOURCES[] = {"none", "rtc", "nvs"};
+    fixedPrintf(out, "boot: %s, state from %s (%lu rejected), setup %lu.%lu ms, first frame %lu.%lu ms, "
+                "ready %lu.%lu ms; saved %lu rtc, %lu nvs\n",
+                KINDS[kind_], SOURCES[source_], (unsigned long)stats_.rejected,
+                (unsigned long)(stats_.setupUs / 1000), (unsigned long)(stats_.setupUs % 1000 / 100),
+                (unsigned long)(stats_.firstFrameUs / 1000), (unsigned long)(stats_.firstFrameUs % 1000 / 100),
+                (unsigned long)(stats_.readyUs / 1000), (unsigned long)(stats_.readyUs % 1000 / 100),
+                (unsigned long)stats_.rtcWrites, (unsigned long)stats_.nvsWrites);
+}
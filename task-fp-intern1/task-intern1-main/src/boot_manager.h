@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#include "display.h"
+
+// Boot cepat dan state UI yang bertahan lewat reset.
+// State aplikasi (blob, lihat SavedUi di main.cpp) disimpan dua kali: di RTC
+// slow memory setiap kali berubah (murah, bertahan lewat reset software,
+// watchdog dan bangun dari deep sleep) dan di NVS setelah BOOT_NVS_DELAY_MS
+// tanpa perubahan (bertahan lewat listrik padam, tulis flash dibatasi).
+// Setiap salinan diberi CRC dan nomor urut; saat boot dipakai salinan valid
+// dengan nomor urut tertinggi. Setelah power-on RTC slow memory berisi acak,
+// jadi langsung diabaikan.
+// Waktu boot diukur dari esp_timer (mulai di startup aplikasi, sesudah
+// bootloader) sampai frame pertama selesai dikirim ke panel.
+
+#define BOOT_STATE_MAX 512        // Ukuran blob state aplikasi
+#define BOOT_NVS_DELAY_MS 10000   // State harus diam selama ini sebelum ditulis ke flash
+
+enum BootKind : uint8_t {
+    BOOT_COLD,   // Power-on
+    BOOT_RESET,  // Reset software, watchdog, panic, brownout
+    BOOT_WAKE,   // Bangun dari deep sleep
+};
+
+enum BootSource : uint8_t {
+    BOOT_SOURCE_NONE,
+    BOOT_SOURCE_RTC,
+    BOOT_SOURCE_NVS,
+};
+
+// Salinan di RTC slow memory dan NVS; di NVS hanya sampai akhir data yang terpakai
+struct BootRecord {
+    uint16_t crc;  // CRC-16 dari semua field sesudahnya sampai akhir data
+    uint16_t version;
+    uint32_t magic;
+    uint32_t seq;  // Naik setiap save(), salinan terbaru menang
+    uint16_t size;
+    uint16_t reserved;
+    uint8_t data[BOOT_STATE_MAX];
+};
+
+struct BootStats {
+    uint32_t setupUs;       // esp_timer saat setup() selesai
+    uint32_t firstFrameUs;  // esp_timer saat frame pertama sampai ke panel
+    uint32_t readyUs;       // esp_timer saat inisialisasi tertunda selesai
+    uint32_t rtcWrites;
+    uint32_t nvsWrites;
+    uint32_t rejected;      // Salinan dengan CRC/versi/ukuran salah saat boot
+};
+
+class BootManager {
+public:
+    // Dipanggil paling awal di setup(): jenis boot dan salinan state tersimpan
+    void begin(Display& display);
+    BootKind kind() const { return kind_; }
+
+    // Isi state dengan salinan yang dipilih di begin(); false (state tidak
+    // diubah) jika tidak ada atau ukurannya berbeda
+    bool restore(void* state, size_t size);
+    BootSource source() const { return source_; }
+
+    // Simpan jika isi berbeda dari simpanan terakhir: RTC langsung, NVS tertunda
+    void save(const void* state, size_t size);
+    // Dipanggil periodik: tulis salinan NVS yang sudah jatuh tempo
+    void tick();
+
+    void markSetupDone() { stats_.setupUs = micros(); }
+    void markReady() { stats_.readyUs = micros(); }
+    bool ready() const { return stats_.readyUs != 0; }
+    // Dipanggil periodik: catat waktu frame pertama dari Display
+    void poll();
+    bool firstFrameShown() const { return stats_.firstFrameUs != 0; }
+
+    const BootStats& stats() const { return stats_; }
+    void report(Print& out) const;
+
+private:
+    static uint16_t recordCrc(const BootRecord& record);
+    static bool valid(const BootRecord& record);
+    static size_t recordLength(const BootRecord& record) { return offsetof(BootRecord, data) + record.size; }
+
+    Display* display_ = nullptr;
+    BootKind kind_ = BOOT_COLD;
+    BootSource source_ = BOOT_SOURCE_NONE;
+    BootRecord saved_ = {};  // Salinan terakhir (dari boot atau save())
+    bool nvsPending_ = false;
+    uint32_t changedMs_ = 0;
+
+    Preferences prefs_;
+    BootStats stats_ = {};
+};
+
+extern BootManager bootManager;
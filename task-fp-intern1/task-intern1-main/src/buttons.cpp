@@ -0,0 +1,179 @@
+#include "buttons.h"
+
+#include "fixed_print.h"
+#include "trace.h"
+
+ButtonInput buttons;
+
+void ButtonInput::begin(uint8_t greenPin, uint8_t redPin, uint8_t bluePin) {
+    const uint8_t pins[BUTTON_COUNT] = {greenPin, redPin, bluePin};
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        Button& b = buttons_[i];
+        b.owner = this;
+        b.id = i;
+        b.pin = pins[i];
+        b.state = STATE_RELEASED;
+        b.level = HIGH;
+        b.lastEdgeUs = 0;
+        b.pressUs = 0;
+        b.pressedMs = 0;
+        b.nextRepeatMs = 0;
+        b.longSent = false;
+        b.consumed = false;
+        pinMode(b.pin, INPUT_PULLUP);
+        attachInterruptArg(b.pin, onEdge, &b, CHANGE);
+    }
+}
+
+// ISR: cukup catat tepi, semua logika ada di poll()
+void IRAM_ATTR ButtonInput::onEdge(void* arg) {
+    Button* b = static_cast<Button*>(arg);
+    RawEdge edge;
+    edge.button = b->id;
+    edge.level = digitalRead(b->pin);
+    edge.timeUs = micros();
+    b->owner->edges_.push(edge);
+}
+
+void ButtonInput::poll() {
+    RawEdge edge;
+    while (edges_.pop(edge)) {
+        applyEdge(buttons_[edge.button], edge.level, edge.timeUs);
+    }
+
+    uint32_t nowUs = micros();
+    uint32_t nowMs = millis();
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        update(i, nowUs, nowMs);
+    }
+}
+
+void ButtonInput::applyEdge(Button& b, uint8_t level, uint32_t timeUs) {
+    traceRecorder.button(b.id, level, timeUs);
+    b.level = level;
+    b.lastEdgeUs = timeUs;
+    if (b.state == STATE_RELEASED && level == LOW) {
+        b.state = STATE_PRESS_DEBOUNCE;
+        b.pressUs = timeUs;
+    } else if (b.state == STATE_PRESSED && level == HIGH) {
+        b.state = STATE_RELEASE_DEBOUNCE;
+    }
+}
+
+void ButtonInput::resync(uint32_t wakeUs) {
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        Button& b = buttons_[i];
+        uint8_t level = digitalRead(b.pin);
+        if (level != b.level) {
+            applyEdge(b, level, wakeUs);
+        }
+    }
+}
+
+// State machine debounce: level harus stabil BUTTON_DEBOUNCE_MS sejak tepi terakhir
+void ButtonInput::update(uint8_t id, uint32_t nowUs, uint32_t nowMs) {
+    Button& b = buttons_[id];
+    bool stable = nowUs - b.lastEdgeUs >= BUTTON_DEBOUNCE_MS * 1000UL;
+
+    switch (b.state) {
+        case STATE_RELEASED:
+            break;
+
+        case STATE_PRESS_DEBOUNCE:
+            if (!stable) break;
+            if (b.level == LOW) {
+                b.state = STATE_PRESSED;
+                b.pressedMs = nowMs;
+                b.nextRepeatMs = nowMs + BUTTON_REPEAT_DELAY_MS;
+                b.longSent = false;
+                emit(id, BUTTON_PRESS, b.pressUs);
+            } else {
+                b.state = STATE_RELEASED;  // Hanya glitch
+                b.consumed = false;
+            }
+            break;
+
+        case STATE_PRESSED:
+            if (!b.longSent && nowMs - b.pressedMs >= BUTTON_LONG_PRESS_MS) {
+                b.longSent = true;
+                emit(id, BUTTON_LONG_PRESS, nowUs);
+            }
+            if ((int32_t)(nowMs - b.nextRepeatMs) >= 0) {
+                b.nextRepeatMs += BUTTON_REPEAT_INTERVAL_MS;
+                emit(id, BUTTON_REPEAT, nowUs);
+            }
+            break;
+
+        case STATE_RELEASE_DEBOUNCE:
+            if (!stable) break;
+            if (b.level == HIGH) {
+                b.state = STATE_RELEASED;
+                emit(id, BUTTON_RELEASE, b.lastEdgeUs);
+                if (!b.longSent) {
+                    emit(id, BUTTON_SHORT_PRESS, b.lastEdgeUs);
+                }
+                b.consumed = false;
+            } else {
+                b.state = STATE_PRESSED;  // Pantulan saat ditahan
+            }
+            break;
+    }
+}
+
+void ButtonInput::emit(uint8_t button, uint8_t type, uint32_t timeUs) {
+    if (buttons_[button].consumed) {
+        return;
+    }
+    ButtonEvent event;
+    event.button = button;
+    event.type = type;
+    event.timeUs = timeUs;
+    events_.push(event);
+}
+
+bool ButtonInput::next(ButtonEvent& event) {
+    if (!events_.pop(event)) {
+        return false;
+    }
+    uint32_t latency = micros() - event.timeUs;
+    eventCount_++;
+    latencyUsTotal_ += latency;
+    if (latency > latencyUsMax_) latencyUsMax_ = latency;
+    return true;
+}
+
+bool ButtonInput::isHeld(uint8_t button) const {
+    DebounceState state = buttons_[button].state;
+    return state == STATE_PRESSED || state == STATE_RELEASE_DEBOUNCE;
+}
+
+bool ButtonInput::isBusy() const {
+    if (!edges_.empty() || !events_.empty()) return true;
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+        if (buttons_[i].state != STATE_RELEASED) return true;
+    }
+    return false;
+}
+
+ButtonStats ButtonInput::stats() const {
+    ButtonStats s;
+    s.events = eventCount_;
+    s.edgesDropped = edges_.dropped();
+    s.eventsDropped = events_.dropped();
+    s.latencyUsMax = latencyUsMax_;
+    s.latencyUsAvg = eventCount_ ? (uint32_t)(latencyUsTotal_ / eventCount_) : 0;
+    return s;
+}
+
+void ButtonInput::report(Print& out) const {
+    ButtonStats s = stats();
+    fixedPrintf(out, "buttons: %lu events, latency avg %lu us, max %lu us, dropped %lu/%lu\n",
+                (unsigned long)s.events, (unsigned long)s.latencyUsAvg, (unsigned long)s.latencyUsMax,
+                (unsigned long)s.edgesDropped, (unsigned long)s.eventsDropped);
+}
+
+void ButtonInput::resetStats() {
+    eventCount_ = 0;
+    latencyUsMax_ = 0;
+    latencyUsTotal_ = 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ring_buffer.h"
+
+// Input tombol berbasis interupsi.
+// ISR GPIO hanya mencatat tepi (level + timestamp) ke ring buffer. poll()
+// menjalankan state machine debounce per tombol tanpa delay dan menghasilkan
+// event bertimestamp yang dibaca semua mode lewat next().
+
+enum ButtonId : uint8_t {
+    BUTTON_GREEN,
+    BUTTON_RED,
+    BUTTON_BLUE,
+    BUTTON_COUNT
+};
+
+enum ButtonEventType : uint8_t {
+    BUTTON_PRESS,        // Tombol ditekan (setelah debounce)
+    BUTTON_RELEASE,      // Tombol dilepas
+    BUTTON_SHORT_PRESS,  // Dilepas sebelum LONG_PRESS, dikirim setelah RELEASE
+    BUTTON_LONG_PRESS,   // Ditahan melewati LONG_PRESS, dikirim sekali saat masih ditahan
+    BUTTON_REPEAT        // Auto-repeat selama tombol ditahan
+};
+
+struct ButtonEvent {
+    uint8_t button;
+    uint8_t type;
+    uint32_t timeUs;  // Waktu tepi fisik pertama yang memicu event
+};
+
+#define BUTTON_DEBOUNCE_MS 30
+#define BUTTON_LONG_PRESS_MS 2000
+#define BUTTON_REPEAT_DELAY_MS 500
+#define BUTTON_REPEAT_INTERVAL_MS 150
+
+struct ButtonStats {
+    uint32_t events;
+    uint32_t edgesDropped;   // Ring tepi penuh (ISR lebih cepat dari poll)
+    uint32_t eventsDropped;  // Ring event penuh (konsumen terlambat)
+    uint32_t latencyUsMax;   // Tepi fisik sampai event dibaca konsumen
+    uint32_t latencyUsAvg;
+};
+
+class ButtonInput {
+public:
+    // Pasang pull-up dan interupsi CHANGE pada ketiga pin
+    void begin(uint8_t greenPin, uint8_t redPin, uint8_t bluePin);
+    // Jalankan state machine debounce; dipanggil periodik dari task input
+    void poll();
+    // Ambil event berikutnya, false jika antrean kosong
+    bool next(ButtonEvent& event);
+    bool isHeld(uint8_t button) const;
+    // true jika masih ada tepi/debounce yang belum selesai diproses
+    bool isBusy() const;
+    // Setelah light sleep: interupsi tombol mati selama tidur, jadi tepi yang
+    // membangunkan CPU dibaca dari level pin dan dicatat pada waktu bangun
+    void resync(uint32_t wakeUs);
+    // Sisa event dari tekanan yang sedang berjalan dibuang (mis. tekanan yang
+    // hanya menyalakan layar); berlaku sampai tombol dilepas
+    void consume(uint8_t button) { buttons_[button].consumed = buttons_[button].state != STATE_RELEASED; }
+
+    ButtonStats stats() const;
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    enum DebounceState : uint8_t {
+        STATE_RELEASED,
+        STATE_PRESS_DEBOUNCE,
+        STATE_PRESSED,
+        STATE_RELEASE_DEBOUNCE
+    };
+
+    struct RawEdge {
+        uint8_t button;
+        uint8_t level;
+        uint32_t timeUs;
+    };
+
+    struct Button {
+        ButtonInput* owner;     // Untuk ISR (argumen interupsi = Button*)
+        uint8_t id;
+        uint8_t pin;
+        DebounceState state;
+        uint8_t level;          // Level terakhir yang dilaporkan ISR
+        uint32_t lastEdgeUs;    // Untuk cek kestabilan debounce
+        uint32_t pressUs;       // Tepi pertama dari tekanan ini
+        uint32_t pressedMs;     // Waktu tekanan dikonfirmasi
+        uint32_t nextRepeatMs;
+        bool longSent;
+        bool consumed;          // Event tekanan ini tidak dikirim
+    };
+
+    static void IRAM_ATTR onEdge(void* arg);
+    void applyEdge(Button& b, uint8_t level, uint32_t timeUs);
+    void emit(uint8_t button, uint8_t type, uint32_t timeUs);
+    void update(uint8_t id, uint32_t nowUs, uint32_t nowMs);
+
+    Button buttons_[BUTTON_COUNT];
+    SpscRing<RawEdge, 32> edges_;
+    SpscRing<ButtonEvent, 16> events_;
+
+    uint32_t eventCount_ = 0;
+    uint32_t latencyUsMax_ = 0;
+    uint64_t latencyUsTotal_ = 0;
+};
+
+extern ButtonInput buttons;
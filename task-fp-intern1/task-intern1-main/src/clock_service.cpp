@@ -0,0 +1,180 @@
+#include "clock_service.h"
+
+#include <esp_timer.h>
+
+#include "fixed_print.h"
+#include "profiler.h"
+#include "trace.h"
+
+ClockService clockService;
+
+static uint8_t toBcd(uint8_t value) {
+    return ((value / 10) << 4) | (value % 10);
+}
+
+static uint8_t fromBcd(uint8_t value) {
+    return (value >> 4) * 10 + (value & 0x0F);
+}
+
+bool ClockService::begin(I2CBus& bus) {
+    bus_ = &bus;
+    device_ = bus.addDevice("ds1307", CLOCK_RTC_ADDRESS, CLOCK_RTC_I2C_CLOCK);
+    uint32_t t = baseUnix_;
+    bool found = readRtc(t);
+    setBase(t, esp_timer_get_time());
+
+    // Fase sub-detik belum diketahui, cari pergantian detik RTC di tick()
+    state_ = SYNC_SEARCH;
+    searchFrom_ = t;
+    searchStartMs_ = millis();
+    nextPollMs_ = searchStartMs_ + CLOCK_EDGE_POLL_MS;
+    lastSecond_ = t;
+    return found;
+}
+
+uint32_t ClockService::unixtime() const {
+    return baseUnix_ + (uint32_t)((esp_timer_get_time() - baseUs_) / 1000000);
+}
+
+uint16_t ClockService::millisecond() const {
+    return (uint16_t)((esp_timer_get_time() - baseUs_) / 1000 % 1000);
+}
+
+uint32_t ClockService::msUntilPoll() const {
+    int32_t wait = (int32_t)(nextPollMs_ - millis());
+    return wait > 0 ? wait : 0;
+}
+
+void ClockService::tick() {
+    uint32_t nowMs = millis();
+    if ((int32_t)(nowMs - nextPollMs_) >= 0) {
+        if (state_ == SYNC_SEARCH) {
+            int64_t at = esp_timer_get_time();
+            uint32_t t = searchFrom_;
+            readRtc(t);  // Gagal dibaca dianggap belum berganti detik
+            if (t != searchFrom_) {
+                // Detik RTC baru saja berganti, error fase <= satu interval polling
+                setBase(t, at);
+                state_ = SYNC_LOCKED;
+                nextPollMs_ = nowMs + CLOCK_RESYNC_MS;
+            } else if (nowMs - searchStartMs_ >= CLOCK_EDGE_SEARCH_MS) {
+                // RTC tidak berdetak (baterai/oscillator mati), pakai jam lokal saja
+                state_ = SYNC_LOCKED;
+                nextPollMs_ = nowMs + CLOCK_RESYNC_MS;
+            } else {
+                nextPollMs_ = nowMs + CLOCK_EDGE_POLL_MS;
+            }
+        } else {
+            resync();
+            nextPollMs_ = nowMs + (state_ == SYNC_LOCKED ? CLOCK_RESYNC_MS : CLOCK_EDGE_POLL_MS);
+        }
+    }
+
+    uint32_t t = unixtime();
+    if (t != lastSecond_) {
+        lastSecond_ = t;
+        secondCount_++;
+        stats_.secondTicks++;
+        if (onSecond_) {
+            onSecond_(t);
+        }
+    }
+}
+
+void ClockService::adjust(const DateTime& dt) {
+    // Register 0x00..0x06 dalam BCD; menulis detik dengan CH = 0 menjalankan osilator
+    const uint8_t regs[] = {0x00,
+                            toBcd(dt.second()),
+                            toBcd(dt.minute()),
+                            toBcd(dt.hour()),
+                            (uint8_t)(dt.dayOfTheWeek() + 1),
+                            toBcd(dt.day()),
+                            toBcd(dt.month()),
+                            toBcd(dt.year() - 2000)};
+    if (bus_->write(device_, regs, sizeof(regs), I2C_PRIORITY_TIME)) {
+        rtcRunning_ = true;
+    } else {
+        stats_.rtcErrors++;
+    }
+    // DS1307 mulai detik baru saat register detik ditulis
+    setBase(dt.unixtime(), esp_timer_get_time());
+    state_ = SYNC_LOCKED;
+    nextPollMs_ = millis() + CLOCK_RESYNC_MS;
+}
+
+// Bandingkan cache dengan RTC. RTC hanya beresolusi detik, jadi selisih satu
+// detik berarti fase cache tertinggal/mendahului tepi detik RTC: geser base
+// ke tepi tersebut. Selisih lebih besar (RTC diubah dari luar) diambil langsung
+// lalu fasenya dicari ulang.
+void ClockService::resync() {
+    int64_t at = esp_timer_get_time();
+    uint32_t rtcTime;
+    if (!readRtc(rtcTime)) {
+        return;  // Bus bermasalah, cache tetap dipakai sampai resync berikutnya
+    }
+    uint32_t cached = baseUnix_ + (uint32_t)((at - baseUs_) / 1000000);
+    int64_t cachedMs = (int64_t)cached * 1000 + (at - baseUs_) / 1000 % 1000;
+    stats_.resyncs++;
+
+    if (rtcTime == cached) {
+        return;  // Masih di detik yang sama
+    }
+    if (rtcTime + 1 == cached) {
+        // Cache mendahului: tahan di akhir detik RTC
+        setBase(rtcTime, at - 999000);
+    } else {
+        // Cache tertinggal: RTC baru saja berganti detik
+        setBase(rtcTime, at);
+    }
+    int64_t newMs = (int64_t)rtcTime * 1000 + (at - baseUs_) / 1000;
+    stats_.corrections++;
+    stats_.lastCorrectionMs = (int32_t)(newMs - cachedMs);
+
+    if (rtcTime > cached + 1 || rtcTime + 1 < cached) {
+        // RTC diubah dari luar, fase lama tidak berlaku lagi
+        state_ = SYNC_SEARCH;
+        searchFrom_ = rtcTime;
+        searchStartMs_ = millis();
+    }
+}
+
+bool ClockService::readRtc(uint32_t& unixtime) {
+    uint32_t start = micros();
+    const uint8_t pointer = 0x00;
+    uint8_t regs[7];
+    bool ok;
+    {
+        PROFILE_SCOPE("rtc.read");
+        ok = bus_->writeRead(device_, &pointer, 1, regs, sizeof(regs), I2C_PRIORITY_TIME);
+    }
+    uint32_t elapsed = micros() - start;
+    stats_.rtcReads++;
+    if (elapsed > stats_.rtcReadUsMax) stats_.rtcReadUsMax = elapsed;
+    if (!ok) {
+        stats_.rtcErrors++;
+        return false;
+    }
+    rtcRunning_ = (regs[0] & 0x80) == 0;
+    unixtime = DateTime(2000 + fromBcd(regs[6]), fromBcd(regs[5] & 0x1F), fromBcd(regs[4] & 0x3F),
+                        fromBcd(regs[2] & 0x3F), fromBcd(regs[1] & 0x7F), fromBcd(regs[0] & 0x7F))
+                   .unixtime();
+    traceRecorder.rtc(unixtime, start);
+    return true;
+}
+
+void ClockService::setBase(uint32_t unixtime, int64_t atUs) {
+    baseUnix_ = unixtime;
+    baseUs_ = atUs;
+}
+
+void ClockService::report(Print& out) const {
+    fixedPrintf(out, "clock: %s, %lu rtc reads (max %lu us, %lu errors), %lu resyncs, "
+                "%lu corrections (last %ld ms), %lu ticks\n",
+                state_ == SYNC_LOCKED ? "locked" : "searching", (unsigned long)stats_.rtcReads,
+                (unsigned long)stats_.rtcReadUsMax, (unsigned long)stats_.rtcErrors, (unsigned long)stats_.resyncs,
+                (unsigned long)stats_.corrections, (long)stats_.lastCorrectionMs, (unsigned long)stats_.secondTicks);
+}
+
+void ClockService::resetStats() {
+    stats_ = {};
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+#include "i2c_bus.h"
+
+// Jam sistem dengan cache waktu RTC.
+// DS1307 dibaca sekali saat boot, setelah itu waktu dihitung dari
+// esp_timer_get_time() (us, 64-bit, tidak overflow). Pin SQW DS1307 tidak
+// tersambung di rangkaian, jadi fase detik dikunci dengan polling RTC sampai
+// detiknya berganti, lalu dikoreksi lewat resync berkala.
+// now()/unixtime() murah dan tidak menyentuh bus I2C. Register DS1307 dibaca
+// langsung lewat i2cBus dengan prioritas tertinggi.
+
+#define CLOCK_RESYNC_MS 60000UL      // Resync ke RTC tiap 1 menit
+#define CLOCK_EDGE_POLL_MS 50        // Interval polling saat mencari pergantian detik
+#define CLOCK_EDGE_SEARCH_MS 1500    // Batas pencarian, lewat dari ini pakai fase apa adanya
+#define CLOCK_RTC_ADDRESS 0x68
+#define CLOCK_RTC_I2C_CLOCK 100000UL  // DS1307 hanya mendukung standard mode
+
+struct ClockStats {
+    uint32_t rtcReads;
+    uint32_t rtcReadUsMax;
+    uint32_t rtcErrors;       // Baca/tulis RTC yang gagal setelah retry bus
+    uint32_t resyncs;
+    uint32_t corrections;     // Resync yang menggeser waktu cache
+    int32_t lastCorrectionMs; // Geseran waktu cache pada koreksi terakhir (+ = dimajukan)
+    uint32_t secondTicks;
+};
+
+typedef void (*SecondCallback)(uint32_t unixtime);
+
+class ClockService {
+public:
+    // false jika RTC tidak menjawab; jam tetap berjalan dari waktu terakhir
+    bool begin(I2CBus& bus);
+    // false jika bit CH DS1307 menyala (osilator berhenti, waktu belum diset)
+    bool rtcRunning() const { return rtcRunning_; }
+    // Dipanggil periodik dari scheduler: kunci fase, resync, dan event pergantian detik
+    void tick();
+
+    DateTime now() const { return DateTime(unixtime()); }
+    uint32_t unixtime() const;
+    // Milidetik di dalam detik berjalan (0..999)
+    uint16_t millisecond() const;
+    // Unixtime (us) dikurangi esp_timer_get_time(); tetap sampai jam dikoreksi.
+    // Sebelum fase detik terkunci meleset sampai 1 detik.
+    int64_t offsetUs() const { return (int64_t)baseUnix_ * 1000000 - baseUs_; }
+    // Naik satu setiap pergantian detik; layar cukup membandingkan nilai ini
+    uint32_t secondCount() const { return secondCount_; }
+    // Waktu sampai tick() berikutnya membaca RTC (cari fase, resync); untuk perencanaan idle
+    uint32_t msUntilPoll() const;
+    // Callback dijalankan dari tick() saat detik berganti
+    void onSecond(SecondCallback callback) { onSecond_ = callback; }
+
+    // Tulis waktu baru ke RTC dan cache sekaligus
+    void adjust(const DateTime& dt);
+
+    const ClockStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    enum SyncState { SYNC_SEARCH, SYNC_LOCKED };
+
+    bool readRtc(uint32_t& unixtime);
+    void setBase(uint32_t unixtime, int64_t atUs);
+    void resync();
+
+    I2CBus* bus_ = nullptr;
+    int device_ = -1;
+    bool rtcRunning_ = false;
+    SyncState state_ = SYNC_SEARCH;
+
+    // Waktu cache = baseUnix_ + (esp_timer_get_time() - baseUs_) / 1e6
+    uint32_t baseUnix_ = 0;
+    int64_t baseUs_ = 0;
+
+    uint32_t searchFrom_ = 0;       // Detik RTC saat pencarian fase dimulai
+    uint32_t searchStartMs_ = 0;
+    uint32_t nextPollMs_ = 0;
+
+    uint32_t lastSecond_ = 0;
+    uint32_t secondCount_ = 0;
+    SecondCallback onSecond_ = nullptr;
+    ClockStats stats_ = {};
+};
+
+extern ClockService clockService;
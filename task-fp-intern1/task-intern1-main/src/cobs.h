@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Framing COBS (Consistent Overhead Byte Stuffing) dan CRC-16 untuk
+// protokol telemetri. Hasil encode tidak pernah berisi 0x00, jadi 0x00
+// dipakai sebagai pemisah frame di stream Serial.
+
+// Ukuran buffer keluaran maksimum untuk encode len byte (tanpa pemisah)
+#define COBS_MAX_ENCODED(len) ((len) + (len) / 254 + 1)
+
+// Return panjang hasil encode
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+// Return panjang hasil decode, 0 jika data tidak valid
+size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out);
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+uint16_t crc16(const uint8_t* data, size_t length);
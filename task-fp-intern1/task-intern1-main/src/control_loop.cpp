@@ -0,0 +1,196 @@
+#include "control_loop.h"
+
+#include "fixed_print.h"
+
+ControlLoop controlLoop;
+
+// Rentang servo mode DHT; LED berganti di tengahnya
+static const float CONTROL_MIN_TEMPERATURE = 15.0;
+static const float CONTROL_MAX_TEMPERATURE = 35.0;
+static const uint32_t CONTROL_MAX_LUX = 1000;  // Skala servo 0-1000 lux, sama dengan bar di layar
+
+void ControlLoop::begin(uint8_t servoPin, uint8_t greenLedPin, uint8_t redLedPin) {
+    servo_.begin(servoPin, 500, 2400, 90);
+    greenLedPin_ = greenLedPin;
+    redLedPin_ = redLedPin;
+    pinMode(greenLedPin, OUTPUT);
+    pinMode(redLedPin, OUTPUT);
+}
+
+bool ControlLoop::start() {
+#if CONTROL_ASYNC
+    if (task_ == nullptr) {
+        xTaskCreatePinnedToCore(taskEntry, "control", 4096, this, CONTROL_TASK_PRIORITY, &task_,
+                                CONTROL_TASK_CORE);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if CONTROL_ASYNC
+// Jadwal tetap dari tick FreeRTOS, tidak bergeser oleh lama tick() (bacaan DHT ±5 ms)
+void ControlLoop::taskEntry(void* arg) {
+    ControlLoop* self = static_cast<ControlLoop*>(arg);
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        self->tick();
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(CONTROL_PERIOD_MS));
+    }
+}
+#endif
+
+void ControlLoop::tick() {
+    if (resetRequested_.exchange(false, std::memory_order_acquire)) {
+        stats_ = {};
+        jitter_.resetStats();
+        servo_.resetStats();
+    }
+    uint32_t start = micros();
+    if (slept_.exchange(false)) {
+        jitter_.sync(start);
+    } else {
+        jitter_.mark(start, CONTROL_PERIOD_MS * 1000UL);
+    }
+
+    ControlCommand command;
+    while (commands_.pop(command)) {
+        apply(command);
+    }
+
+    dhtService.tick();
+    ldrService.tick();
+    DhtReading dht = dhtService.latest();
+    LdrReading ldr = ldrService.latest();
+
+    // Event hanya saat ada yang perlu digambar ulang di UI
+    uint32_t now = millis();
+    if (dht.valid != dhtValid_ || dht.timestampMs != dhtStampMs_) {
+        dhtValid_ = dht.valid;
+        dhtStampMs_ = dht.timestampMs;
+        events_.push({CONTROL_EVENT_DHT, now});
+    }
+    if (ldr.dark != dark_) {
+        dark_ = ldr.dark;
+        events_.push({CONTROL_EVENT_LIGHT, now});
+    }
+
+    drive(dht, ldr);
+
+    ControlSnapshot state = {dht, ldr, now, (uint8_t)servo_.position(), greenLed_, redLed_};
+    snapshot_.write(state);
+
+    uint32_t elapsed = micros() - start;
+    stats_.ticks++;
+    if (elapsed > stats_.tickUsMax) stats_.tickUsMax = elapsed;
+}
+
+void ControlLoop::apply(const ControlCommand& command) {
+    stats_.commands++;
+    if (command.type == CONTROL_CMD_MODE) {
+        mode_ = (ControlMode)command.value;
+    } else if (command.type == CONTROL_CMD_INDICATOR) {
+        if (indicator_ != INDICATOR_NONE && command.value == INDICATOR_NONE) {
+            writeLeds(false, false);  // Pola selesai; mode yang mengikuti sensor menyalakan lagi
+        }
+        indicator_ = (ControlIndicator)command.value;
+    } else if (command.type == CONTROL_CMD_LOW_POWER) {
+        ldrService.setLowPower(command.value);
+    }
+}
+
+// Hitung target servo dan LED dari mode dan indikator; yang tidak berubah tidak ditulis
+void ControlLoop::drive(const DhtReading& dht, const LdrReading& ldr) {
+    bool green = greenLed_;
+    bool red = redLed_;
+    int servoPos = 0;
+    bool haveTarget = false;  // Di bawah 15 C map() negatif, jadi tidak bisa jadi penanda
+
+    if (mode_ == CONTROL_FOLLOW_DHT && dht.valid) {
+        // Tanpa bacaan valid, servo dan LED dibiarkan di posisi terakhir (NaN tidak ke map())
+        servoPos = map(dht.temperature, CONTROL_MIN_TEMPERATURE, CONTROL_MAX_TEMPERATURE, 0, 180);
+        haveTarget = true;
+        float middle = (CONTROL_MIN_TEMPERATURE + CONTROL_MAX_TEMPERATURE) / 2;
+        if (dht.temperature < middle - CONTROL_TEMPERATURE_HYSTERESIS / 2) {
+            cold_ = true;
+        } else if (dht.temperature >= middle + CONTROL_TEMPERATURE_HYSTERESIS / 2) {
+            cold_ = false;
+        }
+        red = cold_;
+        green = !cold_;
+    } else if (mode_ == CONTROL_FOLLOW_LIGHT) {
+        uint32_t scaledLux = ldr.lux < CONTROL_MAX_LUX ? ldr.lux : CONTROL_MAX_LUX;
+        servoPos = map(scaledLux, 0, CONTROL_MAX_LUX, 0, 180);
+        haveTarget = true;
+        red = ldr.dark;
+        green = !ldr.dark;
+    }
+
+    if (indicator_ != INDICATOR_NONE) {
+        bool blink = (millis() / CONTROL_BLINK_MS) & 1;
+        red = indicator_ == INDICATOR_ALARM ? blink : !blink;
+        green = !red;
+    }
+
+    if (haveTarget) {
+        servo_.moveTo(servoPos);  // Dibatasi 0-180, deadband dan gerak halus di ServoPlanner
+    }
+    writeLeds(green, red);
+}
+
+void ControlLoop::writeLeds(bool green, bool red) {
+    writeLed(greenLedPin_, green, greenLed_);
+    writeLed(redLedPin_, red, redLed_);
+    ledsWritten_ = true;
+}
+
+void ControlLoop::writeLed(uint8_t pin, bool on, bool& state) {
+    if (ledsWritten_ && on == state) {
+        stats_.ledSkips++;
+        return;
+    }
+    digitalWrite(pin, on ? HIGH : LOW);
+    state = on;
+    stats_.ledWrites++;
+}
+
+void ControlLoop::send(uint8_t type, uint8_t value, uint8_t& sent) {
+    if (value != sent && commands_.push({type, value})) {
+        sent = value;
+    }
+}
+
+void ControlLoop::setMode(ControlMode mode) {
+    send(CONTROL_CMD_MODE, mode, sentMode_);
+}
+
+void ControlLoop::setIndicator(ControlIndicator indicator) {
+    send(CONTROL_CMD_INDICATOR, indicator, sentIndicator_);
+}
+
+void ControlLoop::setLowPower(bool lowPower) {
+    send(CONTROL_CMD_LOW_POWER, lowPower, sentLowPower_);
+}
+
+ControlSnapshot ControlLoop::snapshot() {
+    ControlSnapshot state;
+    uiStats_.snapshotRetries += snapshot_.read(state);
+    return state;
+}
+
+void ControlLoop::report(Print& out) const {
+    fixedPrintf(out, "control: %lu ticks, max %lu us, %lu commands (%lu dropped), %lu events dropped, "
+                "%lu snapshot retries, led %lu writes (%lu unchanged)\n",
+                (unsigned long)stats_.ticks, (unsigned long)stats_.tickUsMax, (unsigned long)stats_.commands,
+                (unsigned long)commands_.dropped(), (unsigned long)events_.dropped(),
+                (unsigned long)uiStats_.snapshotRetries, (unsigned long)stats_.ledWrites,
+                (unsigned long)stats_.ledSkips);
+    jitter_.report(out);
+    servo_.report(out);
+}
+
+void ControlLoop::resetStats() {
+    uiStats_ = {};
+    resetRequested_.store(true, std::memory_order_release);
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+#include "dht_service.h"
+#include "jitter.h"
+#include "ldr_service.h"
+#include "ring_buffer.h"
+#include "seqlock.h"
+#include "servo_planner.h"
+
+// Loop sensor + aktuator, terpisah dari UI.
+// Di ESP32 loop ini berjalan sebagai task FreeRTOS di core 0 (loop Arduino/UI
+// di core 1): sampling DHT/LDR, servo dan LED. Bacaan DHT yang mematikan
+// interupsi beberapa ms tidak lagi menahan input dan render.
+// Kedua sisi tidak pernah saling menunggu:
+//   UI -> kontrol: perintah (mode output, indikator LED) lewat ring SPSC
+//   kontrol -> UI: event bacaan baru lewat ring SPSC, dan snapshot state
+//                  terbaru lewat seqlock (UI membaca salinan utuh tanpa lock)
+// Output hanya ditulis saat berubah: servo lewat ServoPlanner (gerak halus,
+// deadband), LED dibandingkan dengan level terakhir, dan batas LED mode DHT
+// memakai hysteresis agar tidak berkedip saat suhu di sekitar titik tengah.
+// Di build tanpa FreeRTOS tick() dijalankan scheduler di loop yang sama.
+
+#ifndef CONTROL_ASYNC
+#ifdef ESP_PLATFORM
+#define CONTROL_ASYNC 1
+#else
+#define CONTROL_ASYNC 0
+#endif
+#endif
+
+#define CONTROL_PERIOD_MS 10
+#define CONTROL_TASK_CORE 0
+#define CONTROL_TASK_PRIORITY 3   // Di atas task transfer display
+#define CONTROL_BLINK_MS 250      // Setengah periode kedip LED, sama dengan bingkai alarm di layar
+#define CONTROL_QUEUE_SIZE 8
+#define CONTROL_TEMPERATURE_HYSTERESIS 0.5  // Lebar pita (C) di sekitar titik tengah LED mode DHT
+
+// Sumber posisi servo dan LED
+enum ControlMode : uint8_t {
+    CONTROL_HOLD,          // Output dibiarkan di posisi terakhir
+    CONTROL_FOLLOW_DHT,    // Servo 15-35 C -> 0-180, LED merah dingin / hijau hangat
+    CONTROL_FOLLOW_LIGHT,  // Servo 0-1000 lux -> 0-180, LED merah gelap / hijau terang
+};
+
+// Pola LED yang menimpa mode
+enum ControlIndicator : uint8_t {
+    INDICATOR_NONE,
+    INDICATOR_ALARM,  // Merah/hijau bergantian, merah lebih dulu
+    INDICATOR_TIMER,  // Hijau/merah bergantian, hijau lebih dulu
+};
+
+enum ControlCommandType : uint8_t {
+    CONTROL_CMD_MODE,
+    CONTROL_CMD_INDICATOR,
+    CONTROL_CMD_LOW_POWER,
+};
+
+struct ControlCommand {
+    uint8_t type;
+    uint8_t value;
+};
+
+enum ControlEventType : uint8_t {
+    CONTROL_EVENT_DHT,    // Bacaan DHT baru atau validitasnya berubah
+    CONTROL_EVENT_LIGHT,  // Keputusan Gelap/Terang berubah
+};
+
+struct ControlEvent {
+    uint8_t type;
+    uint32_t timeMs;
+};
+
+// State terbaru untuk UI; satu salinan konsisten dari satu tick kontrol
+struct ControlSnapshot {
+    DhtReading dht;
+    LdrReading ldr;
+    uint32_t tickMs;
+    uint8_t servo;     // Posisi servo sekarang (bisa masih bergerak ke target)
+    bool greenLed;
+    bool redLed;
+};
+
+// Ditulis sisi kontrol saja; reset juga dijalankan di sisi kontrol (resetStats())
+struct ControlStats {
+    uint32_t ticks;
+    uint32_t tickUsMax;
+    uint32_t commands;
+    uint32_t ledWrites;
+    uint32_t ledSkips;         // Level LED yang tidak ditulis karena sama
+};
+
+// Ditulis sisi UI saja
+struct ControlUiStats {
+    uint32_t snapshotRetries;  // Salinan seqlock yang diulang
+};
+
+class ControlLoop {
+public:
+    void begin(uint8_t servoPin, uint8_t greenLedPin, uint8_t redLedPin);
+    // Jalankan task di core 0; return false jika tick() harus dipanggil dari loop sendiri
+    bool start();
+    // Satu iterasi kontrol: perintah, sensor, output, snapshot
+    void tick();
+
+    // ---- Sisi UI ----
+    // Perintah dikirim hanya saat berubah; antrian penuh dicoba lagi pada panggilan berikutnya
+    void setMode(ControlMode mode);
+    void setIndicator(ControlIndicator indicator);
+    // LDR tanpa timer 1 kHz saat bacaannya hanya dipakai sampel lambat (light sleep)
+    void setLowPower(bool lowPower);
+    // CPU baru bangun dari light sleep: interval tick berikutnya tidak dihitung jitter
+    void afterSleep() { slept_.store(true); }
+    ControlSnapshot snapshot();
+    bool nextEvent(ControlEvent& event) { return events_.pop(event); }
+
+    const ControlStats& stats() const { return stats_; }
+    const ControlUiStats& uiStats() const { return uiStats_; }
+    const JitterMeter& jitter() const { return jitter_; }
+    const ServoPlanner& servo() const { return servo_; }
+    void report(Print& out) const;
+    // Statistik sisi UI langsung di-reset; sisi kontrol (termasuk jitter dan
+    // servo) di-reset oleh tick() berikutnya, jadi tidak ada penulis kedua
+    void resetStats();
+
+private:
+    void send(uint8_t type, uint8_t value, uint8_t& sent);
+    void apply(const ControlCommand& command);
+    void drive(const DhtReading& dht, const LdrReading& ldr);
+    void writeLeds(bool green, bool red);
+    void writeLed(uint8_t pin, bool on, bool& state);
+#if CONTROL_ASYNC
+    static void taskEntry(void* arg);
+    TaskHandle_t task_ = nullptr;
+#endif
+
+    ServoPlanner servo_;
+    uint8_t greenLedPin_ = 0;
+    uint8_t redLedPin_ = 0;
+
+    // Dipakai sisi kontrol
+    ControlMode mode_ = CONTROL_HOLD;
+    ControlIndicator indicator_ = INDICATOR_NONE;
+    bool greenLed_ = false;
+    bool redLed_ = false;
+    bool ledsWritten_ = false;  // Penulisan pertama tidak dibandingkan
+    bool cold_ = false;         // Keputusan suhu mode DHT, dengan hysteresis
+    uint32_t dhtStampMs_ = 0;
+    bool dhtValid_ = false;
+    bool dark_ = false;
+    JitterMeter jitter_{"control"};
+
+    // Dipakai sisi UI; 0xff = belum pernah dikirim
+    uint8_t sentMode_ = 0xff;
+    uint8_t sentIndicator_ = 0xff;
+    uint8_t sentLowPower_ = 0xff;
+    std::atomic<bool> slept_{false};
+    std::atomic<bool> resetRequested_{false};
+    ControlUiStats uiStats_ = {};
+
+    SpscRing<ControlCommand, CONTROL_QUEUE_SIZE> commands_;
+    SpscRing<ControlEvent, CONTROL_QUEUE_SIZE> events_;
+    SeqLock<ControlSnapshot> snapshot_;
+    ControlStats stats_ = {};
+};
+
+extern ControlLoop controlLoop;
@@ -0,0 +1,71 @@
+#include "dht_service.h"
+
+#include "fixed_print.h"
+#include "profiler.h"
+#include "trace.h"
+
+DhtService dhtService;
+
+void DhtService::begin(uint8_t pin) {
+    sensor_.setup(pin, DHTesp::DHT22);
+    // Sensor butuh waktu stabil setelah power-on sebelum bacaan pertama
+    nextSampleMs_ = millis() + sensor_.getMinimumSamplingPeriod();
+}
+
+void DhtService::tick() {
+    uint32_t now = millis();
+    if ((int32_t)(now - nextSampleMs_) < 0) {
+        return;
+    }
+
+    // Protokol bit-bang memblokir beberapa ms dengan interupsi mati
+    uint32_t start = micros();
+    TempAndHumidity data;
+    {
+        PROFILE_SCOPE("dht.read");
+        data = sensor_.getTempAndHumidity();
+    }
+    uint32_t elapsed = micros() - start;
+
+    stats_.reads++;
+    stats_.readUsLast = elapsed;
+    if (elapsed > stats_.readUsMax) stats_.readUsMax = elapsed;
+
+    bool ok = sensor_.getStatus() == DHTesp::ERROR_NONE && !isnan(data.temperature) && !isnan(data.humidity);
+    traceRecorder.dht(ok, data.temperature, data.humidity, start);
+    if (ok) {
+        reading_.temperature = data.temperature;
+        reading_.humidity = data.humidity;
+        reading_.timestampMs = now;
+        reading_.valid = true;
+        retries_ = 0;
+        nextSampleMs_ = now + DHT_SAMPLE_PERIOD_MS;
+        return;
+    }
+
+    stats_.failures++;
+    if (retries_ < DHT_MAX_RETRIES) {
+        retries_++;
+        nextSampleMs_ = now + DHT_RETRY_DELAY_MS;
+    } else {
+        retries_ = 0;
+        nextSampleMs_ = now + DHT_SAMPLE_PERIOD_MS;
+    }
+}
+
+DhtReading DhtService::latest() const {
+    DhtReading result = reading_;
+    if (result.valid && millis() - result.timestampMs > DHT_STALE_MS) {
+        result.valid = false;
+    }
+    return result;
+}
+
+void DhtService::report(Print& out) const {
+    fixedPrintf(out, "dht: %lu reads, %lu failed, read last %lu us, max %lu us\n", (unsigned long)stats_.reads,
+                (unsigned long)stats_.failures, (unsigned long)stats_.readUsLast, (unsigned long)stats_.readUsMax);
+}
+
+void DhtService::resetStats() {
+    stats_ = DhtStats();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+#include <DHTesp.h>
+
+// Layanan sampling DHT22 di latar belakang.
+// Sensor hanya dibaca sesuai jadwalnya sendiri (DHT22 paling cepat 2 detik
+// sekali); UI dan kontrol membaca nilai cache lewat latest() tanpa menyentuh bus.
+
+#define DHT_SAMPLE_PERIOD_MS 2000
+#define DHT_RETRY_DELAY_MS 500   // Jeda sebelum mencoba lagi setelah bacaan gagal/NaN
+#define DHT_MAX_RETRIES 3
+#define DHT_STALE_MS 10000       // Bacaan lebih tua dari ini dianggap tidak valid
+
+struct DhtReading {
+    float temperature;
+    float humidity;
+    uint32_t timestampMs;  // Waktu bacaan valid terakhir
+    bool valid;
+};
+
+struct DhtStats {
+    uint32_t reads;
+    uint32_t failures;
+    uint32_t readUsLast;
+    uint32_t readUsMax;
+};
+
+class DhtService {
+public:
+    void begin(uint8_t pin);
+    // Dipanggil periodik dari scheduler; membaca sensor hanya jika sudah jatuh tempo
+    void tick();
+    DhtReading latest() const;
+    // Waktu (millis) pembacaan berikutnya, untuk perencanaan idle
+    uint32_t nextSampleMs() const { return nextSampleMs_; }
+
+    const DhtStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    DHTesp sensor_;
+    DhtReading reading_ = {NAN, NAN, 0, false};
+    uint32_t nextSampleMs_ = 0;
+    uint8_t retries_ = 0;
+    DhtStats stats_ = {};
+};
+
+extern DhtService dhtService;
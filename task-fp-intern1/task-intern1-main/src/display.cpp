@@ -0,0 +1,267 @@
+#include "display.h"
+
+#include "fixed_print.h"
+#include "profiler.h"
+
+Display::Display(Adafruit_SSD1306& oled, I2CBus& bus, uint8_t address)
+    : oled_(oled), bus_(bus), address_(address) {
+    memset(front_, 0, sizeof(front_));
+    memset(shadow_, 0, sizeof(shadow_));
+    clearDirty(dirty_);
+    clearDirty(frontDirty_);
+}
+
+void Display::begin() {
+    device_ = bus_.addDevice("ssd1306", address_, DISPLAY_I2C_CLOCK);
+    fullRefresh_ = true;
+    lastFrameMs_ = millis() - DISPLAY_MIN_FRAME_MS;  // Frame pertama tidak ditahan pembatas
+    firstFrameUs_.store(0);
+    resetStats();
+#if DISPLAY_ASYNC
+    if (task_ == nullptr) {
+        xTaskCreatePinnedToCore(taskEntry, "display", 4096, this, DISPLAY_TASK_PRIORITY, &task_,
+                                DISPLAY_TASK_CORE);
+    }
+#endif
+}
+
+bool Display::beginFrame() {
+    uint32_t now = millis();
+    if (now - lastFrameMs_ < DISPLAY_MIN_FRAME_MS) {
+        return false;
+    }
+    lastFrameMs_ = now;
+    frameStartUs_ = micros();
+    frameOpen_ = true;
+    return true;
+}
+
+void Display::flush() {
+    PROFILE_SCOPE("display.flush");
+    markDirty(0, 0, WIDTH, PAGES * 8);
+    flushDirty();
+}
+
+void Display::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+    int x0 = x < 0 ? 0 : x;
+    int x1 = x + w > WIDTH ? WIDTH - 1 : x + w - 1;
+    int y0 = y < 0 ? 0 : y;
+    int y1 = y + h > PAGES * 8 ? PAGES * 8 - 1 : y + h - 1;
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+    for (int page = y0 / 8; page <= y1 / 8; page++) {
+        DirtySpan& span = dirty_[page];
+        if (span.first > span.last) {
+            span.first = x0;
+            span.last = x1;
+        } else {
+            if (x0 < span.first) span.first = x0;
+            if (x1 > span.last) span.last = x1;
+        }
+    }
+}
+
+void Display::flushDirty() {
+    closeFrame();
+    bool any = false;
+    for (const DirtySpan& span : dirty_) {
+        any = any || span.first <= span.last;
+    }
+    if (!any) {
+        return;  // Tidak ada yang berubah, panel tidak perlu disentuh
+    }
+    if (pending_) {
+        stats_.framesDropped++;  // Frame tertunda sebelumnya digantikan frame ini
+    }
+    pending_ = true;
+    poll();
+}
+
+void Display::closeFrame() {
+    if (frameOpen_) {
+        uint32_t elapsed = micros() - frameStartUs_;
+        stats_.renderUsLast = elapsed;
+        if (elapsed > stats_.renderUsMax) stats_.renderUsMax = elapsed;
+        frameOpen_ = false;
+    }
+}
+
+void Display::clearDirty(DirtySpan* spans) {
+    for (int page = 0; page < PAGES; page++) {
+        spans[page] = {WIDTH - 1, 0};
+    }
+}
+
+void Display::poll() {
+    if (pending_ && publish()) {
+        pending_ = false;
+    }
+}
+
+// Salin back buffer ke front buffer jika task transfer sedang tidak memakainya
+bool Display::publish() {
+    if (state_.load(std::memory_order_acquire) != FRONT_IDLE) {
+        return false;
+    }
+    // Hanya area kotor yang disalin; sisa front_ sudah sama dengan frame sebelumnya
+    const uint8_t* back = oled_.getBuffer();
+    for (int page = 0; page < PAGES; page++) {
+        const DirtySpan& span = dirty_[page];
+        if (span.first <= span.last) {
+            size_t offset = page * WIDTH + span.first;
+            memcpy(front_ + offset, back + offset, span.last - span.first + 1);
+        }
+        frontDirty_[page] = span;
+    }
+    clearDirty(dirty_);
+    state_.store(FRONT_READY, std::memory_order_release);
+#if DISPLAY_ASYNC
+    xTaskNotifyGive(task_);
+#else
+    transfer();
+#endif
+    return true;
+}
+
+#if DISPLAY_ASYNC
+void Display::taskEntry(void* arg) {
+    Display* self = static_cast<Display*>(arg);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->transfer();
+    }
+}
+#endif
+
+void Display::transfer() {
+    PROFILE_SCOPE("display.transfer");
+    uint8_t expected = FRONT_READY;
+    if (!state_.compare_exchange_strong(expected, FRONT_SENDING, std::memory_order_acquire)) {
+        return;
+    }
+    if (resetRequested_.exchange(false, std::memory_order_acquire)) {
+        resetTransferStats();
+    }
+
+    uint32_t start = micros();
+    bool full = fullRefresh_.exchange(false);
+    uint32_t bytes = 0;
+    uint32_t spans = 0;
+    bool failed = false;
+
+    for (uint8_t page = 0; page < PAGES; page++) {
+        const uint8_t* row = front_ + page * WIDTH;
+        uint8_t* shadowRow = shadow_ + page * WIDTH;
+
+        // Di luar rentang kotor front_ tidak berubah sejak transfer sebelumnya
+        int col = full ? 0 : frontDirty_[page].first;
+        int end = full ? WIDTH : frontDirty_[page].last + 1;
+        while (col < end) {
+            if (!full && row[col] == shadowRow[col]) {
+                col++;
+                continue;
+            }
+            // Awal rentang yang berubah, perpanjang selama celahnya kecil
+            int first = col;
+            int last = col;
+            int gap = 0;
+            for (col = col + 1; col < end; col++) {
+                if (full || row[col] != shadowRow[col]) {
+                    last = col;
+                    gap = 0;
+                } else if (++gap > SPAN_MERGE_GAP) {
+                    break;
+                }
+            }
+            if (sendSpan(page, first, last, row, bytes)) {
+                memcpy(shadowRow + first, row + first, last - first + 1);
+            } else {
+                failed = true;  // Isi panel tidak pasti, shadow tidak ikut diperbarui
+            }
+            spans++;
+            col = last + 1;
+        }
+    }
+
+    if (failed) {
+        stats_.transferErrors++;
+        fullRefresh_ = true;
+    }
+    uint32_t elapsed = micros() - start;
+    stats_.frames++;
+    framesSent_.fetch_add(1, std::memory_order_release);
+    if (firstFrameUs_.load(std::memory_order_relaxed) == 0) {
+        firstFrameUs_.store(micros(), std::memory_order_release);
+    }
+    stats_.bytesLastFrame = bytes;
+    stats_.bytesTotal += bytes;
+    stats_.spansLastFrame = spans;
+    stats_.transferUsLast = elapsed;
+    if (elapsed > stats_.transferUsMax) stats_.transferUsMax = elapsed;
+
+    state_.store(FRONT_IDLE, std::memory_order_release);
+}
+
+// Kirim satu rentang kolom dari satu page; bytes ditambah jumlah byte di bus
+bool Display::sendSpan(uint8_t page, uint8_t first, uint8_t last, const uint8_t* row, uint32_t& bytes) {
+    // Co = 0, D/C = 0: deretan perintah
+    const uint8_t window[] = {0x00, SSD1306_COLUMNADDR, first, last, SSD1306_PAGEADDR, page, page};
+    if (!bus_.write(device_, window, sizeof(window), I2C_PRIORITY_BULK)) {
+        return false;
+    }
+    bytes += sizeof(window);
+
+    // Control byte 0x40 (data) diulang di setiap chunk; alamat kolom panel terus berjalan
+    size_t sent = bus_.writeChunked(device_, 0x40, row + first, last - first + 1, I2C_PRIORITY_BULK);
+    bytes += sent;
+    return sent > 0;
+}
+
+bool Display::setPower(DisplayPower power) {
+    if (power == power_) {
+        return true;
+    }
+    // Co = 0, D/C = 0: deretan perintah, sela di antara chunk frame tidak mengubah alamat kolom
+    const uint8_t commands[] = {0x00, SSD1306_SETCONTRAST, (uint8_t)(power == DISPLAY_DIM ? 0 : DISPLAY_CONTRAST),
+                                (uint8_t)(power == DISPLAY_OFF ? SSD1306_DISPLAYOFF : SSD1306_DISPLAYON)};
+    if (!bus_.write(device_, commands, sizeof(commands), I2C_PRIORITY_CONTROL)) {
+        return false;
+    }
+    power_ = power;
+    return true;
+}
+
+void Display::report(Print& out) const {
+    uint32_t avg = stats_.frames ? stats_.bytesTotal / stats_.frames : 0;
+    fixedPrintf(out, "display: %lu frames (%lu dropped), avg %lu B/frame, last %lu B (%lu spans)\n",
+                (unsigned long)stats_.frames, (unsigned long)stats_.framesDropped, (unsigned long)avg,
+                (unsigned long)stats_.bytesLastFrame, (unsigned long)stats_.spansLastFrame);
+    fixedPrintf(out, "  render last %lu us, max %lu us; transfer last %lu us, max %lu us, %lu errors\n",
+                (unsigned long)stats_.renderUsLast, (unsigned long)stats_.renderUsMax,
+                (unsigned long)stats_.transferUsLast, (unsigned long)stats_.transferUsMax,
+                (unsigned long)stats_.transferErrors);
+}
+
+void Display::resetStats() {
+    stats_.framesDropped = 0;
+    stats_.renderUsLast = 0;
+    stats_.renderUsMax = 0;
+    // Hanya UI yang memindahkan IDLE ke READY, jadi saat IDLE task transfer tidak menyentuh stats_
+    if (state_.load(std::memory_order_acquire) == FRONT_IDLE) {
+        resetTransferStats();
+    } else {
+        resetRequested_.store(true, std::memory_order_release);
+    }
+}
+
+void Display::resetTransferStats() {
+    resetRequested_.store(false, std::memory_order_relaxed);
+    stats_.frames = 0;
+    stats_.bytesLastFrame = 0;
+    stats_.bytesTotal = 0;
+    stats_.spansLastFrame = 0;
+    stats_.transferUsLast = 0;
+    stats_.transferUsMax = 0;
+    stats_.transferErrors = 0;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+
+#include <atomic>
+
+#include "i2c_bus.h"
+
+// Lapisan display di atas Adafruit_SSD1306.
+// UI menggambar ke framebuffer oled (back buffer). flush() menyalin frame yang
+// selesai ke front buffer, lalu task transfer di core lain membandingkannya
+// dengan salinan yang terakhir dikirim (shadow) dan hanya mengirim page 8-baris
+// dan rentang kolom yang berubah. Rentang dikirim lewat i2cBus sebagai chunk
+// berprioritas rendah, jadi baca RTC bisa menyela di antara chunk.
+// Layar yang digambar inkremental (mis. TextLayer) menandai area yang diubah
+// dengan markDirty() lalu memanggil flushDirty(): hanya area itu yang disalin
+// dan dibandingkan, bukan seluruh 1 KB framebuffer.
+
+// Transfer asinkron hanya di ESP32 (FreeRTOS); build lain transfer langsung
+#ifndef DISPLAY_ASYNC
+#ifdef ESP_PLATFORM
+#define DISPLAY_ASYNC 1
+#else
+#define DISPLAY_ASYNC 0
+#endif
+#endif
+
+#define DISPLAY_I2C_CLOCK 400000UL       // Fast mode, maksimum datasheet SSD1306
+#define DISPLAY_MIN_FRAME_MS 33          // Batas frame rate, sekitar 30 fps
+#define DISPLAY_TASK_CORE 0              // Loop Arduino berjalan di core 1
+#define DISPLAY_TASK_PRIORITY 2
+#define DISPLAY_CONTRAST 0xCF            // Kontras bawaan Adafruit untuk SSD1306_SWITCHCAPVCC
+
+// Daya panel. Redup = kontras minimum; mati = display off (charge pump mati,
+// isi GDDRAM tetap), jadi frame berikutnya tidak perlu dikirim penuh.
+enum DisplayPower : uint8_t {
+    DISPLAY_ON,
+    DISPLAY_DIM,
+    DISPLAY_OFF,
+};
+
+// Field render/dropped ditulis UI, sisanya oleh task transfer
+struct DisplayStats {
+    uint32_t frames;           // Frame yang sampai ke panel
+    uint32_t framesDropped;    // Frame yang tertimpa frame lebih baru sebelum terkirim
+    uint32_t bytesLastFrame;   // Byte yang dikirim ke bus pada transfer terakhir
+    uint32_t bytesTotal;
+    uint32_t spansLastFrame;   // Jumlah rentang kolom yang dikirim
+    uint32_t renderUsLast;     // beginFrame() sampai flush()
+    uint32_t renderUsMax;
+    uint32_t transferUsLast;   // Diff + transfer I2C
+    uint32_t transferUsMax;
+    uint32_t transferErrors;   // Transfer gagal, frame berikutnya dikirim penuh
+};
+
+class Display {
+public:
+    static const int WIDTH = 128;
+    static const int PAGES = 8;
+    static const int BUFFER_SIZE = WIDTH * PAGES;
+    // Rentang yang terpisah kurang dari ini digabung, lebih murah daripada
+    // header perintah COLUMNADDR/PAGEADDR baru (7 byte + alamat)
+    static const int SPAN_MERGE_GAP = 8;
+
+    Display(Adafruit_SSD1306& oled, I2CBus& bus, uint8_t address);
+
+    // Dipanggil setelah oled.begin(); mendaftarkan panel ke bus, menjalankan
+    // task transfer, flush berikutnya mengirim layar penuh
+    void begin();
+    int device() const { return device_; }
+    // Pembatas frame rate: false jika frame berikutnya belum boleh digambar
+    bool beginFrame();
+    // Frame di back buffer selesai; serahkan ke task transfer
+    void flush();
+    // Tandai area back buffer yang diubah sejak flush terakhir
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+    // Seperti flush(), tapi hanya area yang ditandai; tanpa area kotor tidak ada frame
+    void flushDirty();
+    // Kirim ulang frame yang tertunda karena transfer sebelumnya masih berjalan
+    void poll();
+    void invalidate() { fullRefresh_ = true; }
+    bool isIdle() const { return state_.load() == FRONT_IDLE && !pending_; }
+    // Perintah kontras dan on/off langsung ke panel; false jika bus gagal
+    bool setPower(DisplayPower power);
+    DisplayPower power() const { return power_; }
+    // micros() saat frame pertama sejak begin() selesai dikirim ke panel, 0 jika belum
+    uint32_t firstFrameUs() const { return firstFrameUs_.load(std::memory_order_acquire); }
+    // Frame yang sampai ke panel sejak boot; tidak ikut resetStats(), aman dibaca dari core lain
+    uint32_t framesSent() const { return framesSent_.load(std::memory_order_acquire); }
+
+    const DisplayStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    // Field UI langsung dikosongkan; field transfer dikosongkan task transfer
+    // sendiri (langsung jika sedang idle), jadi kedua core tidak menulis bersamaan
+    void resetStats();
+
+private:
+    enum FrontState : uint8_t { FRONT_IDLE, FRONT_READY, FRONT_SENDING };
+
+    // Rentang kolom kotor per page, kosong jika first > last
+    struct DirtySpan {
+        uint8_t first;
+        uint8_t last;
+    };
+
+    bool publish();
+    void closeFrame();
+    static void clearDirty(DirtySpan* spans);
+    void transfer();
+    void resetTransferStats();
+    bool sendSpan(uint8_t page, uint8_t first, uint8_t last, const uint8_t* row, uint32_t& bytes);
+#if DISPLAY_ASYNC
+    static void taskEntry(void* arg);
+    TaskHandle_t task_ = nullptr;
+#endif
+
+    Adafruit_SSD1306& oled_;
+    I2CBus& bus_;
+    uint8_t address_;
+    int device_ = -1;
+    uint8_t front_[BUFFER_SIZE];
+    uint8_t shadow_[BUFFER_SIZE];
+    // Handshake lock-free antara UI (produsen) dan task transfer (konsumen):
+    // front_ hanya ditulis UI saat IDLE dan hanya dibaca task saat READY/SENDING
+    std::atomic<uint8_t> state_{FRONT_IDLE};
+    std::atomic<bool> fullRefresh_{true};
+    DirtySpan dirty_[PAGES];       // Dikumpulkan UI sampai frame berhasil diserahkan
+    DirtySpan frontDirty_[PAGES];  // Area frame di front_, dibaca task transfer
+    bool pending_ = false;
+    bool frameOpen_ = false;
+    DisplayPower power_ = DISPLAY_ON;
+    uint32_t frameStartUs_ = 0;
+    uint32_t lastFrameMs_ = 0;
+    std::atomic<uint32_t> firstFrameUs_{0};
+    std::atomic<uint32_t> framesSent_{0};
+    std::atomic<bool> resetRequested_{false};
+    DisplayStats stats_ = {};
+};
+
+extern Display screen;
@@ -0,0 +1,18 @@
+#include "fixed_print.h"
+
+#include <stdarg.h>
+
+size_t fixedPrintf(Print& out, const char* format, ...) {
+    char buffer[FIXED_PRINT_MAX];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    if ((size_t)length >= sizeof(buffer)) {
+        length = sizeof(buffer) - 1;
+    }
+    return out.write((const uint8_t*)buffer, length);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <Arduino.h>
+
+// printf ke Print tanpa heap. Print::printf di Arduino-ESP32 memformat ke
+// buffer stack 64 byte dan memakai malloc() untuk teks yang lebih panjang,
+// jadi baris laporan yang panjang dicetak lewat fixedPrintf().
+// Teks lebih panjang dari FIXED_PRINT_MAX dipotong.
+
+#define FIXED_PRINT_MAX 160
+
+size_t fixedPrintf(Print& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
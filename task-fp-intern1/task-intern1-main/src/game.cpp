@@ -0,0 +1,285 @@
+#include "game.h"
+
+#include "fixed_print.h"
+#include "profiler.h"
+
+// ---- Sprite, dipak saat compile ----
+
+static constexpr sprite::Bitmap<9, 6> SHIP(
+    "....#...."
+    "...###..."
+    "...#.#..."
+    ".#######."
+    "#########"
+    "##.#.#.##");
+
+static constexpr sprite::Bitmap<7, 7> ROCK(
+    "..###.."
+    ".#####."
+    "##.####"
+    "#####.#"
+    "####.##"
+    ".#####."
+    "..###..");
+
+// Digit skor 3x5 dalam tile 4x8 (satu page), baris 1..5
+#define GAME_DIGIT(r1, r2, r3, r4, r5) sprite::Bitmap<4, 8>("...." r1 "." r2 "." r3 "." r4 "." r5 "." "........")
+static constexpr sprite::Bitmap<4, 8> DIGITS[10] = {
+    GAME_DIGIT("###", "#.#", "#.#", "#.#", "###"), GAME_DIGIT(".#.", "##.", ".#.", ".#.", "###"),
+    GAME_DIGIT("###", "..#", "###", "#..", "###"), GAME_DIGIT("###", "..#", "###", "..#", "###"),
+    GAME_DIGIT("#.#", "#.#", "###", "..#", "..#"), GAME_DIGIT("###", "#..", "###", "..#", "###"),
+    GAME_DIGIT("###", "#..", "###", "#.#", "###"), GAME_DIGIT("###", "..#", "..#", "..#", "..#"),
+    GAME_DIGIT("###", "#.#", "###", "#.#", "###"), GAME_DIGIT("###", "#.#", "###", "..#", "###"),
+};
+static constexpr sprite::Bitmap<4, 8> BLANK_DIGIT = GAME_DIGIT("...", "...", "...", "...", "...");
+
+static_assert(SHIP.column[0][4] == 0x1B, "kolom tengah kapal: baris 0, 1, 3, 4");
+static_assert(DIGITS[1].column[0][1] == 0x3E, "digit 1: batang baris 1..5");
+
+static const int16_t SHIP_Y = Display::PAGES * 8 - 6;
+static const int16_t SHIP_X_MAX = Display::WIDTH - 9;
+static const uint8_t SCORE_DIGITS = 5;
+static const int16_t SCORE_X = Display::WIDTH - SCORE_DIGITS * 4;
+
+Game::Game(Adafruit_SSD1306& oled, Display& display) : oled_(oled), display_(display) { reset(1); }
+
+void Game::reset(uint32_t seed) {
+    random_ = seed | 1;
+    shipXQ8_ = (int32_t)(SHIP_X_MAX / 2) << 8;
+    for (Rock& rock : rocks_) {
+        rock = {};
+    }
+    spawnIn_ = GAME_SPAWN_STEPS / 2;
+    score_ = 0;
+    state_ = GAME_READY;
+    timing_ = false;
+    redraw_ = true;
+}
+
+void Game::action() {
+    switch (state_) {
+        case GAME_OVER:
+            reset(nextRandom());
+            // fallthrough
+        case GAME_READY:
+        case GAME_PAUSED:
+            state_ = GAME_PLAYING;
+            accumulatorMs_ = 0;
+            break;
+        case GAME_PLAYING:
+            state_ = GAME_PAUSED;
+            break;
+    }
+    timing_ = false;
+    redraw_ = true;
+}
+
+void Game::invalidate() {
+    if (state_ == GAME_PLAYING) {
+        state_ = GAME_PAUSED;
+        timing_ = false;
+    }
+    redraw_ = true;
+}
+
+uint32_t Game::nextRandom() {
+    random_ = random_ * 1664525u + 1013904223u;
+    return random_ >> 16;
+}
+
+void Game::spawn() {
+    for (Rock& rock : rocks_) {
+        if (!rock.active) {
+            rock.active = true;
+            rock.x = (int16_t)(nextRandom() % (Display::WIDTH - ROCK.ref().w + 1));
+            rock.yQ8 = (int32_t)GAME_TOP << 8;  // Di bawah garis skor, page 0 tidak pernah ditimpa
+            return;
+        }
+    }
+}
+
+void Game::step() {
+    shipXQ8_ += direction_ * GAME_SHIP_SPEED_Q8;
+    if (shipXQ8_ < 0) shipXQ8_ = 0;
+    if (shipXQ8_ > (int32_t)SHIP_X_MAX << 8) shipXQ8_ = (int32_t)SHIP_X_MAX << 8;
+
+    // Kotak tabrakan sedikit lebih kecil dari gambar, sudut yang hanya bersinggungan tidak dihitung
+    int16_t shipX = (int16_t)(shipXQ8_ >> 8);
+    ui::Rect ship = {(int16_t)(shipX + 1), (int16_t)(SHIP_Y + 1), 7, 5};
+    int32_t speed = GAME_ROCK_SPEED_Q8 + score_ * 4;
+    if (speed > GAME_ROCK_SPEED_MAX_Q8) speed = GAME_ROCK_SPEED_MAX_Q8;
+    for (Rock& rock : rocks_) {
+        if (!rock.active) continue;
+        rock.yQ8 += speed;
+        int16_t y = (int16_t)(rock.yQ8 >> 8);
+        if (y >= Display::PAGES * 8) {
+            rock.active = false;
+            score_++;
+            continue;
+        }
+        if (ship.intersects({(int16_t)(rock.x + 1), (int16_t)(y + 1), 5, 5})) {
+            state_ = GAME_OVER;
+            if (score_ > best_) best_ = score_;
+            timing_ = false;
+            redraw_ = true;
+            return;
+        }
+    }
+
+    if (spawnIn_ == 0) {
+        spawn();
+        int32_t gap = GAME_SPAWN_STEPS - score_;
+        spawnIn_ = gap > GAME_SPAWN_STEPS_MIN ? gap : GAME_SPAWN_STEPS_MIN;
+    } else {
+        spawnIn_--;
+    }
+}
+
+bool Game::frame() {
+    PROFILE_SCOPE("mode.game");
+    if (state_ != GAME_PLAYING && !redraw_) {
+        return false;
+    }
+    if (!display_.beginFrame()) {
+        return false;
+    }
+    uint32_t start = micros();
+    if (state_ == GAME_PLAYING) {
+        uint32_t now = millis();
+        if (timing_) {
+            uint32_t interval = now - lastFrameMs_;
+            if (interval > stats_.intervalMsMax) stats_.intervalMsMax = interval;
+            stats_.intervals++;
+            stats_.intervalMsTotal += interval;
+            accumulatorMs_ += interval;
+        }
+        lastFrameMs_ = now;
+        timing_ = true;
+
+        uint8_t steps = 0;
+        while (accumulatorMs_ >= GAME_STEP_MS && state_ == GAME_PLAYING) {
+            if (steps == GAME_MAX_STEPS) {
+                stats_.stepsDropped += accumulatorMs_ / GAME_STEP_MS;
+                accumulatorMs_ %= GAME_STEP_MS;
+                break;
+            }
+            step();
+            accumulatorMs_ -= GAME_STEP_MS;
+            steps++;
+        }
+        stats_.steps += steps;
+        stats_.frames++;
+    }
+    uint32_t updated = micros();
+    if (redraw_) {
+        drawFull();
+        display_.flush();
+    } else {
+        drawMoving();
+        display_.flushDirty();
+    }
+    uint32_t end = micros();
+    if (updated - start > stats_.updateUsMax) stats_.updateUsMax = updated - start;
+    if (end - updated > stats_.drawUsMax) stats_.drawUsMax = end - updated;
+    stats_.drawUsTotal += end - updated;
+    return true;
+}
+
+// Layar penuh: garis skor, teks status dan semua sprite di posisinya sekarang
+void Game::drawFull() {
+    oled_.clearDisplay();
+    oled_.drawFastHLine(0, GAME_TOP - 1, Display::WIDTH, WHITE);
+    oled_.setTextSize(1);
+    oled_.setTextColor(WHITE);
+    oled_.setCursor(0, 0);
+    oled_.print(F("Best "));
+    oled_.print(best_);
+    if (state_ != GAME_PLAYING) {
+        const char* title = state_ == GAME_READY ? "Dodge the rocks" : state_ == GAME_PAUSED ? "Paused" : "Game over";
+        oled_.setCursor((Display::WIDTH - (int16_t)strlen(title) * 6) / 2, 24);
+        oled_.print(title);
+        oled_.setCursor(22, 36);
+        oled_.print(state_ == GAME_PAUSED ? F("Green: resume") : F("Green: play"));
+    }
+    drawScore();
+
+    uint8_t* buffer = oled_.getBuffer();
+    shipDrawnX_ = (int16_t)(shipXQ8_ >> 8);
+    sprite::blit(buffer, SHIP.ref(), shipDrawnX_, SHIP_Y, sprite::BLIT_SET);
+    for (Rock& rock : rocks_) {
+        rock.drawn = rock.active;
+        rock.drawnY = (int16_t)(rock.yQ8 >> 8);
+        if (rock.active) {
+            sprite::blit(buffer, ROCK.ref(), rock.x, rock.drawnY, sprite::BLIT_SET);
+        }
+    }
+    redraw_ = false;
+}
+
+// Hapus semua sprite yang pindah dulu baru gambar semuanya, jadi sprite yang
+// bertumpuk tidak saling menghapus. Hanya posisi lama dan baru yang ditandai kotor.
+void Game::drawMoving() {
+    uint8_t* buffer = oled_.getBuffer();
+    int16_t shipX = (int16_t)(shipXQ8_ >> 8);
+    bool shipMoved = shipX != shipDrawnX_;
+    if (shipMoved) {
+        sprite::blit(buffer, SHIP.ref(), shipDrawnX_, SHIP_Y, sprite::BLIT_CLEAR);
+        display_.markDirty(shipDrawnX_, SHIP_Y, SHIP.ref().w, SHIP.ref().h);
+    }
+    for (Rock& rock : rocks_) {
+        if (rock.drawn && (!rock.active || rock.drawnY != (int16_t)(rock.yQ8 >> 8))) {
+            sprite::blit(buffer, ROCK.ref(), rock.x, rock.drawnY, sprite::BLIT_CLEAR);
+            display_.markDirty(rock.x, rock.drawnY, ROCK.ref().w, ROCK.ref().h);
+        }
+    }
+
+    sprite::blit(buffer, SHIP.ref(), shipX, SHIP_Y, sprite::BLIT_SET);
+    if (shipMoved) {
+        display_.markDirty(shipX, SHIP_Y, SHIP.ref().w, SHIP.ref().h);
+        shipDrawnX_ = shipX;
+    }
+    for (Rock& rock : rocks_) {
+        if (!rock.active) {
+            rock.drawn = false;
+            continue;
+        }
+        int16_t y = (int16_t)(rock.yQ8 >> 8);
+        sprite::blit(buffer, ROCK.ref(), rock.x, y, sprite::BLIT_SET);
+        if (!rock.drawn || rock.drawnY != y) {
+            display_.markDirty(rock.x, y, ROCK.ref().w, ROCK.ref().h);
+        }
+        rock.drawn = true;
+        rock.drawnY = y;
+    }
+    if (score_ != scoreDrawn_) {
+        drawScore();
+        display_.markDirty(SCORE_X, 0, SCORE_DIGITS * 4, 8);
+    }
+}
+
+// Skor rata kanan di page 0 dari tile digit, tanpa nol di depan
+void Game::drawScore() {
+    uint8_t* buffer = oled_.getBuffer();
+    uint16_t value = score_;
+    for (int8_t i = SCORE_DIGITS - 1; i >= 0; i--) {
+        bool blank = value == 0 && i < SCORE_DIGITS - 1;
+        sprite::tile(buffer, blank ? BLANK_DIGIT.ref() : DIGITS[value % 10].ref(), SCORE_X + i * 4, 0);
+        value /= 10;
+    }
+    scoreDrawn_ = score_;
+}
+
+void Game::report(Print& out) const {
+    uint32_t tenthFps = stats_.intervalMsTotal ? stats_.intervals * 10000 / stats_.intervalMsTotal : 0;
+    uint32_t drawUsAvg = stats_.frames ? stats_.drawUsTotal / stats_.frames : 0;
+    fixedPrintf(out, "game: %lu frames, %lu.%lu fps (interval max %lu ms), %lu steps (%lu dropped), "
+                "update max %lu us, draw avg %lu max %lu us of %lu us\n",
+                (unsigned long)stats_.frames, (unsigned long)(tenthFps / 10), (unsigned long)(tenthFps % 10),
+                (unsigned long)stats_.intervalMsMax, (unsigned long)stats_.steps,
+                (unsigned long)stats_.stepsDropped, (unsigned long)stats_.updateUsMax, (unsigned long)drawUsAvg,
+                (unsigned long)stats_.drawUsMax, (unsigned long)GAME_FRAME_MS * 1000);
+}
+
+void Game::resetStats() {
+    stats_ = {};
+}
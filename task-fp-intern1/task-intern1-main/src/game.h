@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+
+#include "display.h"
+#include "sprite.h"
+
+// Mode game: hindari batu yang jatuh. Merah/biru (ditahan) menggeser kapal,
+// hijau memulai, menjeda dan mengulang permainan.
+// Fisika berjalan dengan langkah tetap GAME_STEP_MS dari akumulator waktu,
+// jadi kecepatan permainan tidak tergantung frame rate. Setiap frame hanya
+// sprite yang bergerak yang dihapus di posisi lama dan di-blit di posisi baru
+// (sprite.h), lalu hanya area itu yang dikirim ke panel (markDirty/flushDirty).
+// Layar penuh (teks status lewat Adafruit_GFX) hanya saat state berubah.
+
+#define GAME_FRAME_MS DISPLAY_MIN_FRAME_MS  // Periode task render selama game, sekitar 30 fps
+#define GAME_STEP_MS 11                     // Langkah fisika, tiga per frame
+#define GAME_MAX_STEPS 6                    // Per frame; sisa waktu yang tertinggal dibuang
+#define GAME_ROCKS 6
+#define GAME_TOP 8                          // Page 0 untuk skor
+#define GAME_SHIP_SPEED_Q8 192              // 0.75 piksel per langkah
+#define GAME_ROCK_SPEED_Q8 64               // Kecepatan awal batu, naik dengan skor
+#define GAME_ROCK_SPEED_MAX_Q8 256
+#define GAME_SPAWN_STEPS 45                 // Jarak antar batu awal, turun dengan skor
+#define GAME_SPAWN_STEPS_MIN 14
+
+enum GameState : uint8_t {
+    GAME_READY,    // Menunggu tombol hijau
+    GAME_PLAYING,
+    GAME_PAUSED,   // Hijau atau layar ditimpa (alarm, countdown selesai)
+    GAME_OVER,
+};
+
+struct GameStats {
+    uint32_t frames;         // Frame selama bermain
+    uint32_t steps;
+    uint32_t stepsDropped;   // Tertinggal lebih dari GAME_MAX_STEPS per frame
+    uint32_t intervals;      // Jarak antar frame yang diukur (frame pertama setelah mulai/jeda tidak)
+    uint32_t intervalMsTotal;
+    uint32_t intervalMsMax;  // Jarak frame terlama, target GAME_FRAME_MS
+    uint32_t updateUsMax;    // Semua langkah fisika dalam satu frame
+    uint32_t drawUsMax;      // Hapus, blit dan tandai area kotor
+    uint32_t drawUsTotal;
+};
+
+class Game {
+public:
+    Game(Adafruit_SSD1306& oled, Display& display);
+
+    // Permainan baru (masuk dari menu); seed untuk posisi batu
+    void reset(uint32_t seed);
+    // Tombol hijau: mulai, jeda/lanjut, main lagi
+    void action();
+    // Arah kapal dari tombol yang ditahan: -1 kiri, 0 diam, 1 kanan
+    void steer(int8_t direction) { direction_ = direction; }
+    // Framebuffer berisi layar lain: frame berikutnya digambar penuh, permainan dijeda
+    void invalidate();
+    // Dari task render: jalankan langkah yang jatuh tempo lalu gambar selisihnya.
+    // Return false jika tidak ada frame (tidak bermain atau ditahan frame pacing)
+    bool frame();
+
+    GameState state() const { return state_; }
+    uint16_t score() const { return score_; }
+    uint16_t best() const { return best_; }
+
+    const GameStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    struct Rock {
+        int16_t x;
+        int32_t yQ8;
+        int16_t drawnY;
+        bool active;
+        bool drawn;
+    };
+
+    void step();
+    void spawn();
+    uint32_t nextRandom();
+    void drawFull();
+    void drawMoving();
+    void drawScore();
+
+    Adafruit_SSD1306& oled_;
+    Display& display_;
+    GameState state_ = GAME_READY;
+    bool redraw_ = true;
+    int8_t direction_ = 0;
+
+    int32_t shipXQ8_ = 0;
+    int16_t shipDrawnX_ = 0;
+    Rock rocks_[GAME_ROCKS] = {};
+    uint16_t spawnIn_ = 0;
+    uint16_t score_ = 0;
+    uint16_t scoreDrawn_ = 0;
+    uint16_t best_ = 0;
+    uint32_t random_ = 1;
+
+    uint32_t accumulatorMs_ = 0;
+    uint32_t lastFrameMs_ = 0;
+    bool timing_ = false;  // Frame sebelumnya juga bermain; jaraknya ikut diukur
+    uint32_t windowStartMs_ = 0;
+    GameStats stats_ = {};
+};
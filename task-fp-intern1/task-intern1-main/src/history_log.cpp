@@ -0,0 +1,336 @@
+#include "history_log.h"
+
+#include "cobs.h"
+#include "fixed_print.h"
+
+HistoryLog historyLog;
+
+static const uint32_t HISTORY_SECTOR_MAGIC = 0x474F4C48;  // "HLOG"
+static const uint16_t HISTORY_PAGE_MAGIC = 0x5048;        // "HP"
+static const uint16_t HISTORY_VERSION = 1;
+static const uint8_t HISTORY_FLAG_DHT_VALID = 0x01;
+static const size_t HISTORY_MAX_DELTA = 20;  // dt + 3 delta, varint 5 byte
+
+static size_t putVarint(uint8_t* out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static bool getVarint(const uint8_t* in, size_t length, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35 && pos < length; shift += 7) {
+        uint8_t b = in[pos++];
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t zigzag(int32_t value) { return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); }
+static int32_t unzigzag(uint32_t value) { return (int32_t)(value >> 1) ^ -(int32_t)(value & 1); }
+
+static uint16_t sectorCrc(const void* header, size_t length) {
+    return crc16(static_cast<const uint8_t*>(header), length - sizeof(uint16_t));
+}
+
+bool HistoryLog::begin() {
+    partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)HISTORY_PARTITION_SUBTYPE,
+                                          HISTORY_PARTITION_LABEL);
+    if (!partition_) {
+        return false;
+    }
+    sectorCount_ = partition_->size / HISTORY_SECTOR_SIZE;
+    if (sectorCount_ > HISTORY_MAX_SECTORS) sectorCount_ = HISTORY_MAX_SECTORS;
+
+    // Sektor kepala = header valid dengan nomor urut tertinggi
+    int head = -1;
+    uint32_t headSeq = 0;
+    for (uint16_t s = 0; s < sectorCount_; s++) {
+        SectorHeader header;
+        esp_partition_read(partition_, sectorOffset(s), &header, sizeof(header));
+        bool valid = header.magic == HISTORY_SECTOR_MAGIC && header.version == HISTORY_VERSION &&
+                     header.crc == sectorCrc(&header, sizeof(header));
+        sectorTime_[s] = valid ? header.firstTime : 0;
+        if (valid && (head < 0 || header.seq > headSeq)) {
+            head = s;
+            headSeq = header.seq;
+        }
+    }
+    if (head < 0) {
+        tailSector_ = 0;
+        usedSectors_ = 0;
+        headSeq_ = 0;
+        pageIndex_ = HISTORY_PAGES_PER_SECTOR;
+        return true;
+    }
+
+    // Mundur dari kepala selama nomor urut bersambung; sektor yang erase-nya
+    // terputus listrik padam menjadi batas ekor
+    uint16_t used = 1;
+    uint16_t tail = head;
+    while (used < sectorCount_) {
+        uint16_t prev = (tail + sectorCount_ - 1) % sectorCount_;
+        SectorHeader header;
+        esp_partition_read(partition_, sectorOffset(prev), &header, sizeof(header));
+        if (header.magic != HISTORY_SECTOR_MAGIC || header.crc != sectorCrc(&header, sizeof(header)) ||
+            header.seq != headSeq - used) {
+            break;
+        }
+        tail = prev;
+        used++;
+    }
+    tailSector_ = tail;
+    usedSectors_ = used;
+    headSeq_ = headSeq;
+
+    // Posisi tulis: page pertama yang masih terhapus di sektor kepala
+    pageIndex_ = HISTORY_PAGES_PER_SECTOR;
+    for (uint8_t p = 0; p < HISTORY_PAGES_PER_SECTOR; p++) {
+        PageHeader header;
+        esp_partition_read(partition_, sectorOffset(head) + (p + 1) * HISTORY_PAGE_SIZE, &header, sizeof(header));
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+        bool erased = true;
+        for (size_t i = 0; i < sizeof(header); i++) {
+            erased = erased && bytes[i] == 0xFF;
+        }
+        if (erased) {
+            pageIndex_ = p;
+            break;
+        }
+    }
+    return true;
+}
+
+void HistoryLog::append(const HistoryRecord& record) {
+    if (!partition_) return;
+    stats_.records++;
+
+    if (pageOpen_ && record.time < last_.time) {
+        stats_.timeJumps++;
+        writePage();
+    }
+    if (!pageOpen_) {
+        startPage(record);
+        return;
+    }
+
+    // Bit 0 dari dt menandai suhu/kelembapan tidak tersedia
+    uint8_t delta[HISTORY_MAX_DELTA];
+    size_t n = putVarint(delta, (record.time - last_.time) << 1 | (record.dhtValid ? 0 : 1));
+    if (record.dhtValid) {
+        n += putVarint(delta + n, zigzag(record.temperatureCenti - last_.temperatureCenti));
+        n += putVarint(delta + n, zigzag(record.humidityDeci - last_.humidityDeci));
+    }
+    n += putVarint(delta + n, zigzag((int32_t)(record.lux - last_.lux)));
+
+    if (page_.header.length + n > PAGE_DATA || page_.header.count == 255) {
+        writePage();
+        startPage(record);
+        return;
+    }
+    memcpy(page_.data + page_.header.length, delta, n);
+    page_.header.length += n;
+    page_.header.count++;
+
+    last_.time = record.time;
+    last_.lux = record.lux;
+    if (record.dhtValid) {
+        last_.temperatureCenti = record.temperatureCenti;
+        last_.humidityDeci = record.humidityDeci;
+    }
+}
+
+void HistoryLog::tick(uint32_t nowMs) {
+    if (pageOpen_ && nowMs - pageOpenedMs_ >= HISTORY_FLUSH_MS) {
+        writePage();
+    }
+}
+
+void HistoryLog::flush() {
+    writePage();
+}
+
+void HistoryLog::startPage(const HistoryRecord& record) {
+    memset(&page_, 0xFF, sizeof(page_));  // Sisa page tetap terhapus di flash
+    page_.header.magic = HISTORY_PAGE_MAGIC;
+    page_.header.length = 0;
+    page_.header.count = 1;
+    page_.header.time = record.time;
+    page_.header.temperatureCenti = record.dhtValid ? record.temperatureCenti : 0;
+    page_.header.humidityDeci = record.dhtValid ? record.humidityDeci : 0;
+    page_.header.lux = record.lux;
+    page_.header.flags = record.dhtValid ? HISTORY_FLAG_DHT_VALID : 0;
+    page_.header.reserved = 0;
+
+    last_ = record;
+    last_.temperatureCenti = page_.header.temperatureCenti;
+    last_.humidityDeci = page_.header.humidityDeci;
+    pageOpen_ = true;
+    pageOpenedMs_ = millis();
+}
+
+bool HistoryLog::writePage() {
+    if (!pageOpen_) return true;
+    pageOpen_ = false;
+
+    uint32_t start = micros();
+    if (pageIndex_ >= HISTORY_PAGES_PER_SECTOR && !openSector(page_.header.time)) {
+        return false;
+    }
+    page_.header.crc = pageCrc(page_);
+    uint16_t head = physicalSector(usedSectors_ - 1);
+    size_t offset = sectorOffset(head) + (pageIndex_ + 1) * HISTORY_PAGE_SIZE;
+    if (esp_partition_write(partition_, offset, &page_, sizeof(page_)) != ESP_OK) {
+        return false;
+    }
+    pageIndex_++;
+    stats_.pagesWritten++;
+    uint32_t elapsed = micros() - start;
+    if (elapsed > stats_.writeUsMax) stats_.writeUsMax = elapsed;
+    return true;
+}
+
+bool HistoryLog::openSector(uint32_t firstTime) {
+    uint16_t next = usedSectors_ == 0 ? tailSector_ : (physicalSector(usedSectors_ - 1) + 1) % sectorCount_;
+    if (usedSectors_ == sectorCount_) {
+        // Ring penuh: sektor tertua dikorbankan
+        tailSector_ = (tailSector_ + 1) % sectorCount_;
+        usedSectors_--;
+    }
+    if (esp_partition_erase_range(partition_, sectorOffset(next), HISTORY_SECTOR_SIZE) != ESP_OK) {
+        return false;
+    }
+    stats_.sectorsErased++;
+
+    SectorHeader header = {HISTORY_SECTOR_MAGIC, headSeq_ + 1, firstTime, HISTORY_VERSION, 0};
+    header.crc = sectorCrc(&header, sizeof(header));
+    if (esp_partition_write(partition_, sectorOffset(next), &header, sizeof(header)) != ESP_OK) {
+        return false;
+    }
+    headSeq_++;
+    usedSectors_++;
+    sectorTime_[next] = firstTime;
+    pageIndex_ = 0;
+    return true;
+}
+
+uint16_t HistoryLog::pageCrc(const Page& page) {
+    uint8_t buffer[HISTORY_PAGE_SIZE];
+    size_t headerLength = sizeof(PageHeader) - sizeof(uint16_t);
+    memcpy(buffer, &page.header, headerLength);
+    memcpy(buffer + headerLength, page.data, page.header.length);
+    return crc16(buffer, headerLength + page.header.length);
+}
+
+size_t HistoryLog::query(uint32_t from, uint32_t to, HistoryVisitor visitor, void* context) {
+    size_t visited = 0;
+    if (!partition_ || from > to) return 0;
+
+    // Sektor logis terakhir yang dimulai sebelum atau tepat di "from"
+    uint16_t lo = 0;
+    uint16_t hi = usedSectors_;
+    while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (sectorTime_[physicalSector(mid)] <= from) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    Page page;
+    for (uint16_t logical = lo > 0 ? lo - 1 : 0; logical < usedSectors_; logical++) {
+        uint16_t sector = physicalSector(logical);
+        if (sectorTime_[sector] > to) {
+            return visited;
+        }
+        for (uint8_t p = 0; p < HISTORY_PAGES_PER_SECTOR; p++) {
+            size_t offset = sectorOffset(sector) + (p + 1) * HISTORY_PAGE_SIZE;
+            esp_partition_read(partition_, offset, &page.header, sizeof(page.header));
+            if (page.header.magic == 0xFFFF && page.header.crc == 0xFFFF) {
+                break;  // Akhir data di sektor ini
+            }
+            if (page.header.magic != HISTORY_PAGE_MAGIC || page.header.length > PAGE_DATA) {
+                stats_.crcErrors++;
+                continue;
+            }
+            esp_partition_read(partition_, offset + sizeof(page.header), page.data, page.header.length);
+            if (page.header.crc != pageCrc(page)) {
+                stats_.crcErrors++;  // Page tertulis setengah saat listrik padam
+                continue;
+            }
+            if (!visitPage(page, from, to, visitor, context, visited)) {
+                return visited;
+            }
+        }
+    }
+
+    if (pageOpen_) {
+        visitPage(page_, from, to, visitor, context, visited);
+    }
+    return visited;
+}
+
+bool HistoryLog::visitPage(const Page& page, uint32_t from, uint32_t to, HistoryVisitor visitor, void* context,
+                           size_t& visited) {
+    const PageHeader& header = page.header;
+    HistoryRecord record = {header.time, header.temperatureCenti, header.humidityDeci, header.lux,
+                            (header.flags & HISTORY_FLAG_DHT_VALID) != 0};
+    size_t pos = 0;
+    for (uint8_t i = 0; i < header.count; i++) {
+        if (i > 0) {
+            uint32_t value;
+            if (!getVarint(page.data, header.length, pos, value)) {
+                return true;
+            }
+            record.time += value >> 1;
+            record.dhtValid = !(value & 1);
+            if (record.dhtValid) {
+                if (!getVarint(page.data, header.length, pos, value)) return true;
+                record.temperatureCenti += unzigzag(value);
+                if (!getVarint(page.data, header.length, pos, value)) return true;
+                record.humidityDeci += unzigzag(value);
+            }
+            if (!getVarint(page.data, header.length, pos, value)) return true;
+            record.lux += unzigzag(value);
+        }
+        if (record.time > to) {
+            return false;
+        }
+        if (record.time >= from) {
+            visited++;
+            if (!visitor(record, context)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+uint32_t HistoryLog::oldestTime() const {
+    if (usedSectors_ > 0) return sectorTime_[tailSector_];
+    return pageOpen_ ? page_.header.time : 0;
+}
+
+void HistoryLog::report(Print& out) const {
+    if (!partition_) {
+        out.println("history: partition not found");
+        return;
+    }
+    fixedPrintf(out, "history: %lu records, %u/%u sectors (seq %lu), %lu pages, %lu erases, write max %lu us, "
+                "%lu crc errors, %lu time jumps\n",
+                (unsigned long)stats_.records, usedSectors_, sectorCount_, (unsigned long)headSeq_,
+                (unsigned long)stats_.pagesWritten, (unsigned long)stats_.sectorsErased,
+                (unsigned long)stats_.writeUsMax, (unsigned long)stats_.crcErrors, (unsigned long)stats_.timeJumps);
+}
+
+void HistoryLog::resetStats() {
+    stats_ = {};
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+// Riwayat sensor di partisi flash mentah "history" (lihat partitions.csv),
+// disusun sebagai log melingkar per sektor 4 KB.
+//
+// Sektor = page 0 berisi header (magic, nomor urut, waktu rekaman pertama,
+// CRC) + 15 page data 256 B. Setiap page data berdiri sendiri: header page
+// menyimpan rekaman pertama utuh, rekaman berikutnya disimpan sebagai delta
+// varint (zigzag) dari rekaman sebelumnya, lalu CRC untuk seluruh page.
+// Rekaman ditampung di RAM dan ditulis satu page sekaligus saat page penuh
+// atau sudah berumur HISTORY_FLUSH_MS, jadi satu sektor hanya di-erase sekali
+// per putaran ring. Listrik padam paling banyak menghilangkan page di RAM;
+// page yang tertulis setengah gagal CRC dan dilewati saat dibaca.
+//
+// Waktu awal tiap sektor di-cache di RAM, jadi query rentang waktu cukup
+// binary search sektor lalu membaca page dari titik itu saja.
+
+#define HISTORY_PARTITION_LABEL "history"
+#define HISTORY_PARTITION_SUBTYPE 0x40
+#define HISTORY_SECTOR_SIZE 4096
+#define HISTORY_PAGE_SIZE 256
+#define HISTORY_PAGES_PER_SECTOR (HISTORY_SECTOR_SIZE / HISTORY_PAGE_SIZE - 1)
+#define HISTORY_MAX_SECTORS 256  // 1 MB; cache waktu sektor 1 KB RAM
+#define HISTORY_PERIOD_MS 10000
+#define HISTORY_FLUSH_MS 300000  // Page belum penuh tetap ditulis setelah 5 menit
+
+struct HistoryRecord {
+    uint32_t time;              // Unixtime dari DS1307 (clockService)
+    int16_t temperatureCenti;   // 0.01 C
+    uint16_t humidityDeci;      // 0.1 %
+    uint32_t lux;
+    bool dhtValid;              // false: suhu/kelembapan tidak tersedia
+};
+
+struct HistoryStats {
+    uint32_t records;
+    uint32_t pagesWritten;
+    uint32_t sectorsErased;
+    uint32_t writeUsMax;     // Tulis page, termasuk erase sektor baru
+    uint32_t crcErrors;      // Page rusak yang dilewati saat query
+    uint32_t timeJumps;      // Jam mundur, rekaman dimulai di page baru
+};
+
+// Dipanggil per rekaman sesuai urutan waktu; return false untuk berhenti
+typedef bool (*HistoryVisitor)(const HistoryRecord& record, void* context);
+
+class HistoryLog {
+public:
+    // Mount partisi dan cari posisi tulis terakhir; false jika partisi tidak ada
+    bool begin();
+    // Tampung satu rekaman; page ditulis ke flash hanya jika sudah penuh
+    void append(const HistoryRecord& record);
+    // Tulis page yang sudah terlalu lama menunggu di RAM
+    void tick(uint32_t nowMs);
+    // Paksa tulis page saat ini (mis. sebelum tidur/reset)
+    void flush();
+
+    // Kunjungi rekaman dengan from <= time <= to, termasuk yang masih di RAM.
+    // Return jumlah rekaman yang dikunjungi.
+    size_t query(uint32_t from, uint32_t to, HistoryVisitor visitor, void* context);
+
+    bool mounted() const { return partition_ != nullptr; }
+    uint32_t oldestTime() const;
+    uint16_t sectorsUsed() const { return usedSectors_; }
+    uint16_t sectorCount() const { return sectorCount_; }
+
+    const HistoryStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    struct __attribute__((packed)) SectorHeader {
+        uint32_t magic;
+        uint32_t seq;
+        uint32_t firstTime;
+        uint16_t version;
+        uint16_t crc;
+    };
+
+    struct __attribute__((packed)) PageHeader {
+        uint16_t magic;
+        uint8_t length;  // Byte delta setelah header
+        uint8_t count;   // Jumlah rekaman, termasuk rekaman pertama di header
+        uint32_t time;
+        int16_t temperatureCenti;
+        uint16_t humidityDeci;
+        uint32_t lux;
+        uint8_t flags;
+        uint8_t reserved;
+        uint16_t crc;
+    };
+
+    static const size_t PAGE_DATA = HISTORY_PAGE_SIZE - sizeof(PageHeader);
+
+    struct Page {
+        PageHeader header;
+        uint8_t data[PAGE_DATA];
+    };
+
+    void startPage(const HistoryRecord& record);
+    bool writePage();
+    bool openSector(uint32_t firstTime);
+    uint16_t physicalSector(uint16_t logical) const { return (tailSector_ + logical) % sectorCount_; }
+    size_t sectorOffset(uint16_t sector) const { return (size_t)sector * HISTORY_SECTOR_SIZE; }
+    static uint16_t pageCrc(const Page& page);
+    // Return false jika visitor minta berhenti atau rekaman sudah lewat "to"
+    static bool visitPage(const Page& page, uint32_t from, uint32_t to, HistoryVisitor visitor, void* context,
+                          size_t& visited);
+
+    const esp_partition_t* partition_ = nullptr;
+    uint16_t sectorCount_ = 0;
+    uint16_t tailSector_ = 0;     // Sektor tertua
+    uint16_t usedSectors_ = 0;
+    uint8_t pageIndex_ = HISTORY_PAGES_PER_SECTOR;  // Page berikutnya di sektor kepala
+    uint32_t headSeq_ = 0;
+    uint32_t sectorTime_[HISTORY_MAX_SECTORS];  // Waktu rekaman pertama per sektor fisik
+
+    // Page yang sedang diisi di RAM
+    Page page_;
+    bool pageOpen_ = false;
+    uint32_t pageOpenedMs_ = 0;
+    HistoryRecord last_ = {};
+
+    HistoryStats stats_ = {};
+};
+
+extern HistoryLog historyLog;
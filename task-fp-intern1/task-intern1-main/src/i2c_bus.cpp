@@ -0,0 +1,251 @@
+#include "i2c_bus.h"
+
+#include "fixed_print.h"
+#include "profiler.h"
+
+I2CBus i2cBus(Wire);
+
+I2CBus::Session::Session(I2CBus& bus, int device, uint8_t priority) : bus_(bus), device_(device) {
+    waitStart_ = micros();
+    bus_.acquire(priority);
+    busStart_ = micros();
+    bus_.selectClock(bus_.devices_[device].clock);
+}
+
+I2CBus::Session::~Session() {
+    uint32_t end = micros();
+    bus_.clock_ = 0;
+    bus_.record(bus_.devices_[device_], busStart_ - waitStart_, end - busStart_, 0, true);
+    bus_.release();
+}
+
+void I2CBus::begin(int sda, int scl) {
+    sda_ = sda;
+    scl_ = scl;
+    wire_.begin(sda, scl);
+    wire_.setTimeOut(I2C_BUS_TIMEOUT_MS);
+    clock_ = 0;
+#if I2C_BUS_ARBITER
+    if (lock_ == nullptr) {
+        lock_ = xSemaphoreCreateMutex();
+        for (Waiter& waiter : waiters_) {
+            waiter.wake = xSemaphoreCreateBinary();
+        }
+    }
+#endif
+}
+
+int I2CBus::addDevice(const char* name, uint8_t address, uint32_t clock) {
+    for (int i = 0; i < deviceCount_; i++) {
+        if (devices_[i].address == address) {
+            return i;
+        }
+    }
+    if (deviceCount_ >= I2C_BUS_MAX_DEVICES) {
+        return -1;
+    }
+    devices_[deviceCount_] = {name, address, clock, {}};
+    return deviceCount_++;
+}
+
+bool I2CBus::probe(int device) {
+    return transfer(device, nullptr, 0, nullptr, 0, nullptr, 0, I2C_PRIORITY_CONTROL);
+}
+
+bool I2CBus::write(int device, const uint8_t* data, size_t length, uint8_t priority) {
+    return transfer(device, nullptr, 0, data, length, nullptr, 0, priority);
+}
+
+size_t I2CBus::writeChunked(int device, uint8_t prefix, const uint8_t* data, size_t length, uint8_t priority) {
+    size_t sent = 0;
+    for (size_t pos = 0; pos < length; pos += I2C_BUS_CHUNK) {
+        size_t count = length - pos < I2C_BUS_CHUNK ? length - pos : I2C_BUS_CHUNK;
+        // Bus dilepas setelah setiap chunk; penunggu berprioritas lebih tinggi masuk di sini
+        if (!transfer(device, &prefix, 1, data + pos, count, nullptr, 0, priority)) {
+            return 0;
+        }
+        sent += count + 1;
+    }
+    return sent;
+}
+
+bool I2CBus::writeRead(int device, const uint8_t* tx, size_t txLength, uint8_t* rx, size_t rxLength,
+                       uint8_t priority) {
+    return transfer(device, nullptr, 0, tx, txLength, rx, rxLength, priority);
+}
+
+bool I2CBus::transfer(int device, const uint8_t* prefix, size_t prefixLength, const uint8_t* tx,
+                      size_t txLength, uint8_t* rx, size_t rxLength, uint8_t priority) {
+    if (device < 0 || device >= deviceCount_) {
+        return false;
+    }
+    Device& dev = devices_[device];
+    uint32_t waitStart = micros();
+    acquire(priority);
+    uint32_t busStart = micros();
+    selectClock(dev.clock);
+
+    bool ok = false;
+    for (int tries = 0; !ok && tries <= I2C_BUS_RETRIES; tries++) {
+        uint8_t error = attempt(dev.address, prefix, prefixLength, tx, txLength, rx, rxLength);
+        if (error == 0) {
+            ok = true;
+        } else {
+            dev.stats.errors++;
+            stats_.lastError = error;
+            if (error >= 4) {
+                recover();  // 4: error bus lain, 5: timeout; kemungkinan SDA ditahan slave
+            }
+        }
+    }
+
+    record(dev, busStart - waitStart, micros() - busStart, prefixLength + txLength + rxLength, ok);
+    release();
+    return ok;
+}
+
+// Satu percobaan transaksi. Return kode endTransmission(): 0 sukses,
+// 2 NACK alamat, 3 NACK data, 4 error lain, 5 timeout.
+uint8_t I2CBus::attempt(uint8_t address, const uint8_t* prefix, size_t prefixLength, const uint8_t* tx,
+                        size_t txLength, uint8_t* rx, size_t rxLength) {
+    wire_.beginTransmission(address);
+    if (prefixLength > 0) wire_.write(prefix, prefixLength);
+    if (txLength > 0) wire_.write(tx, txLength);
+    uint8_t error = wire_.endTransmission(rxLength == 0);
+    if (error != 0 || rxLength == 0) {
+        return error;
+    }
+    if (wire_.requestFrom(address, (uint8_t)rxLength) != rxLength) {
+        return 4;
+    }
+    for (size_t i = 0; i < rxLength; i++) {
+        rx[i] = (uint8_t)wire_.read();
+    }
+    return 0;
+}
+
+void I2CBus::recover() {
+    PROFILE_SCOPE("i2c.recover");
+    stats_.recoveries++;
+    wire_.end();
+
+    // Slave yang berhenti di tengah byte melepas SDA setelah paling banyak 9 clock
+    pinMode(sda_, INPUT_PULLUP);
+    pinMode(scl_, OUTPUT_OPEN_DRAIN);
+    for (int i = 0; i < 9 && digitalRead(sda_) == LOW; i++) {
+        digitalWrite(scl_, LOW);
+        delayMicroseconds(5);
+        digitalWrite(scl_, HIGH);
+        delayMicroseconds(5);
+    }
+    // STOP: SDA naik saat SCL tinggi
+    pinMode(sda_, OUTPUT_OPEN_DRAIN);
+    digitalWrite(sda_, LOW);
+    delayMicroseconds(5);
+    digitalWrite(scl_, HIGH);
+    delayMicroseconds(5);
+    digitalWrite(sda_, HIGH);
+
+    wire_.begin(sda_, scl_);
+    wire_.setTimeOut(I2C_BUS_TIMEOUT_MS);
+    clock_ = 0;
+}
+
+void I2CBus::selectClock(uint32_t clock) {
+    if (clock != clock_) {
+        wire_.setClock(clock);
+        clock_ = clock;
+        stats_.clockSwitches++;
+    }
+}
+
+void I2CBus::record(Device& device, uint32_t waitUs, uint32_t busUs, size_t bytes, bool ok) {
+    I2CDeviceStats& s = device.stats;
+    s.transactions++;
+    if (ok) {
+        s.bytes += bytes;
+    } else {
+        s.failures++;
+    }
+    s.waitUsTotal += waitUs;
+    if (waitUs > s.waitUsMax) s.waitUsMax = waitUs;
+    s.busUsTotal += busUs;
+    if (busUs > s.busUsMax) s.busUsMax = busUs;
+}
+
+#if I2C_BUS_ARBITER
+void I2CBus::acquire(uint8_t priority) {
+    for (;;) {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        if (!busy_) {
+            busy_ = true;
+            xSemaphoreGive(lock_);
+            return;
+        }
+        for (Waiter& waiter : waiters_) {
+            if (!waiter.used) {
+                waiter.used = true;
+                waiter.priority = priority;
+                waiter.order = nextOrder_++;
+                xSemaphoreGive(lock_);
+                // Bus diserahkan langsung oleh release(), busy_ tetap true
+                xSemaphoreTake(waiter.wake, portMAX_DELAY);
+                return;
+            }
+        }
+        xSemaphoreGive(lock_);
+        vTaskDelay(1);  // Semua slot terpakai, coba lagi
+    }
+}
+
+void I2CBus::release() {
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    Waiter* next = nullptr;
+    for (Waiter& waiter : waiters_) {
+        if (!waiter.used) continue;
+        if (next == nullptr || waiter.priority > next->priority ||
+            (waiter.priority == next->priority && (int32_t)(waiter.order - next->order) < 0)) {
+            next = &waiter;
+        }
+    }
+    if (next != nullptr) {
+        next->used = false;
+        xSemaphoreGive(next->wake);
+    } else {
+        busy_ = false;
+    }
+    xSemaphoreGive(lock_);
+}
+#else
+void I2CBus::acquire(uint8_t priority) {
+    (void)priority;
+}
+
+void I2CBus::release() {}
+#endif
+
+void I2CBus::report(Print& out) const {
+    fixedPrintf(out, "i2c: %lu clock switches, %lu recoveries (last error %u)\n",
+                (unsigned long)stats_.clockSwitches, (unsigned long)stats_.recoveries, stats_.lastError);
+    for (int i = 0; i < deviceCount_; i++) {
+        const Device& d = devices_[i];
+        const I2CDeviceStats& s = d.stats;
+        uint32_t n = s.transactions ? s.transactions : 1;
+        fixedPrintf(out, "  %-7s 0x%02x %lu kHz: %lu txn, %lu B, %lu err, %lu failed; "
+                    "wait avg %lu max %lu us, bus avg %lu max %lu us\n",
+                    d.name, d.address, (unsigned long)(d.clock / 1000), (unsigned long)s.transactions,
+                    (unsigned long)s.bytes, (unsigned long)s.errors, (unsigned long)s.failures,
+                    (unsigned long)(s.waitUsTotal / n), (unsigned long)s.waitUsMax,
+                    (unsigned long)(s.busUsTotal / n), (unsigned long)s.busUsMax);
+    }
+}
+
+void I2CBus::resetStats() {
+    // record() menulis stats saat memegang bus (task transfer di core 0), jadi reset juga memegangnya
+    acquire(I2C_PRIORITY_CONTROL);
+    stats_ = {};
+    for (int i = 0; i < deviceCount_; i++) {
+        devices_[i].stats = {};
+    }
+    release();
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Pengelola bus I2C bersama (SSD1306 0x3C + DS1307 0x68).
+// Hanya modul ini yang menyentuh Wire. Setiap perangkat didaftarkan dengan
+// clock tercepat yang didukungnya; clock bus diganti hanya saat perangkat
+// berikutnya butuh clock lain. Setiap transaksi mengambil bus dengan prioritas:
+// jika bus sedang dipakai, bus diserahkan ke penunggu berprioritas tertinggi
+// (urut datang untuk prioritas sama), jadi baca waktu RTC mendahului chunk
+// framebuffer. Transfer panjang dipecah per I2C_BUS_CHUNK byte dan bus
+// dilepas di antara chunk, jadi transaksi kecil paling lama menunggu satu chunk.
+// Transaksi yang gagal diulang; timeout/error bus memicu pemulihan (9 pulsa SCL
+// + STOP) untuk melepas slave yang menahan SDA.
+
+// Arbitrasi antar task hanya di ESP32 (FreeRTOS); build lain satu thread
+#ifndef I2C_BUS_ARBITER
+#ifdef ESP_PLATFORM
+#define I2C_BUS_ARBITER 1
+#else
+#define I2C_BUS_ARBITER 0
+#endif
+#endif
+
+#define I2C_SDA_PIN 21
+#define I2C_SCL_PIN 22
+#define I2C_BUS_MAX_DEVICES 4
+#define I2C_BUS_MAX_WAITERS 4   // Task yang bisa menunggu bus bersamaan
+#define I2C_BUS_CHUNK 64        // Byte data per transaksi pada transfer panjang
+#define I2C_BUS_RETRIES 2
+#define I2C_BUS_TIMEOUT_MS 10   // Batas Wire per transaksi, bawaan 50 ms
+
+// Angka lebih besar dilayani lebih dulu
+enum I2CPriority : uint8_t {
+    I2C_PRIORITY_BULK,     // Chunk framebuffer
+    I2C_PRIORITY_CONTROL,  // Perintah singkat ke panel
+    I2C_PRIORITY_TIME,     // Baca/tulis RTC
+};
+
+struct I2CDeviceStats {
+    uint32_t transactions;  // Satu chunk dihitung satu transaksi
+    uint32_t bytes;         // Data tulis + baca, tanpa byte alamat
+    uint32_t errors;        // Percobaan yang gagal
+    uint32_t failures;      // Transaksi yang tetap gagal setelah semua retry
+    uint32_t waitUsTotal;   // Menunggu giliran bus
+    uint32_t waitUsMax;
+    uint32_t busUsTotal;    // Memegang bus, termasuk retry
+    uint32_t busUsMax;
+};
+
+struct I2CBusStats {
+    uint32_t clockSwitches;
+    uint32_t recoveries;
+    uint8_t lastError;      // Kode endTransmission() terakhir yang bukan 0
+};
+
+class I2CBus {
+public:
+    // Akses Wire langsung untuk driver pihak ketiga (mis. oled.begin()).
+    // Bus dipegang selama objek hidup; clock dianggap tidak diketahui
+    // sesudahnya karena driver bisa menggantinya sendiri.
+    class Session {
+    public:
+        Session(I2CBus& bus, int device, uint8_t priority);
+        ~Session();
+
+    private:
+        I2CBus& bus_;
+        int device_;
+        uint32_t waitStart_;
+        uint32_t busStart_;
+    };
+
+    explicit I2CBus(TwoWire& wire) : wire_(wire) {}
+
+    void begin(int sda, int scl);
+    // Return id perangkat; alamat yang sudah terdaftar mengembalikan id lama
+    int addDevice(const char* name, uint8_t address, uint32_t clock);
+
+    bool probe(int device);
+    bool write(int device, const uint8_t* data, size_t length, uint8_t priority);
+    // Kirim prefix + data dipecah per I2C_BUS_CHUNK, prefix diulang di setiap
+    // chunk (control byte SSD1306). Return byte di bus termasuk prefix, 0 jika gagal.
+    size_t writeChunked(int device, uint8_t prefix, const uint8_t* data, size_t length, uint8_t priority);
+    // Tulis alamat register lalu baca dengan repeated start
+    bool writeRead(int device, const uint8_t* tx, size_t txLength, uint8_t* rx, size_t rxLength,
+                   uint8_t priority);
+
+    // Lepaskan slave yang menahan SDA lalu mulai ulang Wire
+    void recover();
+
+    const I2CDeviceStats& deviceStats(int device) const { return devices_[device].stats; }
+    const I2CBusStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    // Memegang bus sebentar; jangan dipanggil di dalam Session
+    void resetStats();
+
+private:
+    struct Device {
+        const char* name;
+        uint8_t address;
+        uint32_t clock;
+        I2CDeviceStats stats;
+    };
+
+    void acquire(uint8_t priority);
+    void release();
+    void selectClock(uint32_t clock);
+    bool transfer(int device, const uint8_t* prefix, size_t prefixLength, const uint8_t* tx, size_t txLength,
+                  uint8_t* rx, size_t rxLength, uint8_t priority);
+    uint8_t attempt(uint8_t address, const uint8_t* prefix, size_t prefixLength, const uint8_t* tx,
+                    size_t txLength, uint8_t* rx, size_t rxLength);
+    void record(Device& device, uint32_t waitUs, uint32_t busUs, size_t bytes, bool ok);
+
+    TwoWire& wire_;
+    int sda_ = I2C_SDA_PIN;
+    int scl_ = I2C_SCL_PIN;
+    uint32_t clock_ = 0;  // 0: belum diketahui, setClock() berikutnya wajib
+    Device devices_[I2C_BUS_MAX_DEVICES] = {};
+    int deviceCount_ = 0;
+    I2CBusStats stats_ = {};
+
+#if I2C_BUS_ARBITER
+    // Antrian penunggu bus; slot dan semaphore-nya dibuat di begin(), tanpa heap setelahnya
+    struct Waiter {
+        SemaphoreHandle_t wake;
+        uint32_t order;
+        uint8_t priority;
+        bool used;
+    };
+    SemaphoreHandle_t lock_ = nullptr;  // Melindungi busy_ dan waiters_, bukan bus itu sendiri
+    Waiter waiters_[I2C_BUS_MAX_WAITERS] = {};
+    uint32_t nextOrder_ = 0;
+    bool busy_ = false;
+#endif
+};
+
+extern I2CBus i2cBus;
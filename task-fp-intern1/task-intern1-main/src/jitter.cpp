@@ -0,0 +1,42 @@
+#include "jitter.h"
+
+#include <math.h>
+
+#include "fixed_print.h"
+
+void JitterMeter::mark(uint32_t nowUs, uint32_t periodUs) {
+    if (started_) {
+        int32_t deviation = (int32_t)(nowUs - lastUs_ - periodUs);
+        uint32_t magnitude = deviation < 0 ? -deviation : deviation;
+        if (stats_.samples == 0 || deviation < stats_.minUs) stats_.minUs = deviation;
+        if (stats_.samples == 0 || deviation > stats_.maxUs) stats_.maxUs = deviation;
+        stats_.samples++;
+        stats_.periodUs = periodUs;
+        stats_.sumAbsUs += magnitude;
+        stats_.sumSqUs += (uint64_t)magnitude * magnitude;
+    }
+    sync(nowUs);
+}
+
+void JitterMeter::sync(uint32_t nowUs) {
+    lastUs_ = nowUs;
+    started_ = true;
+}
+
+uint32_t JitterMeter::rmsUs() const {
+    if (stats_.samples == 0) {
+        return 0;
+    }
+    return (uint32_t)lroundf(sqrtf((float)(stats_.sumSqUs / stats_.samples)));
+}
+
+void JitterMeter::report(Print& out) const {
+    fixedPrintf(out, "jitter %s: %lu periods of %lu us, deviation min %ld max %ld us, mean %lu rms %lu us\n",
+                name_, (unsigned long)stats_.samples, (unsigned long)stats_.periodUs, (long)stats_.minUs,
+                (long)stats_.maxUs, (unsigned long)meanAbsUs(), (unsigned long)rmsUs());
+}
+
+// Statistik dikosongkan, acuan mark terakhir tetap
+void JitterMeter::resetStats() {
+    stats_ = {};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Pengukur jitter loop periodik: setiap mark() membandingkan interval sejak
+// mark sebelumnya dengan periode yang dijadwalkan. Deviasi negatif = terlalu
+// cepat, positif = terlambat. Dipakai untuk loop kontrol (core 0) dan render (core 1).
+
+struct JitterStats {
+    uint32_t samples;     // Interval yang dihitung
+    uint32_t periodUs;    // Periode terjadwal interval terakhir
+    int32_t minUs;        // Deviasi terkecil
+    int32_t maxUs;        // Deviasi terbesar
+    uint64_t sumAbsUs;
+    uint64_t sumSqUs;     // Untuk RMS
+};
+
+class JitterMeter {
+public:
+    explicit JitterMeter(const char* name) : name_(name) {}
+
+    // Awal iterasi; periodUs = periode yang dijadwalkan sejak iterasi sebelumnya
+    void mark(uint32_t nowUs, uint32_t periodUs);
+    // Awal iterasi di luar jadwal (mis. dipicu event): jadi acuan, tidak dihitung
+    void sync(uint32_t nowUs);
+
+    uint32_t meanAbsUs() const { return stats_.samples ? (uint32_t)(stats_.sumAbsUs / stats_.samples) : 0; }
+    uint32_t rmsUs() const;
+    const JitterStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    const char* name_;
+    uint32_t lastUs_ = 0;
+    bool started_ = false;
+    JitterStats stats_ = {};
+};
@@ -0,0 +1,145 @@
+#include "ldr_service.h"
+
+#include "profiler.h"
+#include "trace.h"
+
+LdrService ldrService;
+
+// Lux untuk ADC = 0, 64, 128, ..., 4096 (entri terakhir ADC 4095).
+// Modul photoresistor Wokwi: LDR dengan resistor 10k, gamma 0.7, RL10 50k:
+//   R   = 10000 * adc / (4095 - adc)
+//   lux = 10 * (50000 / R) ^ (1 / 0.7), dibatasi 100000
+// ADC makin tinggi berarti makin gelap.
+static const uint32_t LUX_TABLE[65] = {
+    100000, 37056, 13455, 7366, 4770, 3386, 2546, 1993, 1606, 1322, 1108, 942, 809,
+    702,    614,   540,   479,  426,  381,  341,  307,  277,  251,  227,  207,  188,
+    171,    156,   143,   130,  119,  109,  100,  91,   83,   76,   70,   63,   58,
+    53,     48,    44,    40,   36,   32,   29,   26,   23,   21,   18,   16,   14,
+    12,     11,    9,     7,    6,    5,    4,    3,    2,    1,    1,    0,    0};
+
+void LdrService::begin(uint8_t pin) {
+    pin_ = pin;
+    pinMode(pin_, INPUT);
+
+    esp_timer_create_args_t args = {};
+    args.callback = onSampleTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "ldr";
+    args.skip_unhandled_events = true;
+    esp_timer_create(&args, &timer_);
+    esp_timer_start_periodic(timer_, LDR_SAMPLE_PERIOD_US);
+}
+
+void LdrService::setFilter(const LdrFilterConfig& config) {
+    config_ = config;
+    if (config_.medianWindow < 1) config_.medianWindow = 1;
+    if (config_.medianWindow > LDR_MEDIAN_MAX) config_.medianWindow = LDR_MEDIAN_MAX;
+    windowCount_ = 0;
+    windowPos_ = 0;
+    ema_ = -1;
+}
+
+void LdrService::setLowPower(bool lowPower) {
+    if (lowPower == lowPower_) return;
+    lowPower_ = lowPower;
+    if (lowPower) {
+        esp_timer_stop(timer_);
+        lowPowerBlockMs_ = millis() - LDR_LOW_POWER_PERIOD_MS;  // Blok pertama langsung diambil
+    } else {
+        esp_timer_start_periodic(timer_, LDR_SAMPLE_PERIOD_US);
+    }
+}
+
+// Callback esp_timer (task esp_timer): satu sampel per panggilan
+void LdrService::onSampleTimer(void* arg) {
+    PROFILE_SCOPE("ldr.adc");
+    LdrService* self = static_cast<LdrService*>(arg);
+    self->accumulator_ += analogRead(self->pin_);
+    if (++self->sampleCount_ >= LDR_OVERSAMPLE) {
+        self->blocks_.push((uint16_t)self->accumulator_);
+        self->accumulator_ = 0;
+        self->sampleCount_ = 0;
+    }
+}
+
+void LdrService::tick() {
+    PROFILE_SCOPE("ldr.filter");
+    uint16_t block;
+    bool updated = false;
+    while (blocks_.pop(block)) {
+        addBlock(block);
+        updated = true;
+    }
+    if (lowPower_ && millis() - lowPowerBlockMs_ >= LDR_LOW_POWER_PERIOD_MS) {
+        // Satu blok langsung dari ADC (16 x ±10 us), bukan dari timer
+        PROFILE_SCOPE("ldr.adc");
+        uint32_t sum = 0;
+        for (uint8_t i = 0; i < LDR_OVERSAMPLE; i++) {
+            sum += analogRead(pin_);
+        }
+        addBlock((uint16_t)sum);
+        lowPowerBlockMs_ = millis();
+        updated = true;
+    }
+    if (!updated) {
+        return;
+    }
+
+    // Blok 16-bit (16 x 12-bit) -> 12-bit dengan pembulatan
+    uint16_t adc = (uint16_t)(((ema_ >> 8) + LDR_OVERSAMPLE / 2) / LDR_OVERSAMPLE);
+    if (adc > 4095) adc = 4095;
+    uint32_t lux = adcToLux(adc);
+
+    // Hysteresis: status hanya berubah setelah melewati ambang di sisi lain
+    bool dark = reading_.valid ? reading_.dark : lux < (LDR_DARK_LUX + LDR_BRIGHT_LUX) / 2;
+    if (dark && lux > LDR_BRIGHT_LUX) {
+        dark = false;
+    } else if (!dark && lux < LDR_DARK_LUX) {
+        dark = true;
+    }
+
+    reading_.lux = lux;
+    reading_.adc = adc;
+    reading_.dark = dark;
+    reading_.timestampMs = millis();
+    reading_.valid = true;
+}
+
+void LdrService::addBlock(uint16_t block) {
+    traceRecorder.ldr(block, micros());
+    uint16_t value = median(block);
+    if (ema_ < 0 || config_.emaShift == 0) {
+        ema_ = (int32_t)value << 8;
+    } else {
+        ema_ += (((int32_t)value << 8) - ema_) >> config_.emaShift;
+    }
+}
+
+// Median dari jendela blok terakhir (insertion sort, maksimal 5 elemen)
+uint16_t LdrService::median(uint16_t latest) {
+    window_[windowPos_] = latest;
+    windowPos_ = (windowPos_ + 1) % config_.medianWindow;
+    if (windowCount_ < config_.medianWindow) windowCount_++;
+
+    uint16_t sorted[LDR_MEDIAN_MAX];
+    for (uint8_t i = 0; i < windowCount_; i++) {
+        uint16_t v = window_[i];
+        int8_t j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    return sorted[windowCount_ / 2];
+}
+
+uint32_t LdrService::adcToLux(uint16_t adc) {
+    if (adc >= 4095) return LUX_TABLE[64];
+    uint16_t index = adc >> 6;
+    uint16_t frac = adc & 0x3F;
+    int32_t a = (int32_t)LUX_TABLE[index];
+    int32_t b = (int32_t)LUX_TABLE[index + 1];
+    return (uint32_t)(a + (((b - a) * (int32_t)frac) >> 6));
+}
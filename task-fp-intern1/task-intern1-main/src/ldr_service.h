@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include "ring_buffer.h"
+
+// Akuisisi LDR kontinu.
+// esp_timer mengambil sampel ADC di latar belakang dan menjumlahkan
+// LDR_OVERSAMPLE sampel per blok; tick() menyaring blok dengan median + EMA
+// (fixed-point) lalu mengonversi ke lux lewat tabel kurva photoresistor.
+// LDR ada di GPIO13 (ADC2), yang tidak bisa dipakai mode DMA/I2S ESP32,
+// jadi sampling digerakkan timer.
+// Mode hemat daya mematikan timer 1 kHz (yang membangunkan CPU setiap 1 ms);
+// tick() lalu mengambil satu blok langsung paling sering LDR_LOW_POWER_PERIOD_MS.
+
+#define LDR_SAMPLE_PERIOD_US 1000  // 1 kHz
+#define LDR_OVERSAMPLE 16          // 16 sampel 12-bit -> 1 blok 16-bit
+#define LDR_MEDIAN_MAX 5
+#define LDR_LOW_POWER_PERIOD_MS 100
+
+// Hysteresis keputusan Gelap/Terang di sekitar ambang lama 500 lux
+#define LDR_DARK_LUX 450
+#define LDR_BRIGHT_LUX 550
+
+struct LdrFilterConfig {
+    uint8_t medianWindow;  // 1 (mati), 3 atau 5 blok
+    uint8_t emaShift;      // alpha = 1 / 2^emaShift, 0 = tanpa EMA
+};
+
+struct LdrReading {
+    uint32_t lux;
+    uint16_t adc;          // Nilai ADC 12-bit setelah filter
+    bool dark;             // Keputusan Gelap/Terang dengan hysteresis
+    uint32_t timestampMs;
+    bool valid;
+};
+
+class LdrService {
+public:
+    void begin(uint8_t pin);
+    void setFilter(const LdrFilterConfig& config);
+    // Dipanggil dari sisi yang sama dengan tick()
+    void setLowPower(bool lowPower);
+    // Proses blok yang terkumpul; dipanggil periodik dari scheduler
+    void tick();
+    LdrReading latest() const { return reading_; }
+    uint32_t blocksDropped() const { return blocks_.dropped(); }
+
+    // Konversi ADC 12-bit ke lux, integer + interpolasi linear di tabel
+    static uint32_t adcToLux(uint16_t adc);
+
+private:
+    static void onSampleTimer(void* arg);
+    void addBlock(uint16_t block);
+    uint16_t median(uint16_t latest);
+
+    uint8_t pin_ = 0;
+    esp_timer_handle_t timer_ = nullptr;
+
+    // Dipakai callback timer (produsen)
+    uint32_t accumulator_ = 0;
+    uint8_t sampleCount_ = 0;
+    SpscRing<uint16_t, 32> blocks_;
+
+    // Dipakai tick() (konsumen)
+    bool lowPower_ = false;
+    uint32_t lowPowerBlockMs_ = 0;
+    LdrFilterConfig config_ = {5, 3};
+    uint16_t window_[LDR_MEDIAN_MAX] = {};
+    uint8_t windowCount_ = 0;
+    uint8_t windowPos_ = 0;
+    int32_t ema_ = -1;  // Blok 16-bit << 8, -1 = belum ada data
+    LdrReading reading_ = {0, 0, false, 0, false};
+};
+
+extern LdrService ldrService;
@@ -1,31 +1,98 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <DHTesp.h>
-#include <ESP32Servo.h>
 #include <RTClib.h>
 #include <Wire.h>
 
+#include "alarm_service.h"
+#include "alloc_guard.h"
+#include "animation.h"
+#include "boot_manager.h"
+#include "buttons.h"
+#include "clock_service.h"
+#include "control_loop.h"
+#include "dht_service.h"
+#include "display.h"
+#include "game.h"
+#include "history_log.h"
+#include "i2c_bus.h"
+#include "jitter.h"
+#include "ldr_service.h"
+#include "power_manager.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "telemetry.h"
+#include "timer_service.h"
+#include "trace.h"
+#include "trend_service.h"
+#include "ui.h"
+
 // Function prototypes
+void inputTask();
+void renderTask();
+void displayTask();
+void controlTask();
+void syncControl();
+void updateDisplayPower();
+bool canSleep();
+void idleSleep();
+void bootTask();
+void initDeferred();
+void saveUiState();
+bool restoreUiState(bool clockValid);
+void statsTask();
+void telemetryTask();
+void sampleTask();
+void historyTask();
+void trendTask();
+void exportHistory();
+uint8_t handleTelemetryCommand(uint8_t type, const uint8_t* payload, size_t length);
+void clockTask();
+void onClockSecond(uint32_t unixtime);
+void onAlarmRing(int slot);
+void onTimerExpire(int id);
+void drawAlarmRinging();
+void drawTimerDone();
+void closeTimerDone();
+void drawAlarmList();
 void displayTimeWithMenu();
 void handleDHTMode();
 void handleLDRMode();
 void handleAlarmMode();
-void drawAnimation(int frame);
+void handleTrendMode();
+void handleGameMode();
+void handleTrendInput(bool redPressed, bool bluePressed);
+void formatTrendValue(char* out, size_t size, TrendMetric metric, int32_t value);
+void formatFixed(char* out, size_t size, int32_t value, uint8_t decimals);
+void paintFlames(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t frame);
+void paintWeather(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t dark);
+void paintNightSky(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t state);
+void paintTrendGraph(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t state);
+void paintFill(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t on);
+void handleAlarmInput(bool redPressed, bool bluePressed, bool greenShort, bool greenLong, bool isRepeat);
+bool drawModeTransition();
+void setRenderFast(bool fast);
+bool startCountdown(unsigned long durationMs);
 void handleCountdown();
 void handleStopwatch();
+void handleStopwatchInput(bool redPressed, bool bluePressed);
+void formatDuration(char* out, size_t size, uint64_t us, uint8_t decimals);
 void setAlarm();
+const char* alarmDaysLabel(uint8_t days);
+uint8_t nextAlarmDays(uint8_t days);
 
 // Constants and Variables
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
+#define SCREEN_ADDRESS 0x3C
 Adafruit_SSD1306 oled(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+Display screen(oled, i2cBus, SCREEN_ADDRESS);  // Flush parsial, hanya page yang berubah
+ui::Renderer renderer(oled, screen);  // Widget retained, hanya yang berubah digambar
+Game game(oled, screen);  // Sprite langsung ke framebuffer, tanpa widget
 
-const int servoPin = 4;
-Servo servo;
+const int servoPin = 4;  // Servo dan LED dipegang controlLoop
 const int DHT_PIN = 15;
-DHTesp dhtSensor;
 #define LDR_PIN 13
-RTC_DS1307 rtc;
 
 #define GREEN_BUTTON_PIN 19
 #define RED_BUTTON_PIN 18
@@ -34,147 +101,763 @@ RTC_DS1307 rtc;
 #define GREEN_LED_PIN 16
 #define RED_LED_PIN 17
 
-int green_button_state;
-int red_button_state;
-int blue_button_state;
-int previous_green_button_state = HIGH;
-bool previous_blue_button_state = HIGH;
-bool previous_red_button_state = HIGH;
-
 unsigned long lastInputTime = 0;
-unsigned long pressStartTime = 0;
-int mode = 0;  // 0: Time, 1: DHT, 2: LDR, 3: Alarm
+int mode = 0;  // 0: Time, 1: DHT, 2: LDR, 3: Alarm, 4: Trend, 5: Game
 int selectedMode = 0;  // Used for menu selection
-const unsigned long TIMEOUT_DURATION = 30000;
-const unsigned long LONG_PRESS_DURATION = 2000;
-
-const char* modes[] = {"Time", "DHT", "LDR", "Alarm"};
-bool isDHTModeInitialized = false;
-bool isLDRModeInitialized = false;
+const unsigned long TIMEOUT_DURATION = 30000;  // Juga batas layar diredupkan
+const unsigned long DISPLAY_OFF_DURATION = 60000;  // Layar dimatikan
+
+// Periode dan budget task scheduler
+const uint32_t INPUT_PERIOD_MS = 10;
+const uint32_t RENDER_PERIOD_MS = 100;
+const uint32_t RENDER_FAST_PERIOD_MS = DISPLAY_MIN_FRAME_MS;  // Selama transisi dan game
+const uint32_t DISPLAY_POLL_PERIOD_MS = 5;
+const uint32_t CLOCK_PERIOD_MS = 10;
+const uint32_t STATS_PERIOD_MS = 10000;
+const uint32_t TELEMETRY_PERIOD_MS = 10;
+const uint32_t SAMPLE_PERIOD_MS = 200;
+const uint32_t BOOT_STEP_PERIOD_MS = 1;  // Selama inisialisasi tertunda belum selesai
+const uint32_t BOOT_PERIOD_MS = 20;       // Sesudahnya: bandingkan dan simpan state UI
+int inputTaskId = -1;
+int renderTaskId = -1;
+int statsTaskId = -1;
+int bootTaskId = -1;
+int bootStep = 0;  // Langkah inisialisasi tertunda berikutnya
+JitterMeter renderJitter("render");  // Hanya run render terjadwal
+
+// Mode yang terakhir digambar; berbeda dari mode = layar digambar penuh
+int renderedMode = -1;
+
+const char* modes[] = {"Time", "DHT", "LDR", "Alarm", "Trend", "Game"};
+const int MODE_COUNT = sizeof(modes) / sizeof(modes[0]);
+anim::Transition modeTransition;  // Animasi wipe saat masuk mode DHT/LDR
+const uint16_t MODE_TRANSITION_MS = 400;
 bool isInAlarmMode = false;  // Flag untuk mode alarm
 bool isInSubMode = false;
 int alarmSubMode = 0;  // 0: Alarm, 1: Countdown, 2: Stopwatch
 
-// Variabel untuk alarm
-int alarmHour = 0;
-int alarmMinute = 0;
-int alarmSecond = 0;
-
-// Variabel untuk countdown
-int countdownHour = 0;
+// State machine untuk mode alarm dan submode-nya
+enum AlarmState {
+    ALARM_MENU,
+    ALARM_LIST,
+    ALARM_SET,
+    COUNTDOWN_SET,
+    COUNTDOWN_RUN,
+    STOPWATCH
+};
+AlarmState alarmState = ALARM_MENU;
+void enterAlarmState(AlarmState state);
+unsigned long alarmStateSince = 0;
+
+// Editor alarm: slot yang dipilih di daftar dan salinan yang sedang diubah
+int alarmSlot = 0;
+int alarmField = 0;  // 0: jam, 1: menit, 2: hari, 3: aktif
+AlarmSpec alarmEdit = {};
+
+// Countdown dan stopwatch berjalan di timerService; UI hanya memegang id yang ditampilkan
+int countdownHour = 0;  // Nilai di layar pengaturan countdown
 int countdownMinute = 0;
-int countdownSecond = 0;
-bool isCountdownActive = false;
-unsigned long countdownStart = 0;
-
-// Variabel untuk stopwatch
-unsigned long stopwatchStart = 0;
-unsigned long stopwatchElapsed = 0;
-bool isStopwatchRunning = false;
+int countdownId = -1;
+int stopwatchId = -1;
+
+// Countdown selesai: layar dan LED berkedip di atas mode apa pun sampai tombol ditekan
+const unsigned long COUNTDOWN_DONE_DURATION = 10000;
+bool timerDoneShowing = false;
+unsigned long timerDoneSince = 0;
+
+// Layar tren: jendela dan besaran yang ditampilkan
+TrendWindow trendWindow = TREND_1HOUR;
+TrendMetric trendMetric = TREND_TEMPERATURE;
+
+// Frame animasi api (DHT) dan langit malam (LDR)
+int dhtFrame = 0;
+int ldrSkyFrame = 0;
+
+// Ekspor riwayat ke host (CMD_HISTORY), dikirim bertahap sesuai ruang ring TX
+bool historyExporting = false;
+uint32_t historyExportFrom = 0;
+uint32_t historyExportTo = 0;
+
+// State UI yang dipulihkan setelah reset atau bangun dari deep sleep (bootManager).
+// Countdown dan stopwatch ikut berjalan selama perangkat mati, dihitung dari RTC.
+struct SavedUi {
+    int8_t mode;
+    int8_t selectedMode;
+    uint8_t isInAlarmMode;
+    int8_t alarmSubMode;
+    uint8_t alarmState;
+    int8_t countdownHour;
+    int8_t countdownMinute;
+    int8_t countdownId;
+    int8_t stopwatchId;
+    uint8_t trendWindow;
+    uint8_t trendMetric;
+    uint8_t reserved[5];
+    TimerSnapshot timers[TIMER_MAX];
+};
+
+// ---- Layar: widget terikat ke state di atas, digambar oleh renderer ----
+
+// Mode 0: jam besar, tanggal dan menu mode (tanpa "Time" sendiri)
+void timeText(char* out, size_t size) {
+    DateTime now = clockService.now();  // Dari cache, tanpa transaksi I2C
+    snprintf(out, size, "%02d:%02d:%02d", now.hour(), now.minute(), now.second());
+}
+void dateText(char* out, size_t size) {
+    DateTime now = clockService.now();
+    snprintf(out, size, "%02d/%02d/%04d", now.day(), now.month(), now.year());
+}
+int32_t modeMenuSelection() { return selectedMode - 1; }
+void modeMenuItem(int index, char* out, size_t size) { snprintf(out, size, "%s", modes[index + 1]); }
+
+ui::ValueField timeField(16, 0, 2, 8, timeText);  // Digit dari cache glyph, biasanya satu per detik
+ui::ValueField dateField(34, 16, 1, 10, dateText);
+ui::Menu modeMenu(0, 24, 4, 10, 12, MODE_COUNT - 1, modeMenuSelection, modeMenuItem);
+ui::Widget* const timeWidgets[] = {&timeField, &dateField, &modeMenu};
+ui::View timeView(timeWidgets);
+
+// Mode 1: DHT
+void dhtTemperatureText(char* out, size_t size) {
+    DhtReading data = controlLoop.snapshot().dht;
+    if (data.valid) {
+        char value[12];
+        formatFixed(value, sizeof(value), lroundf(data.temperature * 100), 2);
+        snprintf(out, size, "Temp: %s C", value);
+    } else {
+        snprintf(out, size, "Temp: --.-- C");
+    }
+}
+void dhtHumidityText(char* out, size_t size) {
+    DhtReading data = controlLoop.snapshot().dht;
+    if (data.valid) {
+        char value[12];
+        formatFixed(value, sizeof(value), lroundf(data.humidity * 10), 1);
+        snprintf(out, size, "Humidity: %s%%", value);
+    } else {
+        snprintf(out, size, "Humidity: --.-%%");
+    }
+}
+// Status suhu dari tabel statis: label pertama yang batasnya di atas suhu
+struct TemperatureBand {
+    float below;
+    const char* label;
+};
+const TemperatureBand DHT_STATUS[] = {{20.0, "Dingin"}, {25.0, "Netral"}, {30.0, "Hangat"}, {INFINITY, "Panas"}};
+
+void dhtStatusText(char* out, size_t size) {
+    DhtReading data = controlLoop.snapshot().dht;
+    const char* status = "Error";
+    if (data.valid) {
+        for (const TemperatureBand& band : DHT_STATUS) {
+            if (data.temperature < band.below) {
+                status = band.label;
+                break;
+            }
+        }
+    }
+    snprintf(out, size, "Status: %s", status);
+}
+int32_t dhtFlameFrame() { return dhtFrame; }
+
+ui::Label dhtTitle(0, 0, 1, "DHT22 Data:");
+ui::ValueField dhtTemperature(0, 8, 1, 16, dhtTemperatureText);
+ui::ValueField dhtHumidity(0, 16, 1, 16, dhtHumidityText);
+ui::ValueField dhtStatus(0, 24, 1, 14, dhtStatusText);
+ui::Icon dhtFlames({0, 47, 128, 8}, dhtFlameFrame, paintFlames);
+ui::Widget* const dhtWidgets[] = {&dhtTitle, &dhtTemperature, &dhtHumidity, &dhtStatus, &dhtFlames};
+ui::View dhtView(dhtWidgets);
+
+// Mode 2: LDR; langit malam menumpuk di atas bulan, jadi keduanya digambar ulang bersama
+void ldrLuxText(char* out, size_t size) { snprintf(out, size, "Lux: %d", controlLoop.snapshot().ldr.lux); }
+void ldrStatusText(char* out, size_t size) {
+    snprintf(out, size, "Status: %s", controlLoop.snapshot().ldr.dark ? "Gelap" : "Terang");
+}
+int32_t ldrDark() { return controlLoop.snapshot().ldr.dark; }
+int32_t ldrSkyState() { return controlLoop.snapshot().ldr.dark ? ldrSkyFrame + 1 : 0; }
+int32_t ldrLuxValue() { return controlLoop.snapshot().ldr.lux; }
+
+ui::ValueField ldrLux(0, 0, 1, 16, ldrLuxText);
+ui::ValueField ldrStatus(0, 8, 1, 14, ldrStatusText);
+ui::Icon ldrWeather({30, 10, 89, 21}, ldrDark, paintWeather);
+ui::Icon ldrSky({0, 18, 128, 31}, ldrSkyState, paintNightSky);
+ui::ProgressBar ldrBar({0, 50, 128, 10}, ldrLuxValue, 0, 1000);  // Skala 0-1000 lux
+ui::Widget* const ldrWidgets[] = {&ldrLux, &ldrStatus, &ldrWeather, &ldrSky, &ldrBar};
+ui::View ldrView(ldrWidgets);
+
+// Mode 3: menu alarm dan submode-nya
+const char* const ALARM_SUB_MODES[] = {"Alarm", "Countdown", "Stopwatch"};
+int32_t alarmSubModeSelection() { return alarmSubMode; }
+void alarmSubModeItem(int index, char* out, size_t size) { snprintf(out, size, "%s", ALARM_SUB_MODES[index]); }
+
+ui::Label alarmMenuTitle(0, 0, 1, "Alarm Mode:");
+ui::Menu alarmMenu(0, 10, 3, 10, 11, 3, alarmSubModeSelection, alarmSubModeItem);
+ui::Widget* const alarmMenuWidgets[] = {&alarmMenuTitle, &alarmMenu};
+ui::View alarmMenuView(alarmMenuWidgets);
+
+int32_t alarmSlotSelection() { return alarmSlot; }
+void alarmSlotItem(int index, char* out, size_t size) {
+    const AlarmSpec& spec = alarmService.get(index);
+    if (spec.enabled) {
+        snprintf(out, size, "%d %02d:%02d %s", index + 1, spec.hour, spec.minute, alarmDaysLabel(spec.days));
+    } else {
+        snprintf(out, size, "%d --:--", index + 1);
+    }
+}
 
-void setup() {
-    Serial.begin(9600);
+ui::Label alarmListTitle(0, 0, 1, "Alarms:");
+ui::Menu alarmList(0, 10, 6, 9, 17, ALARM_MAX, alarmSlotSelection, alarmSlotItem);
+ui::Widget* const alarmListWidgets[] = {&alarmListTitle, &alarmList};
+ui::View alarmListView(alarmListWidgets);
 
-    if (!oled.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
-        Serial.println(F("Failed to start SSD1306 OLED"));
+void alarmEditTitleText(char* out, size_t size) {
+    DateTime now = clockService.now();
+    snprintf(out, size, "Alarm %d  %02d:%02d:%02d", alarmSlot + 1, now.hour(), now.minute(), now.second());
+}
+int32_t alarmFieldSelection() { return alarmField; }
+void alarmFieldItem(int index, char* out, size_t size) {
+    switch (index) {
+        case 0:
+            snprintf(out, size, "%-7s%02d", "Hour", alarmEdit.hour);
+            break;
+        case 1:
+            snprintf(out, size, "%-7s%02d", "Minute", alarmEdit.minute);
+            break;
+        case 2:
+            snprintf(out, size, "%-7s%s", "Days", alarmDaysLabel(alarmEdit.days));
+            break;
+        default:
+            snprintf(out, size, "%-7s%s", "On", alarmEdit.enabled ? "Yes" : "No");
+            break;
     }
-    oled.clearDisplay();
+}
 
-    oled.setTextSize(1);
-    oled.setTextColor(WHITE);
-    oled.setCursor(0, 2);
-    oled.println("VI-ROSE");
-    oled.display();
+ui::ValueField alarmEditTitle(0, 0, 1, 20, alarmEditTitleText);
+ui::Menu alarmEditor(0, 14, 4, 10, 16, 4, alarmFieldSelection, alarmFieldItem);
+ui::Widget* const alarmEditWidgets[] = {&alarmEditTitle, &alarmEditor};
+ui::View alarmEditView(alarmEditWidgets);
 
-    servo.attach(servoPin, 500, 2400);
-    pinMode(GREEN_BUTTON_PIN, INPUT_PULLUP);
-    pinMode(RED_BUTTON_PIN, INPUT_PULLUP);
-    pinMode(BLUE_BUTTON_PIN, INPUT_PULLUP);
-    pinMode(GREEN_LED_PIN, OUTPUT);
-    pinMode(RED_LED_PIN, OUTPUT);
+void countdownSetText(char* out, size_t size) {
+    snprintf(out, size, "Time: %02d:%02d", countdownHour, countdownMinute);
+}
+void countdownTitleText(char* out, size_t size) {
+    int total = timerService.count(TIMER_COUNTDOWN);
+    int index = 0;  // Urutan countdown yang ditampilkan di antara yang aktif
+    for (int id = 0; id <= countdownId; id++) {
+        if (timerService.isActive(id) && timerService.kind(id) == TIMER_COUNTDOWN) index++;
+    }
+    if (total > 1) {
+        snprintf(out, size, "Countdown %d/%d:", index, total);
+    } else {
+        snprintf(out, size, "Countdown:");
+    }
+}
+void countdownRunText(char* out, size_t size) {
+    // Dibulatkan ke atas: 00:00:00 hanya tampil saat countdown benar-benar selesai
+    uint64_t left = timerService.remainingUs(countdownId);
+    formatDuration(out, size, (left + 999999) / 1000000 * 1000000, 0);
+}
+void countdownStateText(char* out, size_t size) {
+    snprintf(out, size, "%s", timerService.isRunning(countdownId) ? "" : "Paused");
+}
 
-    if (!rtc.begin()) {
-        Serial.println("RTC not found");
+ui::Label countdownSetTitle(0, 0, 1, "Set Countdown:");
+ui::ValueField countdownSetField(0, 10, 1, 11, countdownSetText);
+ui::Widget* const countdownSetWidgets[] = {&countdownSetTitle, &countdownSetField};
+ui::View countdownSetView(countdownSetWidgets);
+
+ui::ValueField countdownRunTitle(0, 0, 1, 16, countdownTitleText);
+ui::ValueField countdownRunField(0, 8, 1, 8, countdownRunText);
+ui::ValueField countdownStateField(0, 20, 1, 6, countdownStateText);
+ui::Widget* const countdownRunWidgets[] = {&countdownRunTitle, &countdownRunField, &countdownStateField};
+ui::View countdownRunView(countdownRunWidgets);
+
+ui::Label countdownDoneTitle(0, 0, 2, "Countdown");
+ui::Label countdownDoneText(0, 20, 2, "Finished!");
+ui::Widget* const countdownDoneWidgets[] = {&countdownDoneTitle, &countdownDoneText};
+ui::View countdownDoneView(countdownDoneWidgets);
+
+void stopwatchText(char* out, size_t size) {
+    char elapsed[16];
+    formatDuration(elapsed, sizeof(elapsed), timerService.elapsedUs(stopwatchId), 1);
+    snprintf(out, size, "%s %s", timerService.isRunning(stopwatchId) ? "Time:" : "Paused:", elapsed);
+}
+// Baris lap, ROW = 0 lap terbaru
+template <int ROW>
+void stopwatchLapText(char* out, size_t size) {
+    uint32_t laps = timerService.isActive(stopwatchId) ? timerService.lapCount(stopwatchId) : 0;
+    if ((uint32_t)ROW >= laps) {
+        out[0] = '\0';
+        return;
     }
-    if (!rtc.isrunning()) {
-        Serial.println("RTC is NOT running!");
-        rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+    uint32_t n = laps - 1 - ROW;
+    char lap[16];
+    formatDuration(lap, sizeof(lap), timerService.lapUs(stopwatchId, n), 3);
+    snprintf(out, size, "L%-3lu %s", (unsigned long)(n + 1), lap);
+}
+
+ui::Label stopwatchTitle(0, 0, 2, "Stopwatch:");
+ui::ValueField stopwatchField(0, 20, 1, 18, stopwatchText);
+ui::ValueField stopwatchLap0(0, 32, 1, 17, stopwatchLapText<0>);
+ui::ValueField stopwatchLap1(0, 42, 1, 17, stopwatchLapText<1>);
+ui::ValueField stopwatchLap2(0, 52, 1, 17, stopwatchLapText<2>);
+ui::Widget* const stopwatchWidgets[] = {&stopwatchTitle, &stopwatchField, &stopwatchLap0, &stopwatchLap1,
+                                        &stopwatchLap2};
+ui::View stopwatchView(stopwatchWidgets);
+
+// Alarm berbunyi: bingkai berkedip dari empat garis, teks tidak ikut digambar ulang
+int32_t ringBlink() { return (millis() / 250) & 1; }
+void ringTimeText(char* out, size_t size) {
+    const AlarmSpec& spec = alarmService.get(alarmService.ringingSlot());
+    snprintf(out, size, "%02d:%02d", spec.hour, spec.minute);
+}
+
+ui::Icon ringTop({0, 0, 128, 1}, ringBlink, paintFill);
+ui::Icon ringBottom({0, 63, 128, 1}, ringBlink, paintFill);
+ui::Icon ringLeft({0, 0, 1, 64}, ringBlink, paintFill);
+ui::Icon ringRight({127, 0, 1, 64}, ringBlink, paintFill);
+ui::Label ringTitle(4, 4, 2, "Alarm!");
+ui::ValueField ringTime(4, 22, 2, 5, ringTimeText);
+ui::Label ringSnooze(4, 44, 1, "Red: snooze");
+ui::Label ringStop(4, 53, 1, "Green/Blue: stop");
+ui::Widget* const ringWidgets[] = {&ringTop, &ringBottom, &ringLeft, &ringRight,
+                                   &ringTitle, &ringTime, &ringSnooze, &ringStop};
+ui::View ringView(ringWidgets);
+
+// Mode 4: tren; grafik digambar ulang setiap ada sampel atau pilihan berubah
+void trendTitleText(char* out, size_t size) {
+    static const char* const names[TREND_METRICS] = {"Temp C", "Humidity %", "Light lux"};
+    snprintf(out, size, "%s", names[trendMetric]);
+}
+void trendWindowText(char* out, size_t size) { snprintf(out, size, "%s", TrendService::windowLabel(trendWindow)); }
+void trendSummaryText(char* out, size_t size) {
+    TrendSummary summary = trendService.summary(trendWindow, trendMetric);
+    if (summary.count == 0) {
+        out[0] = '\0';
+        return;
     }
+    char low[12];
+    char mean[12];
+    char high[12];
+    formatTrendValue(low, sizeof(low), trendMetric, summary.min);
+    formatTrendValue(mean, sizeof(mean), trendMetric, summary.mean);
+    formatTrendValue(high, sizeof(high), trendMetric, summary.max);
+    snprintf(out, size, "%s~%s ^%s", low, mean, high);
+}
+void trendEmptyText(char* out, size_t size) {
+    snprintf(out, size, "%s", trendService.summary(trendWindow, trendMetric).count ? "" : "No data yet");
+}
+int32_t trendGraphState() { return (int32_t)(trendService.revision() << 4 | trendWindow << 2 | trendMetric); }
 
-    dhtSensor.setup(DHT_PIN, DHTesp::DHT22);
-    pinMode(LDR_PIN, INPUT);
+ui::ValueField trendTitle(0, 0, 1, 10, trendTitleText);
+ui::ValueField trendWindowLabel(104, 0, 1, 3, trendWindowText);
+ui::ValueField trendSummary(0, 9, 1, 21, trendSummaryText);
+ui::Icon trendGraph({0, 18, 128, 46}, trendGraphState, paintTrendGraph);
+ui::ValueField trendEmpty(0, 30, 1, 11, trendEmptyText);
+ui::Widget* const trendWidgets[] = {&trendTitle, &trendWindowLabel, &trendSummary, &trendGraph, &trendEmpty};
+ui::View trendView(trendWidgets);
 
+void setup() {
+    // Semua output Serial berupa frame telemetri, teks dikirim sebagai MSG_LOG
+    Serial.setTxBufferSize(1024);
+    Serial.begin(TELEMETRY_BAUD);
+    telemetry.begin(Serial);
+    telemetry.onCommand(handleTelemetryCommand);
+
+    // Hanya yang dibutuhkan frame pertama: panel, RTC dan state UI. Servo,
+    // sensor dan riwayat flash menyusul di bootTask setelah frame itu terkirim.
+    i2cBus.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+    bool oledFound;
+    {
+        // Driver Adafruit memakai Wire langsung; Wire sudah di-begin i2cBus
+        int panel = i2cBus.addDevice("ssd1306", SCREEN_ADDRESS, DISPLAY_I2C_CLOCK);
+        I2CBus::Session session(i2cBus, panel, I2C_PRIORITY_CONTROL);
+        oledFound = oled.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS, true, false);
+    }
+    if (!oledFound) {
+        telemetry.log().println(F("Failed to start SSD1306 OLED"));
+    }
+    screen.begin();
+    oled.clearDisplay();
+    renderer.begin();
+
+    buttons.begin(GREEN_BUTTON_PIN, RED_BUTTON_PIN, BLUE_BUTTON_PIN);
+    const uint8_t wakePins[] = {GREEN_BUTTON_PIN, RED_BUTTON_PIN, BLUE_BUTTON_PIN};
+    powerManager.begin(screen, wakePins, sizeof(wakePins));
+
+    // Satu-satunya pembacaan RTC yang memblokir saat boot
+    bool rtcFound = clockService.begin(i2cBus);
+    if (!rtcFound) {
+        telemetry.log().println("RTC not found");
+    } else if (!clockService.rtcRunning()) {
+        telemetry.log().println("RTC is NOT running!");
+        clockService.adjust(DateTime(F(__DATE__), F(__TIME__)));
+        rtcFound = false;  // Waktu saat state disimpan tidak bisa dibandingkan
+    }
+    clockService.onSecond(onClockSecond);
+    alarmService.begin(clockService.unixtime());
+    alarmService.onRing(onAlarmRing);
+    timerService.begin();
+    timerService.onExpire(onTimerExpire);
+
+    bootManager.begin(screen);
+    restoreUiState(rtcFound);
     lastInputTime = millis();
+
+    // Task polling tidak menunda light sleep; setelah bangun semuanya dijalankan sekali
+    inputTaskId = scheduler.add("input", inputTask, INPUT_PERIOD_MS, 1000);
+    scheduler.setPolling(inputTaskId, true);
+    scheduler.setPolling(scheduler.add("clock", clockTask, CLOCK_PERIOD_MS, 2000), true);
+    renderTaskId = scheduler.add("render", renderTask, RENDER_PERIOD_MS, 10000);
+    scheduler.setPolling(renderTaskId, true);
+    scheduler.setPolling(scheduler.add("display", displayTask, DISPLAY_POLL_PERIOD_MS, 100), true);
+    statsTaskId = scheduler.add("stats", statsTask, STATS_PERIOD_MS, 5000);
+    scheduler.setPolling(scheduler.add("telemetry", telemetryTask, TELEMETRY_PERIOD_MS, 1000), true);
+    scheduler.add("sample", sampleTask, SAMPLE_PERIOD_MS, 500);
+    scheduler.add("trend", trendTask, TREND_SAMPLE_MS, 500);
+    scheduler.add("history", historyTask, HISTORY_PERIOD_MS, 40000);  // Termasuk erase sektor ~30 ms
+    bootTaskId = scheduler.add("boot", bootTask, BOOT_STEP_PERIOD_MS, 40000);  // Termasuk scan riwayat di flash
+    scheduler.setPolling(bootTaskId, true);
+    bootManager.markSetupDone();
+    allocGuard.arm((AllocGuardMode)ALLOC_GUARD_MODE);  // Mulai dari sini loop tidak boleh memakai heap
 }
 
 void loop() {
-    // Check for button presses
-    green_button_state = digitalRead(GREEN_BUTTON_PIN);
-    red_button_state = digitalRead(RED_BUTTON_PIN);
-    blue_button_state = digitalRead(BLUE_BUTTON_PIN);
+    // Semua pekerjaan dijalankan oleh scheduler, tidak ada yang memblokir
+    scheduler.run();
+    powerManager.poll();
+    idleSleep();
+}
 
-    // Navigasi di mode default
-    if (!isInAlarmMode) {
-        if (red_button_state == LOW) {
-            selectedMode = (selectedMode - 1 + 4) % 4;
-            lastInputTime = millis();
-            delay(200);
-        } else if (blue_button_state == LOW) {
-            selectedMode = (selectedMode + 1) % 4;
+// UI diam: tidak ada tombol, animasi, layar penuh waktu, transfer atau data host yang tertunda.
+// Layar lain (sensor langsung, alarm, countdown/stopwatch) tetap memakai loop penuh.
+bool canSleep() {
+    if ((mode != 0 && mode != 4) || isInAlarmMode || alarmService.isRinging() || timerDoneShowing) {
+        return false;
+    }
+    if (historyExporting || telemetry.pending() > 0 || millis() - telemetry.lastRxMs() < POWER_HOST_GRACE_MS) {
+        return false;
+    }
+    if (buttons.isBusy() || !screen.isIdle() || scheduler.hasTriggered() || controlLoop.servo().moving()) {
+        return false;
+    }
+    // Loop kontrol (core 0) harus sempat berjalan sejak bangun terakhir, mis. untuk sampel DHT
+    return (int32_t)(controlLoop.snapshot().tickMs - powerManager.wakeMs()) >= 0;
+}
+
+// Light sleep sampai event berikutnya: task terjadwal, polling RTC, tick
+// detik (selama layar menyala), sampel DHT dan alarm. esp_timer (countdown)
+// dan tombol diurus PowerManager.
+void idleSleep() {
+    if (!powerManager.enabled()) {
+        return;
+    }
+    telemetry.pump();  // Sampel dari task setelah task telemetri ikut terkirim sebelum tidur
+    if (!canSleep()) {
+        return;
+    }
+    uint32_t sleepMs = scheduler.idleMs();
+    uint32_t clockMs = clockService.msUntilPoll();
+    if (clockMs < sleepMs) sleepMs = clockMs;
+    if (powerManager.display() != DISPLAY_OFF) {
+        uint32_t secondMs = 1000 - clockService.millisecond();
+        if (secondMs < sleepMs) sleepMs = secondMs;
+    }
+    int32_t dhtMs = (int32_t)(dhtService.nextSampleMs() - millis());
+    if (dhtMs < (int32_t)sleepMs) sleepMs = dhtMs > 0 ? dhtMs : 0;
+    uint32_t alarmAt = alarmService.nextFireTime();
+    if (alarmAt != 0) {
+        uint32_t now = clockService.unixtime();
+        uint32_t alarmMs = alarmAt > now ? (alarmAt - now) * 1000 - clockService.millisecond() : 0;
+        if (alarmMs < sleepMs) sleepMs = alarmMs;
+    }
+
+    Serial.flush();  // UART berhenti selama light sleep; habiskan FIFO TX dulu
+    if (!powerManager.sleep(sleepMs * 1000ULL)) {
+        return;
+    }
+    scheduler.afterSleep();
+    controlLoop.afterSleep();
+    if (powerManager.lastWake() == WAKE_BUTTON) {
+        buttons.resync(powerManager.wakeUs());
+    }
+}
+
+// Task boot: sebelum siap, inisialisasi tertunda dijalankan satu langkah per
+// run setelah frame pertama sampai ke panel; sesudahnya menyimpan state UI
+void bootTask() {
+    bootManager.poll();
+    if (!bootManager.ready()) {
+        if (bootManager.firstFrameShown()) {
+            initDeferred();
+        }
+        return;
+    }
+    saveUiState();
+    bootManager.tick();
+}
+
+void initDeferred() {
+    AllocGuard::Allow allow;  // Sekali saat boot: esp_timer, task kontrol, handle flash
+    switch (bootStep++) {
+        case 0:
+            dhtService.begin(DHT_PIN);
+            ldrService.begin(LDR_PIN);
+            break;
+        case 1:
+            controlLoop.begin(servoPin, GREEN_LED_PIN, RED_LED_PIN);
+            if (!controlLoop.start()) {
+                // Tanpa FreeRTOS: loop yang sama
+                scheduler.setPolling(scheduler.add("control", controlTask, CONTROL_PERIOD_MS, 8000), true);
+            }
+            break;
+        case 2:
+            if (!historyLog.begin()) {
+                telemetry.log().println("History partition not found");
+            }
+            break;
+        default:
+            trendService.begin(clockService.unixtime());  // Isi ulang grafik 24 jam dari flash
+            bootManager.markReady();
+            scheduler.setPeriod(bootTaskId, BOOT_PERIOD_MS);
+            bootManager.report(telemetry.log());
+            break;
+    }
+}
+
+void saveUiState() {
+    SavedUi state;
+    memset(&state, 0, sizeof(state));  // Padding ikut dibandingkan dan di-CRC
+    state.mode = mode;
+    state.selectedMode = selectedMode;
+    state.isInAlarmMode = isInAlarmMode;
+    state.alarmSubMode = alarmSubMode;
+    state.alarmState = alarmState;
+    state.countdownHour = countdownHour;
+    state.countdownMinute = countdownMinute;
+    state.countdownId = countdownId;
+    state.stopwatchId = stopwatchId;
+    state.trendWindow = trendWindow;
+    state.trendMetric = trendMetric;
+    timerService.snapshot(state.timers, clockService.offsetUs());
+    bootManager.save(&state, sizeof(state));
+}
+
+// Nilai di luar jangkauan (firmware lain) kembali ke default. Tanpa jam yang
+// valid timer tidak dipulihkan, karena lama perangkat mati tidak diketahui.
+bool restoreUiState(bool clockValid) {
+    SavedUi state;
+    if (!bootManager.restore(&state, sizeof(state))) {
+        return false;
+    }
+    mode = state.mode >= 0 && state.mode < MODE_COUNT ? state.mode : 0;
+    selectedMode = state.selectedMode >= 0 && state.selectedMode < MODE_COUNT ? state.selectedMode : 0;
+    countdownHour = state.countdownHour >= 0 && state.countdownHour < 24 ? state.countdownHour : 0;
+    countdownMinute = state.countdownMinute >= 0 && state.countdownMinute < 60 ? state.countdownMinute : 0;
+    trendWindow = state.trendWindow < TREND_WINDOWS ? (TrendWindow)state.trendWindow : TREND_1HOUR;
+    trendMetric = state.trendMetric < TREND_METRICS ? (TrendMetric)state.trendMetric : TREND_TEMPERATURE;
+
+    if (clockValid) {
+        timerService.restore(state.timers, clockService.offsetUs());
+    }
+    countdownId = timerService.isActive(state.countdownId) && timerService.kind(state.countdownId) == TIMER_COUNTDOWN
+                      ? state.countdownId
+                      : -1;
+    stopwatchId = timerService.isActive(state.stopwatchId) && timerService.kind(state.stopwatchId) == TIMER_STOPWATCH
+                      ? state.stopwatchId
+                      : -1;
+
+    isInAlarmMode = state.isInAlarmMode && mode == 3;
+    alarmSubMode = state.alarmSubMode >= 0 && state.alarmSubMode < 3 ? state.alarmSubMode : 0;
+    AlarmState restored = ALARM_MENU;
+    if (isInAlarmMode) {
+        switch (state.alarmState) {
+            case ALARM_LIST:
+            case ALARM_SET:  // Salinan yang sedang diedit tidak disimpan
+                restored = ALARM_LIST;
+                break;
+            case COUNTDOWN_SET:
+            case STOPWATCH:
+                restored = (AlarmState)state.alarmState;
+                break;
+            case COUNTDOWN_RUN:
+                restored = countdownId >= 0 ? COUNTDOWN_RUN : COUNTDOWN_SET;
+                break;
+        }
+    }
+    enterAlarmState(restored);
+    return true;
+}
+
+// Task input: proses event tombol dan ubah state, tanpa menggambar
+void inputTask() {
+    buttons.poll();
+
+    ButtonEvent event;
+    while (buttons.next(event)) {
+        // Layar mati: tekanan pertama hanya menyalakan layar
+        if (powerManager.display() == DISPLAY_OFF) {
+            buttons.consume(event.button);
             lastInputTime = millis();
-            delay(200);
+            powerManager.setDisplay(DISPLAY_ON);
+            scheduler.trigger(renderTaskId);
+            continue;
         }
 
-        if (green_button_state == LOW && previous_green_button_state == HIGH) {
-            pressStartTime = millis();
-        } else if (green_button_state == HIGH && previous_green_button_state == LOW) {
-            unsigned long pressDuration = millis() - pressStartTime;
-            if (pressDuration >= LONG_PRESS_DURATION) {
-                mode = 0; // Reset ke mode default
-                lastInputTime = millis();
+        // Merah/biru ikut auto-repeat saat ditahan, hijau dibedakan tekan singkat/lama
+        bool isStep = event.type == BUTTON_PRESS || event.type == BUTTON_REPEAT;
+        bool redPressed = event.button == BUTTON_RED && isStep;
+        bool bluePressed = event.button == BUTTON_BLUE && isStep;
+        bool greenShort = event.button == BUTTON_GREEN && event.type == BUTTON_SHORT_PRESS;
+        bool greenLong = event.button == BUTTON_GREEN && event.type == BUTTON_LONG_PRESS;
+        bool isRepeat = event.type == BUTTON_REPEAT;
+
+        if (!(redPressed || bluePressed || greenShort || greenLong)) {
+            continue;
+        }
+        lastInputTime = millis();
+        if (mode != 5) {
+            scheduler.trigger(renderTaskId);  // Gambar ulang segera setelah input; game tetap di jadwal frame
+        }
+        modeTransition.cancel();          // Input apa pun melewati animasi transisi
+
+        // Countdown selesai: tombol apa pun menutup layar selesai, tidak diteruskan ke mode
+        if (timerDoneShowing && !alarmService.isRinging()) {
+            if (!isRepeat) {
+                closeTimerDone();
+            }
+            continue;
+        }
+
+        // Alarm berbunyi menimpa mode apa pun: merah = tunda, hijau/biru = matikan
+        if (alarmService.isRinging()) {
+            if (isRepeat) {
+                continue;  // Tombol yang masih ditahan tidak ikut mematikan alarm berikutnya
+            }
+            if (redPressed) {
+                alarmService.snooze(clockService.unixtime());
             } else {
-                mode = selectedMode; // Pilih mode
+                alarmService.dismiss();
             }
-            lastInputTime = millis();
-            delay(200);
+            continue;
         }
-    } else {  // Di dalam mode alarm
-        // Handle mode alarm
-        if (red_button_state == LOW && previous_red_button_state == HIGH) {
-            alarmSubMode = (alarmSubMode - 1 + 3) % 3;  // Pindah ke opsi sebelumnya
-            lastInputTime = millis();
-            delay(200);
-        } else if (blue_button_state == LOW && previous_blue_button_state == HIGH) {
-            alarmSubMode = (alarmSubMode + 1) % 3;  // Pindah ke opsi berikutnya
-            lastInputTime = millis();
-            delay(200);
+
+        // Di layar tren merah/biru mengganti jendela dan besaran, bukan pilihan menu
+        if (mode == 4 && !isInAlarmMode && (redPressed || bluePressed)) {
+            handleTrendInput(redPressed, bluePressed);
+            continue;
         }
-        if (green_button_state == LOW && previous_green_button_state == HIGH) {
-            lastInputTime = millis();
-            switch (alarmSubMode) {
-                case 0:
-                    setAlarm();
-                    break;
-                case 1:
-                    handleCountdown();
-                    break;
-                case 2:
-                    handleStopwatch();
-                    break;
+
+        // Di game merah/biru dibaca sebagai tombol yang ditahan (handleGameMode), hijau = aksi game
+        if (mode == 5 && !isInAlarmMode && (redPressed || bluePressed || greenShort)) {
+            if (greenShort) {
+                game.action();
             }
+            continue;
         }
-    }
 
-    previous_green_button_state = green_button_state;
-    previous_red_button_state = red_button_state;
-    previous_blue_button_state = blue_button_state;
+        // Navigasi di mode default
+        if (!isInAlarmMode) {
+            if (redPressed) {
+                selectedMode = (selectedMode - 1 + MODE_COUNT) % MODE_COUNT;
+            } else if (bluePressed) {
+                selectedMode = (selectedMode + 1) % MODE_COUNT;
+            }
 
-    // Timeout untuk kembali ke mode default
-    if (millis() - lastInputTime > TIMEOUT_DURATION) {
+            if (greenLong) {
+                mode = 0; // Reset ke mode default
+            } else if (greenShort) {
+                mode = selectedMode; // Pilih mode
+                if (mode == 1 || mode == 2) {
+                    modeTransition.start(MODE_TRANSITION_MS);
+                } else if (mode == 5) {
+                    game.reset(micros());
+                }
+            }
+        } else {  // Di dalam mode alarm
+            handleAlarmInput(redPressed, bluePressed, greenShort, greenLong, isRepeat);
+        }
+    }
+
+    // Timeout untuk kembali ke mode default (submode alarm tetap berjalan)
+    if (!isInSubMode && millis() - lastInputTime > TIMEOUT_DURATION) {
         mode = 0;
+        isInAlarmMode = false;
+    }
+    syncControl();
+}
+
+// Tukar state dengan loop kontrol: mode output dan indikator LED dikirim saat
+// berubah, bacaan sensor baru memicu gambar ulang layar yang menampilkannya
+void syncControl() {
+    ControlMode output = CONTROL_HOLD;
+    if (mode == 1) {
+        output = CONTROL_FOLLOW_DHT;
+    } else if (mode == 2) {
+        output = CONTROL_FOLLOW_LIGHT;
+    }
+    controlLoop.setMode(output);
+    controlLoop.setLowPower(powerManager.enabled() && output != CONTROL_FOLLOW_LIGHT);
+
+    if (alarmService.isRinging()) {
+        controlLoop.setIndicator(INDICATOR_ALARM);
+    } else {
+        controlLoop.setIndicator(timerDoneShowing ? INDICATOR_TIMER : INDICATOR_NONE);
+    }
+
+    ControlEvent event;
+    while (controlLoop.nextEvent(event)) {
+        if ((event.type == CONTROL_EVENT_DHT && mode == 1) || (event.type == CONTROL_EVENT_LIGHT && mode == 2)) {
+            scheduler.trigger(renderTaskId);
+        }
     }
+}
+
+// Layar diredupkan setelah TIMEOUT_DURATION tanpa input dan dimatikan setelah
+// DISPLAY_OFF_DURATION; alarm, countdown selesai dan submode alarm tetap terang
+void updateDisplayPower() {
+    if (!powerManager.enabled()) {
+        return;
+    }
+    unsigned long idle = millis() - lastInputTime;
+    DisplayPower level = DISPLAY_ON;
+    if (!alarmService.isRinging() && !timerDoneShowing && !isInSubMode) {
+        if (idle > DISPLAY_OFF_DURATION) {
+            level = DISPLAY_OFF;
+        } else if (idle > TIMEOUT_DURATION) {
+            level = DISPLAY_DIM;
+        }
+    }
+    powerManager.setDisplay(level);
+}
 
-    // Menjalankan mode yang dipilih
+// Task render: menggambar mode yang dipilih, satu frame per panggilan jika ada yang berubah
+void renderTask() {
+    // Run yang dipicu input/event tidak dihitung sebagai jitter, hanya menjadi acuan baru
+    if (scheduler.triggeredRun()) {
+        renderJitter.sync(micros());
+    } else {
+        renderJitter.mark(micros(), scheduler.period(renderTaskId) * 1000);
+    }
+    updateDisplayPower();
+    if (powerManager.display() == DISPLAY_OFF) {
+        return;  // Isi GDDRAM tetap; yang berubah dikirim saat layar menyala lagi
+    }
+    if (alarmService.isRinging()) {
+        drawAlarmRinging();
+        renderedMode = -1;  // Layar mode digambar penuh lagi setelah alarm selesai
+        return;
+    }
+    if (timerDoneShowing) {
+        drawTimerDone();
+        renderedMode = -1;
+        return;
+    }
+    if (renderedMode != mode) {
+        renderer.invalidate();  // Framebuffer berisi layar lain
+        game.invalidate();
+        setRenderFast(mode == 5);  // Game memakai frame rate penuh selama mode aktif
+        renderedMode = mode;
+    }
     switch (mode) {
         case 0:
             displayTimeWithMenu();
@@ -188,450 +871,752 @@ void loop() {
         case 3:
             handleAlarmMode();
             break;
+        case 4:
+            handleTrendMode();
+            break;
+        case 5:
+            handleGameMode();
+            break;
     }
 }
 
-// Function to display the current time, date, and menu with mode selection
-void displayTimeWithMenu() {
-    DateTime now = rtc.now();
-    oled.clearDisplay();
-    oled.setTextSize(1);
-    oled.setTextColor(WHITE);
-    oled.setCursor(0, 0);
-    oled.printf("%02d:%02d:%02d", now.hour(), now.minute(), now.second());
-    oled.setCursor(0, 14);
-    oled.printf("%02d/%02d/%04d", now.day(), now.month(), now.year());
-
-    oled.setCursor(0, 25);
-    oled.setTextSize(1);
-    for (int i = 1; i < 4; i++) {
-        oled.setCursor(0, 25 + (i - 1) * 12);
-        if (i == selectedMode) {
-            oled.print("> ");
-        } else {
-            oled.print("  ");
+// Task display: serahkan frame yang tertunda ke task transfer
+void displayTask() {
+    screen.poll();
+}
+
+// Task telemetri: jalankan perintah yang masuk dan kirim isi ring TX tanpa memblokir
+void telemetryTask() {
+    telemetry.poll();
+    exportHistory();
+    traceRecorder.pump();
+    telemetry.pump();
+}
+
+struct HistoryChunk {
+    HistoryPointPayload points[HISTORY_POINTS_PER_FRAME];
+    size_t count;
+};
+
+bool collectHistoryPoint(const HistoryRecord& record, void* context) {
+    HistoryChunk* chunk = static_cast<HistoryChunk*>(context);
+    HistoryPointPayload& point = chunk->points[chunk->count++];
+    point.time = record.time;
+    point.temperatureCenti = record.temperatureCenti;
+    point.humidityDeci = record.humidityDeci;
+    point.lux = record.lux;
+    point.flags = record.dhtValid ? SAMPLE_DHT_VALID : 0;
+    return chunk->count < HISTORY_POINTS_PER_FRAME;
+}
+
+// Satu frame MSG_HISTORY per tick, hanya jika ring TX masih muat.
+// Frame berikutnya dilanjutkan dari detik setelah titik terakhir.
+void exportHistory() {
+    if (!historyExporting || telemetry.space() < TELEMETRY_MAX_ENCODED) {
+        return;
+    }
+    HistoryChunk chunk;
+    chunk.count = 0;
+    historyLog.query(historyExportFrom, historyExportTo, collectHistoryPoint, &chunk);
+    telemetry.send(MSG_HISTORY, chunk.points, chunk.count * sizeof(HistoryPointPayload));
+    if (chunk.count < HISTORY_POINTS_PER_FRAME) {
+        historyExporting = false;  // Frame tidak penuh menandai akhir ekspor
+        return;
+    }
+    historyExportFrom = chunk.points[chunk.count - 1].time + 1;
+}
+
+// Task tren: sampel sensor terbaru ke jendela 1 menit, 1 jam dan 24 jam
+void trendTask() {
+    ControlSnapshot state = controlLoop.snapshot();
+    const DhtReading& dht = state.dht;
+    const LdrReading& ldr = state.ldr;
+    uint64_t timeMs = (uint64_t)clockService.unixtime() * 1000 + clockService.millisecond();
+    int32_t temperature = dht.valid ? lroundf(dht.temperature * 100) : 0;
+    int32_t humidity = dht.valid ? lroundf(dht.humidity * 10) : 0;
+    trendService.add(timeMs, dht.valid, temperature, humidity, ldr.valid, ldr.lux);
+}
+
+// Task riwayat: satu rekaman sensor per HISTORY_PERIOD_MS ke log flash
+void historyTask() {
+    ControlSnapshot state = controlLoop.snapshot();
+    const DhtReading& dht = state.dht;
+    const LdrReading& ldr = state.ldr;
+    if (dht.valid || ldr.valid) {
+        HistoryRecord record = {clockService.unixtime(), 0, 0, ldr.lux, dht.valid};
+        if (dht.valid) {
+            record.temperatureCenti = (int16_t)lroundf(dht.temperature * 100);
+            record.humidityDeci = (uint16_t)lroundf(dht.humidity * 10);
         }
-        oled.print(modes[i]);
+        historyLog.append(record);
     }
-    oled.display();
+    historyLog.tick(millis());
 }
 
-// Mode 1: Handling DHT Sensor
-void handleDHTMode() {
-    if (!isDHTModeInitialized) {
-        oled.clearDisplay();
-        oled.setTextSize(1);
-        oled.setTextColor(WHITE);
-        for (int i = 0; i < 128; i += 32) {
-            oled.clearDisplay();
-            oled.fillRect(i, 0, 32, 64, WHITE);
-            oled.display();
-            delay(100);
+// Task sampel: kirim nilai sensor, servo dan mode ke host
+void sampleTask() {
+    ControlSnapshot state = controlLoop.snapshot();
+    const DhtReading& dht = state.dht;
+    const LdrReading& ldr = state.ldr;
+
+    SamplePayload sample = {};
+    sample.uptimeMs = millis();
+    if (dht.valid) {
+        sample.temperatureCenti = (int16_t)lroundf(dht.temperature * 100);
+        sample.humidityDeci = (uint16_t)lroundf(dht.humidity * 10);
+        sample.flags |= SAMPLE_DHT_VALID;
+    }
+    sample.lux = ldr.lux;
+    if (ldr.dark) sample.flags |= SAMPLE_DARK;
+    if (alarmService.isRinging()) sample.flags |= SAMPLE_ALARM_RINGING;
+    sample.servo = state.servo;
+    sample.mode = mode;
+    telemetry.send(MSG_SAMPLE, &sample, sizeof(sample));
+}
+
+// Perintah dari host; return status untuk frame ACK
+uint8_t handleTelemetryCommand(uint8_t type, const uint8_t* payload, size_t length) {
+    if (type != CMD_TRACE) {
+        traceRecorder.command(type, payload, length);  // Perintah host ikut diputar ulang saat replay
+    }
+    switch (type) {
+        case CMD_SET_ALARM: {
+            SetAlarmPayload cmd;
+            if (length != sizeof(cmd)) return ACK_INVALID;
+            memcpy(&cmd, payload, sizeof(cmd));
+            AlarmSpec spec = {cmd.hour, cmd.minute, cmd.days, cmd.enabled, 0};
+            return alarmService.set(cmd.slot, spec, clockService.unixtime()) ? ACK_OK : ACK_INVALID;
+        }
+        case CMD_START_COUNTDOWN: {
+            CountdownPayload cmd;
+            if (length != sizeof(cmd)) return ACK_INVALID;
+            memcpy(&cmd, payload, sizeof(cmd));
+            if (cmd.seconds == 0 || cmd.seconds >= 24 * 3600UL) return ACK_INVALID;
+            return startCountdown(cmd.seconds * 1000UL) ? ACK_OK : ACK_BUSY;
+        }
+        case CMD_SET_MODE: {
+            ModePayload cmd;
+            if (length != sizeof(cmd)) return ACK_INVALID;
+            memcpy(&cmd, payload, sizeof(cmd));
+            if (cmd.mode >= MODE_COUNT) return ACK_INVALID;
+            enterAlarmState(ALARM_MENU);
+            isInAlarmMode = false;
+            mode = cmd.mode;
+            selectedMode = cmd.mode;
+            if (mode == 1 || mode == 2) {
+                modeTransition.start(MODE_TRANSITION_MS);
+            } else if (mode == 5) {
+                game.reset(micros());
+            }
+            lastInputTime = millis();
+            scheduler.trigger(renderTaskId);
+            return ACK_OK;
+        }
+        case CMD_QUERY_STATS: {
+            if (length != 0) return ACK_INVALID;
+            StatsPayload stats = {};
+            stats.uptimeMs = millis();
+            stats.loopAvgUs = scheduler.loopAvgUs();
+            stats.loopMaxUs = scheduler.loopMaxUs();
+            stats.frames = screen.stats().frames;
+            stats.framesDropped = screen.stats().framesDropped;
+            stats.txDropped = telemetry.stats().framesDropped;
+            stats.rxErrors = telemetry.stats().rxErrors;
+            HeapStats heap = AllocGuard::heap();
+            stats.freeHeap = heap.freeHeap;
+            stats.minFreeHeap = heap.minFreeHeap;
+            stats.largestFreeBlock = heap.largestFreeBlock;
+            stats.allocations = allocGuard.stats().allocations;
+            telemetry.send(MSG_STATS, &stats, sizeof(stats));
+            return ACK_OK;
         }
-        oled.clearDisplay();
-        isDHTModeInitialized = true;
+        case CMD_PROFILE: {
+            ProfilePayload cmd;
+            if (length != sizeof(cmd)) return ACK_INVALID;
+            memcpy(&cmd, payload, sizeof(cmd));
+            if (cmd.reset) {
+                profiler.reset();
+            } else {
+                profiler.report(telemetry.log());
+            }
+            return ACK_OK;
+        }
+        case CMD_HISTORY: {
+            HistoryQueryPayload cmd;
+            if (length != sizeof(cmd)) return ACK_INVALID;
+            memcpy(&cmd, payload, sizeof(cmd));
+            if (cmd.from > cmd.to || !historyLog.mounted()) return ACK_INVALID;
+            historyExportFrom = cmd.from;
+            historyExportTo = cmd.to;
+            historyExporting = true;
+            return ACK_OK;
+        }
+        case CMD_TRACE: {
+            TracePayload cmd;
+            if (length != sizeof(cmd)) return ACK_INVALID;
+            memcpy(&cmd, payload, sizeof(cmd));
+            if (cmd.enable) {
+                // Bacaan terakhir jadi state awal replay; ADC terfilter dikembalikan ke skala blok
+                ControlSnapshot state = controlLoop.snapshot();
+                traceRecorder.start(clockService.unixtime(), state.dht.valid, state.dht.temperature,
+                                    state.dht.humidity, (uint16_t)(state.ldr.adc * LDR_OVERSAMPLE));
+            } else {
+                traceRecorder.stop();
+            }
+            return ACK_OK;
+        }
+        default:
+            return ACK_UNKNOWN;
     }
+}
 
-    TempAndHumidity data = dhtSensor.getTempAndHumidity();
-    float temperature = data.temperature;
-    float humidity = data.humidity;
+// Task jam: kunci fase/resync RTC, event pergantian detik, dan jadwal alarm
+void clockTask() {
+    clockService.tick();
+    alarmService.tick(clockService.unixtime());
+    timerService.tick();
+}
 
-    String status;
-    if (temperature < 20.0) {
-        status = "Dingin";
-    } else if (temperature < 25.0) {
-        status = "Netral";
-    } else if (temperature < 30.0) {
-        status = "Hangat";
-    } else {
-        status = "Panas";
+// Detik berganti: layar yang menampilkan jam digambar ulang tanpa menunggu periode render
+void onClockSecond(uint32_t unixtime) {
+    if (mode == 0 || mode == 3) {
+        scheduler.trigger(renderTaskId);
     }
+}
+
+// Alarm mulai berbunyi: tampilkan segera, apa pun mode yang aktif
+void onAlarmRing(int slot) {
+    scheduler.trigger(renderTaskId);
+}
+
+// Countdown selesai di background: layar selesai dan LED berkedip di atas mode apa pun
+void onTimerExpire(int id) {
+    timerDoneShowing = true;
+    timerDoneSince = millis();
+    scheduler.trigger(renderTaskId);
+}
+
+// Task kontrol tanpa FreeRTOS (build native): sensor dan aktuator di loop yang sama
+void controlTask() {
+    controlLoop.tick();
+}
+
+// Task statistik: laporkan latensi loop lewat frame log telemetri
+void statsTask() {
+    scheduler.report(telemetry.log());
+    screen.report(telemetry.log());
+    i2cBus.report(telemetry.log());
+    buttons.report(telemetry.log());
+    dhtService.report(telemetry.log());
+    controlLoop.report(telemetry.log());
+    renderJitter.report(telemetry.log());
+    clockService.report(telemetry.log());
+    alarmService.report(telemetry.log());
+    timerService.report(telemetry.log());
+    powerManager.report(telemetry.log());
+    bootManager.report(telemetry.log());  // Tidak di-reset
+    renderer.report(telemetry.log());
+    game.report(telemetry.log());
+    historyLog.report(telemetry.log());
+    traceRecorder.report(telemetry.log());
+    telemetry.report(telemetry.log());
+    allocGuard.report(telemetry.log());  // Kumulatif sejak setup(), tidak di-reset
+    scheduler.resetStats();
+    screen.resetStats();
+    i2cBus.resetStats();
+    buttons.resetStats();
+    dhtService.resetStats();
+    controlLoop.resetStats();
+    renderJitter.resetStats();
+    clockService.resetStats();
+    alarmService.resetStats();
+    timerService.resetStats();
+    powerManager.resetStats();
+    renderer.resetStats();
+    game.resetStats();
+    historyLog.resetStats();
+    traceRecorder.resetStats();
+    telemetry.resetStats();
+}
+
+// Function to display the current time, date, and menu with mode selection
+void displayTimeWithMenu() {
+    PROFILE_SCOPE("mode.time");
+    renderer.render(timeView);
+}
 
-    static int drawFrame = 0;
+// Selama animasi berjalan render memakai frame rate penuh, selain itu hemat
+void setRenderFast(bool fast) {
+    scheduler.setPeriod(renderTaskId, fast ? RENDER_FAST_PERIOD_MS : RENDER_PERIOD_MS);
+}
 
+// Animasi wipe saat masuk mode, posisi dihitung dari timeline (bukan delay).
+// Return true selama animasi masih berjalan.
+bool drawModeTransition() {
+    uint8_t progress = modeTransition.progress();
+    if (!modeTransition.isActive()) {
+        setRenderFast(false);
+        return false;
+    }
+    setRenderFast(true);
+    if (!screen.beginFrame()) {
+        return true;
+    }
+    int x = (progress * 128) >> 8;
     oled.clearDisplay();
-    oled.setTextSize(1);
-    oled.setTextColor(WHITE);
-    oled.setCursor(0, 0);
-    oled.println("DHT22 Data:");
-    oled.printf("Temp: %.2f C\n", temperature);
-    oled.printf("Humidity: %.1f%%\n", humidity);
-    oled.printf("Status: %s\n", status.c_str());
-    oled.display();
-
-    drawAnimation(drawFrame);
-    oled.display();
-
-    drawFrame = (drawFrame + 1) % 10;
-
-    float minTemperature = 15.0;
-    float maxTemperature = 35.0;
-    float middleTemperature = (minTemperature + maxTemperature) / 2;
-
-    int servoPos = map(temperature, minTemperature, maxTemperature, 0, 180);
-    servo.write(servoPos);
-
-    if (temperature < middleTemperature) {
-        digitalWrite(RED_LED_PIN, HIGH);
-        digitalWrite(GREEN_LED_PIN, LOW);
-    } else {
-        digitalWrite(RED_LED_PIN, LOW);
-        digitalWrite(GREEN_LED_PIN, HIGH);
+    oled.fillRect(x, 0, 32, 64, WHITE);
+    screen.flush();
+    renderer.invalidate();  // Layar mode digambar penuh setelah wipe selesai
+    return true;
+}
+
+// Mode 1: Handling DHT Sensor
+void handleDHTMode() {
+    PROFILE_SCOPE("mode.dht");
+    if (drawModeTransition()) {
+        return;
+    }
+
+    // Widget membaca snapshot controlLoop, render tidak pernah menunggu sensor.
+    // Servo dan LED mengikuti suhu di loop kontrol (CONTROL_FOLLOW_DHT).
+    {
+        PROFILE_SCOPE("dht.draw");
+        renderer.render(dhtView);
     }
-    delay(100);
+
+    dhtFrame = (dhtFrame + 1) % 10;
 }
 
-void drawAnimation(int frame) {
-    int baseY = 54;
-    for (int i = 0; i < 128; i += 12) {
-        int flameHeight = random(3, 8);
+// Api di bawah layar DHT, tinggi dari tabel (bukan random())
+void paintFlames(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t frame) {
+    int baseY = bounds.y + bounds.h - 1;
+    for (int i = 0; i < bounds.w; i += 12) {
+        int flameHeight = anim::FLAME_HEIGHTS.value[(frame * 11 + i / 12) & 63];
         int offset = (frame + i) % 12;
-        oled.drawLine(i + offset, baseY, i + offset, baseY - flameHeight, WHITE);
+        gfx.drawLine(i + offset, baseY, i + offset, baseY - flameHeight, WHITE);
     }
 }
 
 // Mode 2: Handling LDR sensor
 void handleLDRMode() {
-    if (!isLDRModeInitialized) {
-        oled.clearDisplay();
-        oled.setTextSize(1);
-        oled.setTextColor(WHITE);
-        for (int i = 0; i < 128; i += 32) {
-            oled.clearDisplay();
-            oled.fillRect(i, 0, 32, 64, WHITE);
-            oled.display();
-            delay(100);
-        }
-        oled.clearDisplay();
-        isLDRModeInitialized = true;
+    PROFILE_SCOPE("mode.ldr");
+    if (drawModeTransition()) {
+        return;
     }
 
-    int ldrValue = analogRead(LDR_PIN);
-    
-    // Mengonversi nilai LDR menjadi lux
-    int lux = map(ldrValue, 0, 4095, 0, 1000);
-    String status = (lux < 500) ? "Gelap" : "Terang";
+    // Lux sudah disaring dan dikalibrasi oleh ldrService, tanpa analogRead di sini.
+    // Servo dan LED mengikuti lux di loop kontrol (CONTROL_FOLLOW_LIGHT).
+    bool isDark = controlLoop.snapshot().ldr.dark;  // Dengan hysteresis, tidak bergetar di sekitar 500 lux
 
-    oled.clearDisplay();
-    oled.setTextSize(1);
-    oled.setTextColor(WHITE);
-    oled.setCursor(0, 0);
-    oled.printf("Lux: %d\n", lux);
-    oled.printf("Status: %s\n", status.c_str());
-
-    // Animasi matahari/bulan berdasarkan status "gelap" atau "terang"
-    if (lux < 500) {
-        // Gambar bulan
-        oled.fillCircle(108, 20, 10, WHITE);
-        oled.fillCircle(104, 16, 8, BLACK); // Bentuk bulan sabit
-
-        // Gambar bintang
-        for (int i = 0; i < 5; i++) {
-            int x = random(128); // Posisi acak bintang
-            int y = random(64);
-            oled.drawPixel(x, y, WHITE);
-        }
-
-        static int flameFrame = 0;
-        // Tambahkan animasi gelombang
-        for (int x = 0; x < 128; x++) {
-            int y = 32 + (sin((x + flameFrame) * 0.1) * 10); // Gelombang sinus
-            oled.drawPixel(x, y, WHITE);
-        }
-        flameFrame = (flameFrame + 1) % 360; // Update frame animasi
+    {
+        PROFILE_SCOPE("ldr.draw");
+        renderer.render(ldrView);
+    }
+    if (isDark) {
+        ldrSkyFrame = (ldrSkyFrame + 1) % 360;  // Update frame animasi
+    }
+}
 
+// Matahari dan awan saat terang, bulan sabit saat gelap
+void paintWeather(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t dark) {
+    if (dark) {
+        gfx.fillCircle(108, 20, 10, WHITE);
+        gfx.fillCircle(104, 16, 8, BLACK);  // Bentuk bulan sabit
     } else {
-        // Gambar matahari
-        oled.fillCircle(108, 20, 10, WHITE); // Matahari
-        oled.display();
+        gfx.fillCircle(108, 20, 10, WHITE);  // Matahari
+        gfx.fillCircle(50, 20, 8, WHITE);    // Tengah awan
+        gfx.fillCircle(62, 20, 6, WHITE);    // Kanan awan
+        gfx.fillCircle(38, 20, 6, WHITE);    // Kiri awan
+    }
+}
 
-        // Tambahkan animasi awan
-        oled.fillCircle(50, 20, 8, WHITE); // Tengah awan
-        oled.fillCircle(62, 20, 6, WHITE); // Kanan awan
-        oled.fillCircle(38, 20, 6, WHITE); // Kiri awan
+// Bintang dan gelombang saat gelap; state 0 = terang, selain itu frame + 1
+void paintNightSky(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t state) {
+    if (state == 0) {
+        return;
     }
+    int frame = state - 1;
 
-    // Tambahkan progress bar untuk menggambarkan lux
-    int barLength = map(lux, 0, 1000, 0, 128);  // Bar sepanjang 128 pixel
-    oled.fillRect(0, 50, barLength, 10, WHITE); // Bar horizontal di bagian bawah layar
+    // Bintang di posisi "acak" dari tabel, diskalakan ke area langit
+    for (int i = 0; i < 5; i++) {
+        int star = (frame * 5 + i) & 63;
+        gfx.drawPixel(anim::STAR_X.value[star], bounds.y + anim::STAR_Y.value[star] * bounds.h / 64, WHITE);
+    }
 
-    oled.display();
+    // Gelombang: sin((x + frame) * 0.1) dari tabel Q15,
+    // 0.1 rad = 4.074 langkah tabel = 1043 / 256
+    int center = bounds.y + bounds.h / 2;
+    for (int x = 0; x < bounds.w; x++) {
+        uint8_t phase = ((x + frame) * 1043) >> 8;
+        gfx.drawPixel(x, center + ((anim::sinQ15(phase) * 10) >> 15), WHITE);
+    }
+}
 
-    // Kontrol servo berdasarkan nilai lux
-    int servoPos = map(lux, 0, 1000, 0, 180);
-    servo.write(servoPos);
+// Nilai tren dalam satuan tampilan (fixed-point -> teks)
+void formatTrendValue(char* out, size_t size, TrendMetric metric, int32_t value) {
+    if (metric == TREND_TEMPERATURE) {
+        formatFixed(out, size, (value + (value < 0 ? -5 : 5)) / 10, 1);  // 0.01 C -> 0.1 C
+    } else if (metric == TREND_HUMIDITY) {
+        formatFixed(out, size, value, 1);
+    } else {
+        formatFixed(out, size, value, 0);
+    }
+}
 
-    // Kontrol LED berdasarkan lux
-    if (lux < 500) {
-        digitalWrite(GREEN_LED_PIN, LOW);
-        digitalWrite(RED_LED_PIN, HIGH);
+// Fixed-point ke teks tanpa printf float; %f di newlib mengambil buffer dtoa
+// dari heap saat pertama dipakai di setiap task
+void formatFixed(char* out, size_t size, int32_t value, uint8_t decimals) {
+    uint32_t scale = decimals == 2 ? 100 : (decimals == 1 ? 10 : 1);
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    if (decimals == 0) {
+        snprintf(out, size, "%s%lu", value < 0 ? "-" : "", (unsigned long)magnitude);
     } else {
-        digitalWrite(GREEN_LED_PIN, HIGH);
-        digitalWrite(RED_LED_PIN, LOW);
+        snprintf(out, size, "%s%lu.%0*lu", value < 0 ? "-" : "", (unsigned long)(magnitude / scale), decimals,
+                 (unsigned long)(magnitude % scale));
     }
+}
 
-    delay(100);
+// Durasi us ke HH:MM:SS dengan 0, 1 atau 3 digit pecahan detik (dipotong, bukan dibulatkan)
+void formatDuration(char* out, size_t size, uint64_t us, uint8_t decimals) {
+    uint32_t seconds = (uint32_t)(us / 1000000);
+    uint32_t fraction = (uint32_t)(us % 1000000);
+    int length = snprintf(out, size, "%02lu:%02lu:%02lu", (unsigned long)(seconds / 3600),
+                          (unsigned long)(seconds / 60 % 60), (unsigned long)(seconds % 60));
+    if (decimals == 1 && length > 0 && (size_t)length < size) {
+        snprintf(out + length, size - length, ".%lu", (unsigned long)(fraction / 100000));
+    } else if (decimals == 3 && length > 0 && (size_t)length < size) {
+        snprintf(out + length, size - length, ".%03lu", (unsigned long)(fraction / 1000));
+    }
 }
 
-// Mode 3: Handling Alarm Mode with Countdown and Stopwatch
-void handleAlarmMode() {
-    if (!isInAlarmMode) {
-        alarmSubMode = 0;  // Reset ke pilihan pertama
-        isInAlarmMode = true;
+// Mode 4: grafik min/max/rata-rata per kolom, langsung dari bucket trendService
+void handleTrendMode() {
+    PROFILE_SCOPE("mode.trend");
+    renderer.render(trendView);
+}
+
+// Mode 5: game; arah kapal dari tombol yang sedang ditahan, merah = kiri, biru = kanan
+void handleGameMode() {
+    game.steer((int8_t)(buttons.isHeld(BUTTON_BLUE) - buttons.isHeld(BUTTON_RED)));
+    game.frame();
+}
+
+// Area grafik, skala mengikuti min/max jendela
+void paintTrendGraph(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t state) {
+    const TrendSeries& series = trendService.series(trendWindow, trendMetric);
+    TrendSummary summary = series.summary();
+    if (summary.count == 0) {
+        return;
     }
-    
-    // Tampilan mode alarm dengan kursor
-    oled.clearDisplay();
-    oled.setTextSize(1);
-    oled.setTextColor(WHITE);
-    oled.setCursor(0, 0);
-    oled.println("Alarm Mode:");
-
-     // Navigasi submode
-    for (int i = 0; i < 3; i++) {
-        oled.setCursor(0, 10 + (i * 10));
-        if (i == alarmSubMode) {
-            oled.print("> ");
-        } else {
-            oled.print("  ");
+    int32_t range = summary.max - summary.min;
+    if (range == 0) range = 1;
+    for (uint8_t x = 0; x < TREND_COLUMNS; x++) {
+        const TrendBucket& bucket = series.column(x);
+        if (bucket.count == 0) {
+            continue;
         }
-        if (i == 0) {
-            oled.print("Alarm");
-        } else if (i == 1) {
-            oled.print("Countdown");
-        } else if (i == 2) {
-            oled.print("Stopwatch");
+        int yMax = bounds.y + (int)((int64_t)(summary.max - bucket.max) * (bounds.h - 1) / range);
+        int yMin = bounds.y + (int)((int64_t)(summary.max - bucket.min) * (bounds.h - 1) / range);
+        int yMean = bounds.y + (int)((int64_t)(summary.max - bucket.sum / bucket.count) * (bounds.h - 1) / range);
+        gfx.drawFastVLine(x, yMax, yMin - yMax + 1, WHITE);
+        if (yMin - yMax >= 2) {
+            gfx.drawPixel(x, yMean, BLACK);  // Rata-rata bucket = titik gelap di dalam pita min-max
         }
     }
-    oled.display();
+}
 
-    // Navigasi menu alarm
-    if (red_button_state == LOW && previous_red_button_state == HIGH) {
-        alarmSubMode = (alarmSubMode - 1 + 3) % 3;  // Pindah ke opsi sebelumnya
-        lastInputTime = millis();
-        delay(200);  // Debounce delay
-    } else if (blue_button_state == LOW && previous_blue_button_state == HIGH) {
-        alarmSubMode = (alarmSubMode + 1) % 3;  // Pindah ke opsi berikutnya
-        lastInputTime = millis();
-        delay(200);  // Debounce delay
+// Merah: ganti jendela waktu, biru: ganti besaran
+void handleTrendInput(bool redPressed, bool bluePressed) {
+    if (redPressed) {
+        trendWindow = (TrendWindow)((trendWindow + 1) % TREND_WINDOWS);
+    } else if (bluePressed) {
+        trendMetric = (TrendMetric)((trendMetric + 1) % TREND_METRICS);
     }
+}
 
-    // Pilih submode alarm
-    if (green_button_state == LOW && previous_green_button_state == HIGH) {
-        lastInputTime = millis();
-        isInSubMode = true;
-        switch (alarmSubMode) {
-            case 0:
-                setAlarm();
-                break;
-            case 1:
-                handleCountdown();
-                break;
-            case 2:
-                handleStopwatch();
-                break;
-        }
-        isInSubMode = false;
-    }
+void enterAlarmState(AlarmState state) {
+    alarmState = state;
+    alarmStateSince = millis();
+    lastInputTime = millis();  // Timeout dihitung ulang setelah keluar dari submode
+    isInSubMode = state != ALARM_MENU;
+}
+
+// Input untuk mode alarm, tergantung state yang sedang aktif
+void handleAlarmInput(bool redPressed, bool bluePressed, bool greenShort, bool greenLong, bool isRepeat) {
+    switch (alarmState) {
+        case ALARM_MENU:
+            if (redPressed) {
+                alarmSubMode = (alarmSubMode - 1 + 3) % 3;  // Pindah ke opsi sebelumnya
+            } else if (bluePressed) {
+                alarmSubMode = (alarmSubMode + 1) % 3;  // Pindah ke opsi berikutnya
+            }
+            if (greenLong) {
+                isInAlarmMode = false;  // Kembali ke menu utama
+                mode = 0;
+            } else if (greenShort) {
+                if (alarmSubMode == 0) {
+                    enterAlarmState(ALARM_LIST);
+                } else if (alarmSubMode == 1) {
+                    // Countdown yang masih berjalan ditampilkan dulu, tombol hijau menambah baru
+                    countdownId = timerService.next(TIMER_COUNTDOWN, -1);
+                    enterAlarmState(countdownId >= 0 ? COUNTDOWN_RUN : COUNTDOWN_SET);
+                } else {
+                    enterAlarmState(STOPWATCH);
+                }
+            }
+            break;
+
+        case ALARM_LIST:
+            if (redPressed) {
+                alarmSlot = (alarmSlot - 1 + ALARM_MAX) % ALARM_MAX;  // Slot sebelumnya
+            } else if (bluePressed) {
+                alarmSlot = (alarmSlot + 1) % ALARM_MAX;  // Slot berikutnya
+            }
+            if (greenLong) {
+                enterAlarmState(ALARM_MENU);
+            } else if (greenShort) {
+                // Edit salinan; slot kosong langsung diaktifkan
+                alarmEdit = alarmService.get(alarmSlot);
+                alarmEdit.enabled = 1;
+                alarmField = 0;
+                enterAlarmState(ALARM_SET);
+            }
+            break;
+
+        case ALARM_SET:
+            if (redPressed) {
+                // Merah menaikkan nilai field yang dipilih
+                if (alarmField == 0) {
+                    alarmEdit.hour = (alarmEdit.hour + 1) % 24;
+                } else if (alarmField == 1) {
+                    alarmEdit.minute = (alarmEdit.minute + 1) % 60;
+                } else if (alarmField == 2 && !isRepeat) {
+                    alarmEdit.days = nextAlarmDays(alarmEdit.days);
+                } else if (alarmField == 3 && !isRepeat) {
+                    alarmEdit.enabled = !alarmEdit.enabled;
+                }
+            }
+            if (bluePressed && !isRepeat) {
+                alarmField = (alarmField + 1) % 4;  // Pindah field
+            }
+            if (greenLong) {
+                enterAlarmState(ALARM_LIST);  // Batal, perubahan dibuang
+            } else if (greenShort) {
+                alarmEdit.onceAt = 0;  // Alarm sekali dijadwalkan ulang dari waktu sekarang
+                alarmService.set(alarmSlot, alarmEdit, clockService.unixtime());
+                enterAlarmState(ALARM_LIST);
+            }
+            break;
+
+        case COUNTDOWN_SET:
+            if (redPressed) {
+                countdownMinute = (countdownMinute + 1) % 60; // Tambah menit
+            }
+            if (bluePressed) {
+                countdownHour = (countdownHour + 1) % 24; // Tambah jam
+            }
+            if (greenLong) {
+                enterAlarmState(ALARM_MENU);
+            } else if (greenShort) {
+                // Simpan pengaturan countdown dan mulai
+                unsigned long duration = (countdownHour * 3600UL + countdownMinute * 60UL) * 1000UL;
+                if (duration == 0 || !startCountdown(duration)) {
+                    enterAlarmState(ALARM_MENU);
+                }
+            }
+            break;
 
-    // Cek timeout untuk keluar dari alarm mode
-    if (millis() - lastInputTime > TIMEOUT_DURATION) {
-        isInAlarmMode = false;  // Kembali ke mode default jika tidak ada input
+        case COUNTDOWN_RUN:
+            // Merah = jeda/lanjut, biru = countdown berikutnya, hijau = tambah countdown
+            if (redPressed && !isRepeat) {
+                if (timerService.isRunning(countdownId)) {
+                    timerService.pause(countdownId);
+                } else {
+                    timerService.resume(countdownId);
+                }
+            }
+            if (bluePressed && !isRepeat) {
+                countdownId = timerService.next(TIMER_COUNTDOWN, countdownId);
+            }
+            if (greenShort) {
+                enterAlarmState(COUNTDOWN_SET);
+            } else if (greenLong) {
+                // Tekan lama membatalkan countdown yang dijeda; yang berjalan tetap jalan di background
+                if (timerService.isActive(countdownId) && !timerService.isRunning(countdownId)) {
+                    timerService.cancel(countdownId);
+                    countdownId = timerService.next(TIMER_COUNTDOWN, countdownId);
+                    if (countdownId < 0) {
+                        enterAlarmState(ALARM_MENU);
+                    }
+                } else {
+                    enterAlarmState(ALARM_MENU);
+                }
+            }
+            break;
+
+        case STOPWATCH:
+            if (greenLong) {
+                enterAlarmState(ALARM_MENU);  // Stopwatch tetap berjalan di background
+            } else if (!isRepeat) {
+                handleStopwatchInput(redPressed, bluePressed);
+            }
+            break;
     }
 }
 
-// Submode 1: Set and Handle Alarm
-void setAlarm() {
-    // Inisialisasi RTC dan variabel waktu
-    DateTime now;
-    // Pengaturan alarm
-    while (true) {
-        // Ambil waktu sekarang
-        now = rtc.now();
-        // Baca status tombol
-        red_button_state = digitalRead(RED_BUTTON_PIN);
-        blue_button_state = digitalRead(BLUE_BUTTON_PIN);
-        green_button_state = digitalRead(GREEN_BUTTON_PIN);
-
-        // Cek tombol merah dan biru untuk mengatur jam dan menit
-        if (red_button_state == LOW && previous_red_button_state == HIGH) {
-            alarmMinute = (alarmMinute + 1) % 60; // Tambah menit
-            delay(200);  // Debounce delay
-        }
-        if (blue_button_state == LOW && previous_blue_button_state == HIGH) {
-            alarmHour = (alarmHour + 1) % 24; // Tambah jam
-            delay(200);  // Debounce delay
-        }
-        if (green_button_state == LOW && previous_green_button_state == HIGH) {
-            // Simpan pengaturan alarm (tidak keluar dari mode)
-            delay(200);
+// Biru = mulai/jeda/lanjut; merah = lap saat berjalan, reset saat dijeda
+void handleStopwatchInput(bool redPressed, bool bluePressed) {
+    if (bluePressed) {
+        if (!timerService.isActive(stopwatchId)) {
+            stopwatchId = timerService.startStopwatch();
+        } else if (timerService.isRunning(stopwatchId)) {
+            timerService.pause(stopwatchId);
+        } else {
+            timerService.resume(stopwatchId);
         }
-
-        // Tampilkan waktu saat ini dan pengaturan alarm
-        oled.clearDisplay();
-        oled.setTextSize(1);
-        oled.setCursor(0, 0);
-        oled.printf("Current Time:\n%02d:%02d:%02d", now.hour(), now.minute(), now.second());
-        oled.setCursor(0, 16); // Pindah ke baris berikutnya
-        oled.printf("Set Alarm:\n%02d:%02d", alarmHour, alarmMinute);
-        oled.display();
-        
-        // Periksa jika waktu sekarang sesuai dengan alarm
-        if (now.hour() == alarmHour && now.minute() == alarmMinute) {
-            oled.clearDisplay();
-            oled.setCursor(0, 0);
-            oled.setTextSize(2);
-            oled.println("Alarm!");
-            oled.display();
-            delay(5000); // Tahan alarm selama 5 detik
-            break;  // Keluar dari loop 
+    }
+    if (redPressed) {
+        if (!timerService.isActive(stopwatchId)) {
+            stopwatchId = timerService.startStopwatch();
+        } else if (timerService.isRunning(stopwatchId)) {
+            timerService.lap(stopwatchId);
+        } else {
+            timerService.cancel(stopwatchId);
+            stopwatchId = -1;
         }
+    }
+}
 
-        // Simpan status tombol sebelumnya
-        previous_red_button_state = red_button_state;
-        previous_blue_button_state = blue_button_state;
-        previous_green_button_state = green_button_state;
-        
-        delay(100); // Delay untuk menghindari terlalu banyak pembaruan tampilan
+// Mulai countdown dan tampilkan layarnya, dari tombol maupun perintah telemetri.
+// false jika semua slot timer terpakai.
+bool startCountdown(unsigned long durationMs) {
+    int id = timerService.startCountdown(durationMs * 1000ULL);
+    if (id < 0) {
+        return false;
     }
-    displayTimeWithMenu(); // Return to the main menu
-    isInAlarmMode = false; // Exit alarm mode
+    countdownId = id;
+    mode = 3;
+    selectedMode = 3;
+    isInAlarmMode = true;
+    alarmSubMode = 1;
+    enterAlarmState(COUNTDOWN_RUN);
+    scheduler.trigger(renderTaskId);
+    return true;
 }
 
-// Submode 2: Countdown Timer
-void handleCountdown() {
-    oled.clearDisplay();
-    oled.setTextSize(1);
-    oled.setCursor(0, 0);
-    oled.println("Set Countdown:");
-    oled.setCursor(0, 10);
-    oled.printf("Time: %02d:%02d", countdownHour, countdownMinute);
-    oled.display();
-
-    while (true) {
-        // Cek tombol merah dan biru untuk mengatur jam dan menit
-        red_button_state = digitalRead(RED_BUTTON_PIN);
-        blue_button_state = digitalRead(BLUE_BUTTON_PIN);
-        green_button_state = digitalRead(GREEN_BUTTON_PIN);
-       
-        if (red_button_state == LOW && previous_red_button_state == HIGH) {
-            countdownMinute = (countdownMinute + 1) % 60; // Tambah menit
-            oled.clearDisplay();
-            oled.setTextSize(1);
-            oled.setCursor(0, 0);
-            oled.println("Set Countdown:");
-            oled.setCursor(0, 10);
-            oled.printf("Time: %02d:%02d", countdownHour, countdownMinute);
-            oled.display();
-            delay(200);  // Debounce delay
-        }
-        if (blue_button_state == LOW && previous_blue_button_state == HIGH) {
-            countdownHour = (countdownHour + 1) % 24; // Tambah jam
-            oled.clearDisplay();
-            oled.setTextSize(1);
-            oled.setCursor(0, 0);
-            oled.println("Set Countdown:");
-            oled.setCursor(0, 10);
-            oled.printf("Time: %02d:%02d", countdownHour, countdownMinute);
-            oled.display();
-            delay(200);  // Debounce delay
-        }
-        if (green_button_state == LOW && previous_green_button_state == HIGH) {
-            // Simpan pengaturan countdown dan keluar
-            countdownStart = millis();
-            isCountdownActive = true;
+// Mode 3: Handling Alarm Mode with Countdown and Stopwatch
+void handleAlarmMode() {
+    PROFILE_SCOPE("mode.alarm");
+    if (!isInAlarmMode) {
+        alarmSubMode = 0;  // Reset ke pilihan pertama
+        isInAlarmMode = true;
+        enterAlarmState(ALARM_MENU);
+    }
+
+    switch (alarmState) {
+        case ALARM_LIST:
+            drawAlarmList();
+            return;
+        case ALARM_SET:
+            setAlarm();
+            return;
+        case COUNTDOWN_SET:
+        case COUNTDOWN_RUN:
+            handleCountdown();
+            return;
+        case STOPWATCH:
+            handleStopwatch();
+            return;
+        case ALARM_MENU:
             break;
-        }
     }
 
-    // Mulai countdown
-    unsigned long countdownTime = countdownHour * 3600 + countdownMinute * 60; // Hitung total detik
-    while (countdownTime > 0 && isCountdownActive) {
-        countdownSecond = countdownTime % 60;
-        countdownMinute = (countdownTime / 60) % 60;
-        countdownHour = countdownTime / 3600;
-
-        oled.clearDisplay();
-        oled.setTextSize(1);
-        oled.setCursor(0, 0);
-        oled.printf("Countdown:\n%02d:%02d:%02d", countdownHour, countdownMinute, countdownSecond);
-        oled.display();
-
-        delay(1000); // Delay 1 detik
-        countdownTime--; // Kurangi satu detik
-
-        // Cek jika countdown selesai
-        if (countdownTime == 0) {
-            oled.clearDisplay();
-            oled.setTextSize(2); // Ukuran teks lebih besar
-            oled.setCursor(0, 0);
-            oled.println("Countdown");
-            oled.setCursor(0, 20);
-            oled.println("Finished!");
-            oled.display();
-            delay(2000); // Tampilkan teks 
-            isCountdownActive = false; // Reset status
-            break;  // Keluar setelah countdown selesai
-            countdownMinute = 0;
-            countdownSecond = 0;
-        }
+    renderer.render(alarmMenuView);
+}
+
+// Label pola hari alarm
+const char* alarmDaysLabel(uint8_t days) {
+    switch (days) {
+        case ALARM_DAYS_ONCE:
+            return "Once";
+        case ALARM_DAYS_DAILY:
+            return "Daily";
+        case ALARM_DAYS_WEEKDAYS:
+            return "Mon-Fri";
+        case ALARM_DAYS_WEEKEND:
+            return "Sat-Sun";
+        default:
+            return "Custom";
     }
-    displayTimeWithMenu(); // Return to the main menu
-    isInAlarmMode = false; // Exit alarm mode
 }
 
-// Submode 3: Stopwatch
-void handleStopwatch() {
-    oled.clearDisplay();
-    oled.setTextSize(2);
-    oled.setCursor(0,0);
-    oled.println("Stopwatch:");
-
-    while (true) {
-        // Memeriksa status tombol
-        red_button_state = digitalRead(RED_BUTTON_PIN);
-        blue_button_state = digitalRead(BLUE_BUTTON_PIN);
-        // Start stopwatch
-        if (red_button_state == LOW && previous_red_button_state == HIGH) {
-            if (!isStopwatchRunning) {
-                stopwatchStart = millis() - stopwatchElapsed; // Reset waktu yang sudah berlalu
-                isStopwatchRunning = true;
-            }
-            delay(200);  // Debounce delay
-        }
+// Pilihan pola hari di editor: Once -> Daily -> Mon-Fri -> Sat-Sun
+uint8_t nextAlarmDays(uint8_t days) {
+    switch (days) {
+        case ALARM_DAYS_ONCE:
+            return ALARM_DAYS_DAILY;
+        case ALARM_DAYS_DAILY:
+            return ALARM_DAYS_WEEKDAYS;
+        case ALARM_DAYS_WEEKDAYS:
+            return ALARM_DAYS_WEEKEND;
+        default:
+            return ALARM_DAYS_ONCE;
+    }
+}
 
-        // Pause stopwatch
-        if (blue_button_state == LOW && previous_blue_button_state == HIGH) {
-            if (isStopwatchRunning) {
-                stopwatchElapsed = millis() - stopwatchStart; // Hitung waktu yang sudah berlalu
-                isStopwatchRunning = false;
-            } else {
-                stopwatchStart = millis() - stopwatchElapsed; // Lanjutkan dari waktu yang sudah berlalu
-                isStopwatchRunning = true;
-            }
-            delay(200);  // Debounce delay
-        }
+// Submode 1: daftar semua slot alarm
+void drawAlarmList() {
+    renderer.render(alarmListView);
+}
 
-        // Menampilkan waktu stopwatch
-        if (isStopwatchRunning) {
-            unsigned long elapsedTime = millis() - stopwatchStart;
-            int seconds = (elapsedTime / 1000) % 60;
-            int minutes = (elapsedTime / 60000) % 60;
-            int hours = (elapsedTime / 3600000);
-            oled.clearDisplay();
-            oled.setCursor(0, 20);
-            oled.printf("Time: %02d:%02d:%02d", hours, minutes, seconds);
-        } else {
-            oled.clearDisplay();
-            oled.setCursor(0, 20);
-            oled.printf("Paused: %02d:%02d:%02d", (stopwatchElapsed / 3600000), (stopwatchElapsed / 60000) % 60, (stopwatchElapsed / 1000) % 60);
-        }
+// Submode 1: edit satu alarm
+void setAlarm() {
+    renderer.render(alarmEditView);
+}
+
+// Alarm berbunyi: layar dan LED berkedip sampai ditunda/dimatikan
+void drawAlarmRinging() {
+    PROFILE_SCOPE("alarm.ring");
+    renderer.render(ringView);  // LED berkedip di loop kontrol (INDICATOR_ALARM)
+}
+
+// Countdown selesai: LED merah/hijau bergantian, tutup sendiri setelah COUNTDOWN_DONE_DURATION
+void drawTimerDone() {
+    if (millis() - timerDoneSince >= COUNTDOWN_DONE_DURATION) {
+        closeTimerDone();
+        return;
+    }
+    renderer.render(countdownDoneView);  // LED berkedip di loop kontrol (INDICATOR_TIMER)
+}
+
+// LED dimatikan loop kontrol saat indikator kembali ke INDICATOR_NONE
+void closeTimerDone() {
+    timerDoneShowing = false;
+    scheduler.trigger(renderTaskId);
+}
+
+// Bingkai alarm: area widget penuh saat menyala
+void paintFill(Adafruit_SSD1306& gfx, const ui::Rect& bounds, int32_t on) {
+    if (on) {
+        gfx.fillRect(bounds.x, bounds.y, bounds.w, bounds.h, WHITE);
+    }
+}
 
-        oled.display();
+// Submode 2: Countdown Timer. Waktu dihitung timerService, di sini hanya digambar.
+void handleCountdown() {
+    if (alarmState == COUNTDOWN_RUN && !timerService.isActive(countdownId)) {
+        // Countdown yang ditampilkan sudah selesai/dibatalkan, pindah ke yang lain
+        countdownId = timerService.next(TIMER_COUNTDOWN, countdownId);
+        if (countdownId < 0) {
+            enterAlarmState(ALARM_MENU);
+            renderer.render(alarmMenuView);
+            return;
+        }
     }
+    renderer.render(alarmState == COUNTDOWN_SET ? countdownSetView : countdownRunView);
 }
 
-void handleDefaultMode() {
-    // Return to default mode after alarm submodes
-    isInAlarmMode = false;
+// Submode 3: Stopwatch
+void handleStopwatch() {
+    renderer.render(stopwatchView);
 }
@@ -0,0 +1,143 @@
+#include "power_manager.h"
+
+#include <driver/gpio.h>
+#include <driver/uart.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+#include "fixed_print.h"
+
+PowerManager powerManager;
+
+static const uint32_t DISPLAY_CURRENT_UA[] = {POWER_OLED_ON_UA, POWER_OLED_DIM_UA, POWER_OLED_OFF_UA};
+
+void PowerManager::begin(Display& display, const uint8_t* wakePins, uint8_t count) {
+    display_ = &display;
+    wakePinCount_ = count < POWER_MAX_WAKE_PINS ? count : POWER_MAX_WAKE_PINS;
+    memcpy(wakePins_, wakePins, wakePinCount_);
+    uart_set_wakeup_threshold(UART_NUM_0, POWER_UART_WAKE_EDGES);
+    resetStats();
+}
+
+bool PowerManager::sleep(uint64_t sleepUs) {
+    frameWanted_ = false;  // Bangun sebelumnya tidak menghasilkan frame
+    int64_t alarm = esp_timer_get_next_alarm() - esp_timer_get_time();
+    if (alarm < (int64_t)sleepUs) {
+        sleepUs = alarm > 0 ? alarm : 0;
+    }
+    if (sleepUs < POWER_MIN_SLEEP_US) {
+        stats_.shortWindows++;
+        return false;
+    }
+
+    // Wake GPIO hanya mendukung level; interupsi level yang sama akan terus
+    // terpicu selama tombol ditekan, jadi interupsinya dimatikan selama tidur
+    for (uint8_t i = 0; i < wakePinCount_; i++) {
+        gpio_intr_disable((gpio_num_t)wakePins_[i]);
+        gpio_wakeup_enable((gpio_num_t)wakePins_[i], GPIO_INTR_LOW_LEVEL);
+    }
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_uart_wakeup(UART_NUM_0);
+    esp_sleep_enable_timer_wakeup(sleepUs);
+
+    int64_t start = esp_timer_get_time();
+    esp_light_sleep_start();
+    int64_t end = esp_timer_get_time();
+
+    for (uint8_t i = 0; i < wakePinCount_; i++) {
+        gpio_wakeup_disable((gpio_num_t)wakePins_[i]);
+        gpio_set_intr_type((gpio_num_t)wakePins_[i], GPIO_INTR_ANYEDGE);  // Seperti attachInterrupt(CHANGE)
+        gpio_intr_enable((gpio_num_t)wakePins_[i]);
+    }
+
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    if (cause == ESP_SLEEP_WAKEUP_GPIO) {
+        lastWake_ = WAKE_BUTTON;
+    } else if (cause == ESP_SLEEP_WAKEUP_UART) {
+        lastWake_ = WAKE_HOST;
+    } else {
+        lastWake_ = WAKE_TIMER;
+    }
+    stats_.sleeps++;
+    stats_.sleepUs += end - start;
+    stats_.wakes[lastWake_]++;
+    wakeUs_ = (uint32_t)end;
+    wakeMs_ = millis();
+    framesAtWake_ = display_->framesSent();
+    frameWanted_ = true;
+    return true;
+}
+
+void PowerManager::setDisplay(DisplayPower power) {
+    if (power == display_->power()) {
+        return;
+    }
+    accountDisplay();
+    display_->setPower(power);
+}
+
+void PowerManager::accountDisplay() {
+    int64_t now = esp_timer_get_time();
+    stats_.displayUs[display_->power()] += now - displaySinceUs_;
+    displaySinceUs_ = now;
+}
+
+void PowerManager::poll() {
+    if (!frameWanted_ || display_->framesSent() == framesAtWake_) {
+        return;
+    }
+    frameWanted_ = false;
+    uint32_t latency = micros() - wakeUs_;
+    WakeLatency& frame = stats_.frame[lastWake_];
+    frame.count++;
+    frame.usTotal += latency;
+    if (latency > frame.usMax) frame.usMax = latency;
+}
+
+uint32_t PowerManager::cpuCurrentUa() const {
+    uint64_t total = esp_timer_get_time() - statsSinceUs_;
+    if (total == 0) {
+        return POWER_ACTIVE_UA;
+    }
+    uint64_t asleep = stats_.sleepUs < total ? stats_.sleepUs : total;
+    return (uint32_t)(((total - asleep) * POWER_ACTIVE_UA + asleep * POWER_SLEEP_UA) / total);
+}
+
+uint32_t PowerManager::displayCurrentUa() const {
+    int64_t now = esp_timer_get_time();
+    uint64_t total = now - statsSinceUs_;
+    if (total == 0) {
+        return DISPLAY_CURRENT_UA[display_->power()];
+    }
+    uint64_t charge = (uint64_t)(now - displaySinceUs_) * DISPLAY_CURRENT_UA[display_->power()];
+    for (int i = 0; i < 3; i++) {
+        charge += stats_.displayUs[i] * DISPLAY_CURRENT_UA[i];
+    }
+    return (uint32_t)(charge / total);
+}
+
+void PowerManager::report(Print& out) const {
+    uint64_t total = esp_timer_get_time() - statsSinceUs_;
+    uint32_t asleep = total ? (uint32_t)(stats_.sleepUs * 1000 / total) : 0;  // Permil
+    uint32_t cpu = cpuCurrentUa();
+    uint32_t oled = displayCurrentUa();
+    fixedPrintf(out, "power: %lu sleeps (%lu too short), asleep %lu.%lu%%, est %lu.%02lu mA "
+                "(cpu %lu.%02lu, oled %lu.%02lu)\n",
+                (unsigned long)stats_.sleeps, (unsigned long)stats_.shortWindows, (unsigned long)(asleep / 10),
+                (unsigned long)(asleep % 10), (unsigned long)((cpu + oled) / 1000),
+                (unsigned long)((cpu + oled) % 1000 / 10), (unsigned long)(cpu / 1000),
+                (unsigned long)(cpu % 1000 / 10), (unsigned long)(oled / 1000), (unsigned long)(oled % 1000 / 10));
+    static const char* const SOURCES[] = {"timer", "button", "host"};
+    for (int i = 0; i < WAKE_SOURCES; i++) {
+        const WakeLatency& frame = stats_.frame[i];
+        fixedPrintf(out, "  wake %-6s %lu, to frame %lu (avg %lu us, max %lu us)\n", SOURCES[i],
+                    (unsigned long)stats_.wakes[i], (unsigned long)frame.count,
+                    (unsigned long)(frame.count ? frame.usTotal / frame.count : 0), (unsigned long)frame.usMax);
+    }
+}
+
+void PowerManager::resetStats() {
+    stats_ = {};
+    statsSinceUs_ = esp_timer_get_time();
+    displaySinceUs_ = statsSinceUs_;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "display.h"
+
+// Light sleep berbasis event.
+// loop() menawarkan tidur setelah scheduler.run() selama UI diam; CPU masuk
+// light sleep sampai event terjadwal berikutnya (tick detik, sampel sensor,
+// task scheduler, esp_timer, alarm), tombol ditekan (wake GPIO level rendah)
+// atau host mengirim ke UART. Selama tidur tipe interupsi pin tombol diganti
+// menjadi level, jadi interupsi tepinya dimatikan dan tepi yang membangunkan
+// dibaca ulang lewat ButtonInput::resync().
+// Board tidak punya sensor arus: arus rata-rata diperkirakan dari lama CPU
+// aktif/light sleep dan panel menyala/redup/mati, dikali arus tipikal
+// datasheet. Latensi bangun diukur dari bangun sampai frame berikutnya sampai
+// ke panel.
+
+#ifndef POWER_LIGHT_SLEEP
+#ifdef ESP_PLATFORM
+#define POWER_LIGHT_SLEEP 1
+#else
+#define POWER_LIGHT_SLEEP 0  // Native: dinyalakan test lewat setEnabled()
+#endif
+#endif
+
+#define POWER_MIN_SLEEP_US 3000   // Jendela lebih pendek tidak sebanding dengan biaya masuk/keluar
+#define POWER_HOST_GRACE_MS 5000  // Tetap bangun setelah host mengirim
+#define POWER_MAX_WAKE_PINS 4
+#define POWER_UART_WAKE_EDGES 3   // Tepi RX yang membangunkan; byte pertama dari host hilang
+
+// Arus tipikal (uA) untuk perkiraan
+#define POWER_ACTIVE_UA 40000   // ESP32 240 MHz, radio mati
+#define POWER_SLEEP_UA 800      // Light sleep
+#define POWER_OLED_ON_UA 12000  // SSD1306 128x64, sekitar setengah piksel menyala
+#define POWER_OLED_DIM_UA 4000
+#define POWER_OLED_OFF_UA 10
+
+enum PowerWake : uint8_t {
+    WAKE_TIMER,   // Event terjadwal
+    WAKE_BUTTON,
+    WAKE_HOST,    // RX UART
+    WAKE_SOURCES
+};
+
+struct WakeLatency {
+    uint32_t count;     // Bangun yang diikuti frame sebelum tidur lagi
+    uint32_t usMax;
+    uint64_t usTotal;
+};
+
+struct PowerStats {
+    uint32_t sleeps;
+    uint32_t shortWindows;     // Tidak jadi tidur karena event berikutnya terlalu dekat
+    uint64_t sleepUs;
+    uint32_t wakes[WAKE_SOURCES];
+    WakeLatency frame[WAKE_SOURCES];  // Bangun sampai frame berikutnya di panel
+    uint64_t displayUs[3];     // Lama panel di setiap DisplayPower
+};
+
+class PowerManager {
+public:
+    // Pin tombol aktif rendah yang membangunkan CPU
+    void begin(Display& display, const uint8_t* wakePins, uint8_t count);
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+
+    // Light sleep paling lama sleepUs (dipendekkan ke esp_timer berikutnya, yang
+    // tidak berjalan selama tidur); false jika jendela terlalu pendek
+    bool sleep(uint64_t sleepUs);
+    PowerWake lastWake() const { return lastWake_; }
+    uint32_t wakeUs() const { return wakeUs_; }  // micros() saat bangun terakhir
+    uint32_t wakeMs() const { return wakeMs_; }
+
+    // Daya panel; lama di setiap level dicatat untuk perkiraan arus
+    void setDisplay(DisplayPower power);
+    DisplayPower display() const { return display_->power(); }
+
+    // Dipanggil setiap loop(): catat frame pertama setelah bangun
+    void poll();
+
+    // Perkiraan arus rata-rata (uA) sejak resetStats(): CPU dan panel
+    uint32_t cpuCurrentUa() const;
+    uint32_t displayCurrentUa() const;
+    uint32_t averageCurrentUa() const { return cpuCurrentUa() + displayCurrentUa(); }
+
+    const PowerStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    void accountDisplay();
+
+    Display* display_ = nullptr;
+    uint8_t wakePins_[POWER_MAX_WAKE_PINS] = {};
+    uint8_t wakePinCount_ = 0;
+    bool enabled_ = POWER_LIGHT_SLEEP;
+
+    PowerWake lastWake_ = WAKE_TIMER;
+    uint32_t wakeUs_ = 0;
+    uint32_t wakeMs_ = 0;
+    bool frameWanted_ = false;  // Menunggu frame pertama setelah bangun
+    uint32_t framesAtWake_ = 0;
+
+    int64_t statsSinceUs_ = 0;
+    int64_t displaySinceUs_ = 0;
+    PowerStats stats_ = {};
+};
+
+extern PowerManager powerManager;
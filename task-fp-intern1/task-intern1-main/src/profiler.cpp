@@ -0,0 +1,96 @@
+#include "profiler.h"
+
+#include "fixed_print.h"
+
+Profiler profiler;
+
+int Profiler::zone(const char* name) {
+    for (int i = 0; i < zoneCount_; i++) {
+        if (strcmp(zones_[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (zoneCount_ >= PROFILER_MAX_ZONES) {
+        return -1;
+    }
+    ProfileZone& z = zones_[zoneCount_];
+    memset(&z, 0, sizeof(z));
+    z.name = name;
+    return zoneCount_++;
+}
+
+void Profiler::record(int zone, uint32_t cycles) {
+    if (zone < 0) return;
+    ProfileZone& z = zones_[zone];
+    z.count++;
+    z.totalCycles += cycles;
+    if (cycles > z.maxCycles) z.maxCycles = cycles;
+    z.buckets[bucketOf(cycles)]++;
+}
+
+// Bucket 0 dan 1 untuk 0 dan 1 cycle, lalu dua bucket per oktaf:
+// [2^n, 1.5 * 2^n) dan [1.5 * 2^n, 2^(n+1))
+uint8_t Profiler::bucketOf(uint32_t cycles) {
+    if (cycles < 2) {
+        return cycles;
+    }
+    uint8_t log2 = 31 - __builtin_clz(cycles);
+    uint8_t half = (cycles >> (log2 - 1)) & 1;
+    return log2 * 2 + half;
+}
+
+uint32_t Profiler::bucketUpper(uint8_t bucket) {
+    if (bucket < 2) {
+        return bucket;
+    }
+    uint8_t log2 = bucket / 2;
+    uint8_t half = bucket & 1;
+    uint64_t lower = (uint64_t)(2 + half) << (log2 - 1);
+    return (uint32_t)(lower + ((uint64_t)1 << (log2 - 1)) - 1);
+}
+
+uint32_t Profiler::percentile(int zone, uint8_t pct) const {
+    const ProfileZone* z = get(zone);
+    if (!z || z->count == 0) {
+        return 0;
+    }
+    uint32_t target = (uint32_t)(((uint64_t)z->count * pct + 99) / 100);
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < PROFILER_BUCKETS; b++) {
+        seen += z->buckets[b];
+        if (seen >= target) {
+            uint32_t upper = bucketUpper(b);
+            return upper < z->maxCycles ? upper : z->maxCycles;
+        }
+    }
+    return z->maxCycles;
+}
+
+const ProfileZone* Profiler::get(int zone) const {
+    if (zone < 0 || zone >= zoneCount_) return nullptr;
+    return &zones_[zone];
+}
+
+void Profiler::report(Print& out) const {
+#if PROFILER_ENABLED
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    out.println("profile (us):");
+    fixedPrintf(out, "  %-24s %8s %8s %8s %8s %8s\n", "zone", "count", "avg", "p50", "p99", "max");
+    for (int i = 0; i < zoneCount_; i++) {
+        const ProfileZone& z = zones_[i];
+        uint32_t avg = z.count ? (uint32_t)(z.totalCycles / z.count) : 0;
+        fixedPrintf(out, "  %-24s %8lu %8.1f %8.1f %8.1f %8.1f\n", z.name, (unsigned long)z.count, (float)avg / mhz,
+                    (float)percentile(i, 50) / mhz, (float)percentile(i, 99) / mhz, (float)z.maxCycles / mhz);
+    }
+#else
+    out.println("profile: disabled (PROFILER_ENABLED=0)");
+#endif
+}
+
+void Profiler::reset() {
+    for (int i = 0; i < zoneCount_; i++) {
+        const char* name = zones_[i].name;
+        memset(&zones_[i], 0, sizeof(ProfileZone));
+        zones_[i].name = name;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Profiler ringan berbasis cycle counter ESP32 (ESP.getCycleCount()).
+// PROFILE_SCOPE("nama") mengukur sisa blok saat ini dan mencatatnya ke
+// histogram log (dua bucket per oktaf) berukuran tetap per zona, jadi
+// p50/p99/max bisa dihitung tanpa menyimpan sampel.
+// Setiap zona hanya boleh dicatat dari satu task (tanpa lock).
+// Build dengan -DPROFILER_ENABLED=0 untuk menghapus semua titik ukur.
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#define PROFILER_MAX_ZONES 24
+#define PROFILER_BUCKETS 64  // 32 oktaf x 2
+
+struct ProfileZone {
+    const char* name;
+    uint32_t count;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint32_t buckets[PROFILER_BUCKETS];
+};
+
+class Profiler {
+public:
+    // Daftarkan zona (atau ambil yang sudah ada), -1 jika tabel penuh
+    int zone(const char* name);
+    void record(int zone, uint32_t cycles);
+
+    // Batas atas bucket yang memuat persentil pct, dalam cycle
+    uint32_t percentile(int zone, uint8_t pct) const;
+    const ProfileZone* get(int zone) const;
+    int zoneCount() const { return zoneCount_; }
+
+    void report(Print& out) const;
+    void reset();
+
+    static uint8_t bucketOf(uint32_t cycles);
+    static uint32_t bucketUpper(uint8_t bucket);
+
+private:
+    ProfileZone zones_[PROFILER_MAX_ZONES];
+    int zoneCount_ = 0;
+};
+
+extern Profiler profiler;
+
+// Mengukur dari konstruksi sampai akhir scope
+class ProfileScope {
+public:
+    explicit ProfileScope(int zone) : zone_(zone), start_(ESP.getCycleCount()) {}
+    ~ProfileScope() { profiler.record(zone_, ESP.getCycleCount() - start_); }
+
+private:
+    int zone_;
+    uint32_t start_;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if PROFILER_ENABLED
+// Lookup nama hanya sekali per titik ukur (static lokal)
+#define PROFILE_SCOPE(name)                                                     \
+    static const int PROFILE_CONCAT(profileZone_, __LINE__) = profiler.zone(name); \
+    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileZone_, __LINE__))
+#else
+#define PROFILE_SCOPE(name) \
+    do {                    \
+    } while (0)
+#endif
@@ -0,0 +1,134 @@
+#include "scheduler.h"
+
+#include "fixed_print.h"
+
+Scheduler scheduler;
+
+int Scheduler::add(const char* name, TaskFn fn, uint32_t periodMs, uint32_t deadlineUs) {
+    if (taskCount_ >= SCHEDULER_MAX_TASKS) {
+        return -1;
+    }
+    SchedulerTask& task = tasks_[taskCount_];
+    task.name = name;
+    task.fn = fn;
+    task.periodMs = periodMs;
+    task.deadlineUs = deadlineUs;
+    task.nextRunMs = millis();
+    task.enabled = true;
+    task.triggered = false;
+    task.polling = false;
+    task.runs = 0;
+    task.overruns = 0;
+    task.maxRunUs = 0;
+    task.maxLateMs = 0;
+    return taskCount_++;
+}
+
+void Scheduler::setEnabled(int id, bool enabled) {
+    if (id < 0 || id >= taskCount_) return;
+    if (enabled && !tasks_[id].enabled) {
+        tasks_[id].nextRunMs = millis();
+    }
+    tasks_[id].enabled = enabled;
+}
+
+void Scheduler::setPeriod(int id, uint32_t periodMs) {
+    if (id < 0 || id >= taskCount_) return;
+    tasks_[id].periodMs = periodMs;
+}
+
+void Scheduler::setPolling(int id, bool polling) {
+    if (id < 0 || id >= taskCount_) return;
+    tasks_[id].polling = polling;
+}
+
+void Scheduler::trigger(int id) {
+    if (id < 0 || id >= taskCount_) return;
+    tasks_[id].nextRunMs = millis();
+    tasks_[id].triggered = true;
+}
+
+void Scheduler::run() {
+    uint32_t loopStart = micros();
+
+    for (int i = 0; i < taskCount_; i++) {
+        SchedulerTask& task = tasks_[i];
+        if (!task.enabled) continue;
+
+        uint32_t nowMs = millis();
+        int32_t late = (int32_t)(nowMs - task.nextRunMs);
+        if (late < 0) continue;  // Belum jatuh tempo
+
+        triggeredRun_ = task.triggered;
+        task.triggered = false;
+        uint32_t start = micros();
+        task.fn();
+        uint32_t elapsed = micros() - start;
+
+        task.runs++;
+        if (elapsed > task.maxRunUs) task.maxRunUs = elapsed;
+        if (elapsed > task.deadlineUs) task.overruns++;
+        if ((uint32_t)late > task.maxLateMs) task.maxLateMs = late;
+
+        // Jadwal tetap (tidak drift); kalau tertinggal lebih dari satu periode, sinkron ulang
+        task.nextRunMs += task.periodMs;
+        if ((int32_t)(nowMs - task.nextRunMs) >= (int32_t)task.periodMs) {
+            task.nextRunMs = nowMs + task.periodMs;
+        }
+    }
+
+    uint32_t loopTime = micros() - loopStart;
+    if (loopTime > loopMaxUs_) loopMaxUs_ = loopTime;
+    loopTotalUs_ += loopTime;
+    loopCount_++;
+}
+
+bool Scheduler::hasTriggered() const {
+    for (int i = 0; i < taskCount_; i++) {
+        if (tasks_[i].enabled && tasks_[i].triggered) return true;
+    }
+    return false;
+}
+
+uint32_t Scheduler::idleMs() const {
+    uint32_t nowMs = millis();
+    uint32_t idle = UINT32_MAX;
+    for (int i = 0; i < taskCount_; i++) {
+        const SchedulerTask& task = tasks_[i];
+        if (!task.enabled || task.polling) continue;
+        int32_t wait = (int32_t)(task.nextRunMs - nowMs);
+        if (wait <= 0) return 0;
+        if ((uint32_t)wait < idle) idle = wait;
+    }
+    return idle;
+}
+
+void Scheduler::afterSleep() {
+    for (int i = 0; i < taskCount_; i++) {
+        if (tasks_[i].enabled && tasks_[i].polling) {
+            trigger(i);
+        }
+    }
+}
+
+void Scheduler::report(Print& out) const {
+    fixedPrintf(out, "loop: avg %lu us, max %lu us\n", (unsigned long)loopAvgUs(), (unsigned long)loopMaxUs_);
+    for (int i = 0; i < taskCount_; i++) {
+        const SchedulerTask& task = tasks_[i];
+        fixedPrintf(out, "  %-8s runs %lu, max %lu us, late %lu ms, overrun %lu\n",
+                    task.name, (unsigned long)task.runs, (unsigned long)task.maxRunUs,
+                    (unsigned long)task.maxLateMs, (unsigned long)task.overruns);
+    }
+}
+
+void Scheduler::resetStats() {
+    loopMaxUs_ = 0;
+    loopTotalUs_ = 0;
+    loopCount_ = 0;
+    for (int i = 0; i < taskCount_; i++) {
+        tasks_[i].runs = 0;
+        tasks_[i].overruns = 0;
+        tasks_[i].maxRunUs = 0;
+        tasks_[i].maxLateMs = 0;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Scheduler kooperatif berbasis tick untuk loop().
+// Setiap task punya periode (ms) dan deadline/budget waktu eksekusi (us).
+// Task harus selalu return dengan cepat (state machine, tanpa delay()).
+
+typedef void (*TaskFn)();
+
+#define SCHEDULER_MAX_TASKS 12
+
+struct SchedulerTask {
+    const char* name;
+    TaskFn fn;
+    uint32_t periodMs;
+    uint32_t deadlineUs;     // Budget eksekusi, lewat dari ini dihitung overrun
+    uint32_t nextRunMs;
+    bool enabled;
+    bool triggered;          // Run berikutnya dari trigger(), bukan jadwal
+    bool polling;            // Hanya memeriksa pekerjaan; tidak perlu membangunkan CPU
+
+    // Statistik
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t maxRunUs;
+    uint32_t maxLateMs;      // Keterlambatan start terhadap jadwal
+};
+
+class Scheduler {
+public:
+    // Return id task, atau -1 jika tabel penuh
+    int add(const char* name, TaskFn fn, uint32_t periodMs, uint32_t deadlineUs);
+    void setEnabled(int id, bool enabled);
+    void setPeriod(int id, uint32_t periodMs);
+    // Jalankan task pada iterasi run() berikutnya
+    void trigger(int id);
+    uint32_t period(int id) const { return tasks_[id].periodMs; }
+    // Dipanggil dari dalam task: true jika run ini dipicu trigger(), bukan jadwal
+    bool triggeredRun() const { return triggeredRun_; }
+
+    // Task polling (input, render, transfer, ...) tetap berjalan periodik saat
+    // CPU bangun, tapi jadwalnya tidak menunda light sleep
+    void setPolling(int id, bool polling);
+
+    // Dipanggil sekali per loop(), menjalankan semua task yang sudah jatuh tempo
+    void run();
+
+    // true jika ada task yang dipicu trigger() dan belum dijalankan
+    bool hasTriggered() const;
+    // Waktu sampai task non-polling berikutnya jatuh tempo, 0 jika sudah;
+    // UINT32_MAX jika tidak ada
+    uint32_t idleMs() const;
+    // Setelah light sleep: task polling dijalankan sekali di run() berikutnya,
+    // di luar jadwal (tidak dihitung terlambat)
+    void afterSleep();
+
+    // Latensi loop = durasi satu iterasi run(), batas atas waktu tunggu input
+    uint32_t loopMaxUs() const { return loopMaxUs_; }
+    uint32_t loopAvgUs() const { return loopCount_ ? (uint32_t)(loopTotalUs_ / loopCount_) : 0; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    SchedulerTask tasks_[SCHEDULER_MAX_TASKS];
+    int taskCount_ = 0;
+    bool triggeredRun_ = false;
+
+    uint32_t loopMaxUs_ = 0;
+    uint64_t loopTotalUs_ = 0;
+    uint32_t loopCount_ = 0;
+};
+
+extern Scheduler scheduler;
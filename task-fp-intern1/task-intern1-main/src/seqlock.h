@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <type_traits>
+
+// Seqlock satu penulis untuk state terbaru yang kecil (snapshot), bukan antrian.
+// Penulis tidak pernah menunggu: nomor urut ganjil selama menulis, genap setelahnya.
+// Pembaca menyalin lalu memeriksa nomor urut; jika berubah di tengah salinan,
+// salinan diulang. Penulis dan pembaca harus di core berbeda (atau penulis tidak
+// bisa disela pembaca), kalau tidak pembaca bisa berputar menunggu penulis yang tertidur.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "Isi seqlock harus bisa disalin dengan memcpy");
+
+public:
+    void write(const T& value) {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&value_, &value, sizeof(T));
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Salin nilai terbaru yang utuh; return berapa kali salinan diulang
+    uint32_t read(T& out) const {
+        uint32_t retries = 0;
+        for (;;) {
+            uint32_t before = seq_.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                memcpy(&out, &value_, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == before) {
+                    return retries;
+                }
+            }
+            retries++;
+        }
+    }
+
+    // Jumlah write() sejauh ini; berubah = ada nilai baru
+    uint32_t version() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+private:
+    T value_ = {};
+    std::atomic<uint32_t> seq_{0};
+};
@@ -0,0 +1,120 @@
+#include "servo_planner.h"
+
+#include <math.h>
+
+#include "fixed_print.h"
+#include "profiler.h"
+
+// Batas per langkah dalam milliderajat: kecepatan per langkah, percepatan per langkah^2
+static const int32_t STEP_MAX_SPEED = (int64_t)SERVO_MAX_SPEED * 1000 * SERVO_STEP_US / 1000000;
+static const int32_t STEP_ACCEL = (int64_t)SERVO_ACCEL * 1000 * SERVO_STEP_US / 1000000 * SERVO_STEP_US / 1000000;
+
+void ServoPlanner::begin(uint8_t pin, int minUs, int maxUs, int angle) {
+    servo_.attach(pin, minUs, maxUs);
+    minUs_ = minUs;
+    maxUs_ = maxUs;
+    targetMilli_ = angle * 1000;
+    positionMilli_ = angle * 1000;
+    velocity_ = 0;
+    pulseUs_ = -1;
+    writePulse();  // Posisi awal diketahui, gerak pertama direncanakan dari sini
+
+    if (timer_ == nullptr) {
+        esp_timer_create_args_t args = {};
+        args.callback = onStep;
+        args.arg = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "servo";
+        esp_timer_create(&args, &timer_);
+    }
+}
+
+void ServoPlanner::moveTo(int angle) {
+    if (angle < 0) angle = 0;
+    if (angle > 180) angle = 180;
+    int32_t milli = angle * 1000;
+    int32_t current = targetMilli_.load(std::memory_order_relaxed);
+    if (milli == current) {
+        return;
+    }
+    if (abs(milli - current) < SERVO_DEADBAND * 1000) {
+        stats_.deadbandSkips++;
+        return;
+    }
+    stats_.moves++;
+    targetMilli_.store(milli, std::memory_order_release);
+    if (!running_.exchange(true)) {
+        jitter_.sync(micros());
+        esp_timer_start_periodic(timer_, SERVO_STEP_US);
+    }
+}
+
+// Callback esp_timer (task esp_timer), satu langkah per frame PWM
+void ServoPlanner::onStep(void* arg) {
+    static_cast<ServoPlanner*>(arg)->step();
+}
+
+void ServoPlanner::step() {
+    jitter_.mark(micros(), SERVO_STEP_US);
+    stats_.steps++;
+
+    int32_t target = targetMilli_.load(std::memory_order_acquire);
+    int32_t position = positionMilli_.load(std::memory_order_relaxed);
+    int32_t error = target - position;
+
+    // Kecepatan tertinggi yang masih bisa berhenti di target: sqrt(2 a d), dibatasi kecepatan maksimum
+    int32_t reachable = (int32_t)sqrtf(2.0f * STEP_ACCEL * (float)abs(error));
+    int32_t limit = reachable < STEP_MAX_SPEED ? reachable : STEP_MAX_SPEED;
+    int32_t desired = error >= 0 ? limit : -limit;
+    if (desired > velocity_ + STEP_ACCEL) {
+        velocity_ += STEP_ACCEL;
+    } else if (desired < velocity_ - STEP_ACCEL) {
+        velocity_ -= STEP_ACCEL;
+    } else {
+        velocity_ = desired;
+    }
+
+    position += velocity_;
+    if ((error >= 0 && position >= target) || (error < 0 && position <= target)) {
+        position = target;  // Tidak melewati target
+        velocity_ = 0;
+    }
+    positionMilli_.store(position, std::memory_order_relaxed);
+    writePulse();
+
+    if (position == target && velocity_ == 0) {
+        esp_timer_stop(timer_);
+        running_.store(false);
+        // moveTo() di antara stop dan store tidak menyalakan timer; lanjutkan di sini
+        if (targetMilli_.load(std::memory_order_acquire) != position && !running_.exchange(true)) {
+            jitter_.sync(micros());
+            esp_timer_start_periodic(timer_, SERVO_STEP_US);
+        }
+    }
+}
+
+void ServoPlanner::writePulse() {
+    int32_t position = positionMilli_.load(std::memory_order_relaxed);
+    int pulse = minUs_ + (int)(((int64_t)position * (maxUs_ - minUs_) + 90000) / 180000);
+    if (pulse == pulseUs_) {
+        stats_.coalesced++;
+        return;
+    }
+    PROFILE_SCOPE("servo.write");
+    servo_.writeMicroseconds(pulse);
+    pulseUs_ = pulse;
+    stats_.writes++;
+}
+
+void ServoPlanner::report(Print& out) const {
+    fixedPrintf(out, "servo: %lu moves (%lu in deadband), %lu steps, %lu writes (%lu unchanged), "
+                "at %d deg (target %d)\n",
+                (unsigned long)stats_.moves, (unsigned long)stats_.deadbandSkips, (unsigned long)stats_.steps,
+                (unsigned long)stats_.writes, (unsigned long)stats_.coalesced, position(), target());
+    jitter_.report(out);
+}
+
+void ServoPlanner::resetStats() {
+    stats_ = {};
+    jitter_.resetStats();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESP32Servo.h>
+#include <esp_timer.h>
+
+#include <atomic>
+
+#include "jitter.h"
+
+// Perencana gerak servo dengan profil kecepatan trapesium.
+// Loop kontrol hanya menentukan target (moveTo); langkah gerak dijalankan
+// esp_timer periodik setiap satu frame PWM servo (50 Hz), jadi gerak tetap
+// halus berapa pun lama frame UI atau tick kontrol. Kecepatan naik dan turun
+// dengan percepatan terbatas, dan target yang berubah di tengah gerak
+// (termasuk berbalik arah) dilanjutkan dari kecepatan sekarang.
+// Lebar pulsa hanya ditulis ke LEDC jika berubah; timer berhenti saat servo
+// sampai di target. Target baru di dalam deadband diabaikan agar derau
+// sensor tidak menggerakkan servo.
+
+#define SERVO_STEP_US 20000   // Satu frame PWM servo
+#define SERVO_MAX_SPEED 120   // derajat/detik
+#define SERVO_ACCEL 480       // derajat/detik^2
+#define SERVO_DEADBAND 2      // derajat
+
+struct ServoStats {
+    uint32_t moves;         // Target baru yang diterima
+    uint32_t deadbandSkips; // Target yang diabaikan karena terlalu dekat
+    uint32_t steps;
+    uint32_t writes;        // Lebar pulsa yang ditulis
+    uint32_t coalesced;     // Langkah tanpa perubahan lebar pulsa
+};
+
+class ServoPlanner {
+public:
+    void begin(uint8_t pin, int minUs, int maxUs, int angle);
+    // Target baru dalam derajat (0-180)
+    void moveTo(int angle);
+
+    int target() const { return (targetMilli_.load() + 500) / 1000; }
+    int position() const { return (positionMilli_.load() + 500) / 1000; }
+    bool moving() const { return running_.load(); }
+
+    const ServoStats& stats() const { return stats_; }
+    const JitterMeter& jitter() const { return jitter_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    static void onStep(void* arg);
+    void step();
+    void writePulse();
+
+    Servo servo_;
+    int minUs_ = 500;
+    int maxUs_ = 2400;
+    esp_timer_handle_t timer_ = nullptr;
+
+    // Ditulis loop kontrol, dibaca langkah timer
+    std::atomic<int32_t> targetMilli_{90000};
+    std::atomic<bool> running_{false};
+
+    // Dipakai langkah timer; posisi juga dibaca loop kontrol untuk snapshot
+    std::atomic<int32_t> positionMilli_{90000};
+    int32_t velocity_ = 0;  // Milliderajat per langkah
+    int pulseUs_ = -1;
+    JitterMeter jitter_{"servo"};
+    ServoStats stats_ = {};
+};
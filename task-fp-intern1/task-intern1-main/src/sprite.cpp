@@ -0,0 +1,57 @@
+#include "sprite.h"
+
+#include "display.h"
+
+namespace sprite {
+
+void blit(uint8_t* buffer, const Ref& sprite, int16_t x, int16_t y, BlitOp op) {
+    int16_t first = x < 0 ? -x : 0;
+    int16_t last = x + sprite.w > Display::WIDTH ? Display::WIDTH - x : sprite.w;
+    if (first >= last || y >= Display::PAGES * 8 || y + sprite.h <= 0) {
+        return;
+    }
+    // Page tujuan pertama dibulatkan ke bawah, juga untuk y negatif
+    int16_t page0 = y >= 0 ? y / 8 : -((7 - y) / 8);
+    uint8_t shift = (uint8_t)(y - page0 * 8);
+    uint8_t pages = sprite.pages();
+    uint8_t spanned = (uint8_t)((shift + sprite.h + 7) / 8);
+    int16_t pageFirst = page0 < 0 ? -page0 : 0;
+    int16_t pageLast = page0 + spanned > Display::PAGES ? Display::PAGES - page0 : spanned;
+
+    for (int16_t c = first; c < last; c++) {
+        uint32_t word = 0;
+        for (uint8_t p = 0; p < pages; p++) {
+            word |= (uint32_t)sprite.data[p * sprite.w + c] << (p * 8);
+        }
+        word <<= shift;
+        uint8_t* column = buffer + (x + c);
+        for (int16_t p = pageFirst; p < pageLast; p++) {
+            uint8_t bits = (uint8_t)(word >> (p * 8));
+            uint8_t& dst = column[(page0 + p) * Display::WIDTH];
+            switch (op) {
+                case BLIT_SET:
+                    dst |= bits;
+                    break;
+                case BLIT_CLEAR:
+                    dst &= (uint8_t)~bits;
+                    break;
+                case BLIT_XOR:
+                    dst ^= bits;
+                    break;
+            }
+        }
+    }
+}
+
+void tile(uint8_t* buffer, const Ref& tile, int16_t x, uint8_t page) {
+    int16_t first = x < 0 ? -x : 0;
+    int16_t last = x + tile.w > Display::WIDTH ? Display::WIDTH - x : tile.w;
+    if (first >= last) {
+        return;
+    }
+    for (uint8_t p = 0; p < tile.pages() && page + p < Display::PAGES; p++) {
+        memcpy(buffer + (page + p) * Display::WIDTH + x + first, tile.data + p * tile.w + first, last - first);
+    }
+}
+
+}  // namespace sprite
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ui.h"
+
+// Sprite dan tile 1bpp langsung di framebuffer SSD1306.
+// Framebuffer disusun per page: satu byte = 8 piksel vertikal (bit 0 di atas),
+// 128 byte per page. Bitmap dipak saat compile ke format yang sama (kolom per
+// page), jadi blit tidak menyentuh piksel satu per satu: setiap kolom sprite
+// dibaca sebagai satu word 32-bit, digeser y % 8 dan di-OR/AND/XOR ke paling
+// banyak empat page tujuan. Tile yang page-aligned cukup disalin dengan memcpy.
+// Tabrakan cukup dengan kotak pembatas (ui::Rect::intersects).
+
+#define SPRITE_MAX_HEIGHT 24  // Tiga page + geseran 7 bit masih muat di word 32-bit
+
+namespace sprite {
+
+enum BlitOp : uint8_t {
+    BLIT_SET,    // Piksel menyala di-OR (latar transparan)
+    BLIT_CLEAR,  // Piksel menyala dihapus, untuk menghapus frame sebelumnya
+    BLIT_XOR,
+};
+
+// Tampilan bitmap yang sudah dipak: pages() * w byte, page-major
+struct Ref {
+    const uint8_t* data;
+    uint8_t w;
+    uint8_t h;
+
+    constexpr uint8_t pages() const { return (h + 7) / 8; }
+};
+
+// Bitmap dari string baris demi baris, '#' = menyala, selain itu padam.
+// Contoh 3x2: Bitmap<3, 2>(".#." "###")
+template <uint8_t W, uint8_t H>
+struct Bitmap {
+    static_assert(H > 0 && H <= SPRITE_MAX_HEIGHT, "tinggi sprite");
+    static constexpr uint8_t PAGES = (H + 7) / 8;
+    uint8_t column[PAGES][W];
+
+    constexpr Bitmap(const char* rows) : column() {
+        for (uint8_t y = 0; y < H; y++) {
+            for (uint8_t x = 0; x < W; x++) {
+                if (rows[y * W + x] == '#') {
+                    column[y / 8][x] |= (uint8_t)(1 << (y % 8));
+                }
+            }
+        }
+    }
+    constexpr Ref ref() const { return {&column[0][0], W, H}; }
+};
+
+// Gambar di posisi piksel mana pun, terpotong di tepi layar
+void blit(uint8_t* buffer, const Ref& sprite, int16_t x, int16_t y, BlitOp op);
+// Salin tile (opaque, semua page-nya) ke kolom dan page tujuan; terpotong di tepi
+void tile(uint8_t* buffer, const Ref& tile, int16_t x, uint8_t page);
+
+inline ui::Rect bounds(const Ref& sprite, int16_t x, int16_t y) { return {x, y, sprite.w, sprite.h}; }
+
+}  // namespace sprite
@@ -0,0 +1,139 @@
+#include "telemetry.h"
+
+#include "fixed_print.h"
+
+Telemetry telemetry;
+
+size_t TelemetryLog::write(uint8_t c) {
+    if (c == '\r') {
+        return 1;
+    }
+    if (c == '\n') {
+        flushLine();
+        return 1;
+    }
+    line_[length_++] = (char)c;
+    if (length_ >= sizeof(line_)) {
+        flushLine();  // Baris terlalu panjang dipecah jadi beberapa frame
+    }
+    return 1;
+}
+
+size_t TelemetryLog::write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        write(buffer[i]);
+    }
+    return size;
+}
+
+void TelemetryLog::flushLine() {
+    if (length_ == 0) return;
+    telemetry.send(MSG_LOG, line_, length_);
+    length_ = 0;
+}
+
+void Telemetry::begin(Stream& port) {
+    port_ = &port;
+}
+
+bool Telemetry::send(uint8_t type, const void* payload, size_t length) {
+    if (length > TELEMETRY_MAX_PAYLOAD) {
+        stats_.framesDropped++;
+        return false;
+    }
+
+    uint8_t raw[TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD];
+    raw[0] = type;
+    raw[1] = txSeq_;
+    memcpy(raw + 2, payload, length);
+    uint16_t crc = crc16(raw, length + 2);
+    raw[length + 2] = crc & 0xFF;
+    raw[length + 3] = crc >> 8;
+
+    uint8_t encoded[TELEMETRY_MAX_ENCODED];
+    size_t encodedLength = cobsEncode(raw, length + TELEMETRY_FRAME_OVERHEAD, encoded);
+    encoded[encodedLength++] = 0x00;
+
+    // Frame masuk utuh atau tidak sama sekali, host tidak pernah melihat frame terpotong
+    if (space() < encodedLength) {
+        stats_.framesDropped++;
+        return false;
+    }
+    for (size_t i = 0; i < encodedLength; i++) {
+        tx_.push(encoded[i]);
+    }
+    txSeq_++;
+    stats_.framesSent++;
+    if (tx_.size() > stats_.txHighWater) stats_.txHighWater = tx_.size();
+    return true;
+}
+
+void Telemetry::pump() {
+    if (!port_) return;
+    int room = port_->availableForWrite();
+    uint8_t chunk[64];
+    while (room > 0 && !tx_.empty()) {
+        size_t count = 0;
+        while (count < sizeof(chunk) && (int)count < room && tx_.pop(chunk[count])) {
+            count++;
+        }
+        port_->write(chunk, count);
+        stats_.bytesSent += count;
+        room -= count;
+    }
+}
+
+void Telemetry::poll() {
+    if (!port_) return;
+    while (port_->available() > 0) {
+        uint8_t c = (uint8_t)port_->read();
+        lastRxMs_ = millis();
+        if (c == 0x00) {
+            if (rxOverflow_) {
+                stats_.rxErrors++;
+            } else if (rxLength_ > 0) {
+                handleFrame(rx_, rxLength_);
+            }
+            rxLength_ = 0;
+            rxOverflow_ = false;
+        } else if (rxLength_ < sizeof(rx_)) {
+            rx_[rxLength_++] = c;
+        } else {
+            rxOverflow_ = true;  // Buang sampai pemisah berikutnya
+        }
+    }
+}
+
+void Telemetry::handleFrame(const uint8_t* encoded, size_t length) {
+    uint8_t raw[TELEMETRY_MAX_ENCODED];
+    size_t rawLength = cobsDecode(encoded, length, raw);
+    if (rawLength < TELEMETRY_FRAME_OVERHEAD) {
+        stats_.rxErrors++;
+        return;
+    }
+    size_t payloadLength = rawLength - TELEMETRY_FRAME_OVERHEAD;
+    uint16_t crc = raw[rawLength - 2] | (raw[rawLength - 1] << 8);
+    if (crc16(raw, rawLength - 2) != crc) {
+        stats_.rxErrors++;
+        return;
+    }
+    stats_.framesReceived++;
+
+    AckPayload ack = {raw[0], raw[1], ACK_UNKNOWN};
+    if (handler_) {
+        ack.status = handler_(raw[0], raw + 2, payloadLength);
+    }
+    send(MSG_ACK, &ack, sizeof(ack));
+}
+
+void Telemetry::report(Print& out) const {
+    fixedPrintf(out, "telemetry: %lu frames sent (%lu dropped), %lu bytes, %lu received, "
+                "%lu rx errors, tx peak %lu B\n",
+                (unsigned long)stats_.framesSent, (unsigned long)stats_.framesDropped, (unsigned long)stats_.bytesSent,
+                (unsigned long)stats_.framesReceived, (unsigned long)stats_.rxErrors,
+                (unsigned long)stats_.txHighWater);
+}
+
+void Telemetry::resetStats() {
+    stats_ = {};
+}
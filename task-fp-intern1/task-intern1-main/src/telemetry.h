@@ -0,0 +1,188 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "cobs.h"
+#include "ring_buffer.h"
+
+// Protokol telemetri biner di atas Serial.
+// Frame = COBS(type, seq, payload..., crc16 LE) + 0x00, CRC dihitung dari
+// type sampai akhir payload. Semua angka little-endian.
+// send() hanya menyalin ke ring TX; pump() memindahkan isi ring ke UART
+// sebanyak ruang kosong driver (availableForWrite), jadi loop() tidak pernah
+// menunggu UART. Jika ring penuh, frame dibuang utuh dan dihitung.
+// Decoder host: tools/telemetry.py
+
+#define TELEMETRY_BAUD 921600
+#define TELEMETRY_TX_RING 4096
+#define TELEMETRY_MAX_PAYLOAD 120
+#define TELEMETRY_FRAME_OVERHEAD 4  // type + seq + crc16
+#define TELEMETRY_MAX_ENCODED (COBS_MAX_ENCODED(TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD) + 1)
+
+enum TelemetryType : uint8_t {
+    // Perangkat -> host
+    MSG_SAMPLE = 0x01,
+    MSG_LOG = 0x02,
+    MSG_ACK = 0x03,
+    MSG_STATS = 0x04,
+    MSG_HISTORY = 0x05,
+    MSG_TRACE = 0x06,  // Potongan file trace, lihat trace.h
+
+    // Host -> perangkat
+    CMD_SET_ALARM = 0x10,
+    CMD_START_COUNTDOWN = 0x11,
+    CMD_SET_MODE = 0x12,
+    CMD_QUERY_STATS = 0x13,
+    CMD_PROFILE = 0x14,
+    CMD_HISTORY = 0x15,
+    CMD_TRACE = 0x16,
+};
+
+enum AckStatus : uint8_t {
+    ACK_OK = 0,
+    ACK_INVALID = 1,  // Payload salah ukuran atau nilai di luar batas
+    ACK_UNKNOWN = 2,  // Tipe perintah tidak dikenal
+    ACK_BUSY = 3,     // Valid, tapi tidak ada slot kosong (mis. semua timer terpakai)
+};
+
+#define SAMPLE_DHT_VALID 0x01
+#define SAMPLE_DARK 0x02
+#define SAMPLE_ALARM_RINGING 0x04
+
+struct __attribute__((packed)) SamplePayload {
+    uint32_t uptimeMs;
+    int16_t temperatureCenti;  // 0.01 C
+    uint16_t humidityDeci;     // 0.1 %
+    uint32_t lux;
+    uint8_t servo;             // Derajat
+    uint8_t mode;
+    uint8_t flags;             // SAMPLE_*
+};
+
+struct __attribute__((packed)) AckPayload {
+    uint8_t command;
+    uint8_t seq;
+    uint8_t status;  // AckStatus
+};
+
+struct __attribute__((packed)) StatsPayload {
+    uint32_t uptimeMs;
+    uint32_t loopAvgUs;
+    uint32_t loopMaxUs;
+    uint32_t frames;
+    uint32_t framesDropped;
+    uint32_t txDropped;
+    uint32_t rxErrors;
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;
+    uint32_t largestFreeBlock;  // Jauh di bawah freeHeap = heap terfragmentasi
+    uint32_t allocations;       // Alokasi heap setelah setup(), seharusnya 0
+};
+
+struct __attribute__((packed)) SetAlarmPayload {
+    uint8_t slot;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t days;     // Mask hari, lihat alarm_service.h
+    uint8_t enabled;
+};
+
+struct __attribute__((packed)) CountdownPayload {
+    uint32_t seconds;
+};
+
+struct __attribute__((packed)) ModePayload {
+    uint8_t mode;
+};
+
+struct __attribute__((packed)) ProfilePayload {
+    uint8_t reset;  // 0 = cetak histogram, 1 = kosongkan
+};
+
+struct __attribute__((packed)) HistoryQueryPayload {
+    uint32_t from;  // Unixtime, inklusif
+    uint32_t to;
+};
+
+struct __attribute__((packed)) TracePayload {
+    uint8_t enable;  // 1 = mulai capture, 0 = hentikan (diakhiri TRACE_END)
+};
+
+// MSG_HISTORY berisi 0..HISTORY_POINTS_PER_FRAME titik; frame yang tidak penuh
+// (termasuk kosong) menandai akhir ekspor
+struct __attribute__((packed)) HistoryPointPayload {
+    uint32_t time;
+    int16_t temperatureCenti;
+    uint16_t humidityDeci;
+    uint32_t lux;
+    uint8_t flags;  // SAMPLE_DHT_VALID
+};
+
+#define HISTORY_POINTS_PER_FRAME (TELEMETRY_MAX_PAYLOAD / sizeof(HistoryPointPayload))
+
+struct TelemetryStats {
+    uint32_t framesSent;
+    uint32_t framesDropped;
+    uint32_t bytesSent;
+    uint32_t framesReceived;
+    uint32_t rxErrors;  // CRC/COBS salah atau frame terlalu panjang
+    uint32_t txHighWater;
+};
+
+// Dijalankan untuk setiap frame perintah yang valid, return AckStatus
+typedef uint8_t (*TelemetryHandler)(uint8_t type, const uint8_t* payload, size_t length);
+
+// Teks lewat Print dikirim sebagai frame MSG_LOG, satu frame per baris
+class TelemetryLog : public Print {
+public:
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+private:
+    void flushLine();
+
+    char line_[TELEMETRY_MAX_PAYLOAD];
+    size_t length_ = 0;
+};
+
+class Telemetry {
+public:
+    void begin(Stream& port);
+    void onCommand(TelemetryHandler handler) { handler_ = handler; }
+
+    // Antre satu frame; false jika ring TX tidak cukup (frame dibuang)
+    bool send(uint8_t type, const void* payload, size_t length);
+    // Pindahkan ring TX ke UART tanpa memblokir
+    void pump();
+    // Baca dan jalankan frame perintah yang sudah lengkap
+    void poll();
+
+    Print& log() { return log_; }
+    size_t pending() const { return tx_.size(); }
+    size_t space() const { return tx_.capacity() - tx_.size(); }
+    // millis() saat byte terakhir dari host diterima; host aktif menahan light sleep
+    uint32_t lastRxMs() const { return lastRxMs_; }
+
+    const TelemetryStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    void handleFrame(const uint8_t* encoded, size_t length);
+
+    Stream* port_ = nullptr;
+    TelemetryHandler handler_ = nullptr;
+    TelemetryLog log_;
+    uint8_t txSeq_ = 0;
+    SpscRing<uint8_t, TELEMETRY_TX_RING> tx_;
+
+    uint8_t rx_[TELEMETRY_MAX_ENCODED];
+    size_t rxLength_ = 0;
+    bool rxOverflow_ = false;
+    uint32_t lastRxMs_ = 0;
+
+    TelemetryStats stats_ = {};
+};
+
+extern Telemetry telemetry;
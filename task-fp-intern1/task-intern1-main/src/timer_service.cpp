@@ -0,0 +1,240 @@
+#include "timer_service.h"
+
+#include "fixed_print.h"
+
+TimerService timerService;
+
+void TimerService::begin() {
+    for (Timer& timer : timers_) {
+        if (timer.handle != nullptr) continue;
+        esp_timer_create_args_t args = {};
+        args.callback = onTimer;
+        args.arg = &timer;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "countdown";
+        esp_timer_create(&args, &timer.handle);
+    }
+}
+
+// Callback esp_timer (task esp_timer): hanya catat waktu tembak
+void TimerService::onTimer(void* arg) {
+    Timer* timer = static_cast<Timer*>(arg);
+    timer->firedUs = esp_timer_get_time();
+    timer->fired.store(true, std::memory_order_release);
+}
+
+void TimerService::tick() {
+    for (int id = 0; id < TIMER_MAX; id++) {
+        Timer& timer = timers_[id];
+        if (!timer.fired.load(std::memory_order_acquire)) continue;
+        timer.fired.store(false, std::memory_order_relaxed);
+        if (timer.kind != TIMER_COUNTDOWN || timer.state != TIMER_RUNNING) {
+            continue;  // Dibatalkan/dijeda saat callback sudah berjalan
+        }
+
+        int32_t late = (int32_t)(timer.firedUs - timer.deadlineUs);
+        uint32_t latency = (uint32_t)(esp_timer_get_time() - timer.deadlineUs);
+        stats_.expired++;
+        stats_.lastLateUs = late;
+        if (late > stats_.maxLateUs) stats_.maxLateUs = late;
+        if (latency > stats_.eventLatencyUsMax) stats_.eventLatencyUsMax = latency;
+
+        timer.state = TIMER_IDLE;
+        if (onExpire_) {
+            onExpire_(id);
+        }
+    }
+}
+
+int TimerService::allocate(TimerKind kind) {
+    for (int id = 0; id < TIMER_MAX; id++) {
+        Timer& timer = timers_[id];
+        if (timer.state == TIMER_IDLE) {
+            timer.kind = kind;
+            timer.state = TIMER_RUNNING;
+            timer.startUs = esp_timer_get_time();
+            timer.accumulatedUs = 0;
+            timer.lapCount = 0;
+            timer.fired.store(false, std::memory_order_relaxed);
+            stats_.started++;
+            return id;
+        }
+    }
+    return -1;
+}
+
+int TimerService::startCountdown(uint64_t durationUs) {
+    if (durationUs == 0 || durationUs > TIMER_MAX_DURATION_US) {
+        return -1;
+    }
+    int id = allocate(TIMER_COUNTDOWN);
+    if (id < 0) {
+        return -1;
+    }
+    Timer& timer = timers_[id];
+    timer.deadlineUs = timer.startUs + (int64_t)durationUs;
+    esp_timer_start_once(timer.handle, durationUs);
+    return id;
+}
+
+int TimerService::startStopwatch() {
+    return allocate(TIMER_STOPWATCH);
+}
+
+void TimerService::pause(int id) {
+    if (!isRunning(id)) return;
+    Timer& timer = timers_[id];
+    int64_t now = esp_timer_get_time();
+    if (timer.kind == TIMER_COUNTDOWN) {
+        esp_timer_stop(timer.handle);
+        int64_t left = timer.deadlineUs - now;
+        timer.remainingUs = left > 1 ? left : 1;  // Tetap terjeda walau tenggat sudah lewat
+    } else {
+        timer.accumulatedUs += now - timer.startUs;
+    }
+    timer.state = TIMER_PAUSED;
+}
+
+void TimerService::resume(int id) {
+    if (!valid(id) || timers_[id].state != TIMER_PAUSED) return;
+    Timer& timer = timers_[id];
+    timer.startUs = esp_timer_get_time();
+    if (timer.kind == TIMER_COUNTDOWN) {
+        timer.deadlineUs = timer.startUs + timer.remainingUs;
+        timer.fired.store(false, std::memory_order_relaxed);
+        esp_timer_start_once(timer.handle, (uint64_t)timer.remainingUs);
+    }
+    timer.state = TIMER_RUNNING;
+}
+
+void TimerService::cancel(int id) {
+    if (!isActive(id)) return;
+    Timer& timer = timers_[id];
+    if (timer.kind == TIMER_COUNTDOWN && timer.state == TIMER_RUNNING) {
+        esp_timer_stop(timer.handle);
+    }
+    timer.state = TIMER_IDLE;
+}
+
+bool TimerService::lap(int id) {
+    if (!isRunning(id) || timers_[id].kind != TIMER_STOPWATCH) return false;
+    Timer& timer = timers_[id];
+    timer.splits[timer.lapCount % TIMER_MAX_LAPS] = (int64_t)elapsedUs(id);
+    timer.lapCount++;
+    stats_.laps++;
+    return true;
+}
+
+uint64_t TimerService::remainingUs(int id) const {
+    if (!isActive(id) || timers_[id].kind != TIMER_COUNTDOWN) return 0;
+    const Timer& timer = timers_[id];
+    if (timer.state == TIMER_PAUSED) return (uint64_t)timer.remainingUs;
+    int64_t left = timer.deadlineUs - esp_timer_get_time();
+    return left > 0 ? (uint64_t)left : 0;
+}
+
+uint64_t TimerService::elapsedUs(int id) const {
+    if (!isActive(id)) return 0;
+    const Timer& timer = timers_[id];
+    if (timer.kind == TIMER_COUNTDOWN) {
+        int64_t total = timer.deadlineUs - timer.startUs;
+        return (uint64_t)(total - (int64_t)remainingUs(id));
+    }
+    int64_t running = timer.state == TIMER_RUNNING ? esp_timer_get_time() - timer.startUs : 0;
+    return (uint64_t)(timer.accumulatedUs + running);
+}
+
+uint64_t TimerService::lapUs(int id, uint32_t n) const {
+    const Timer& timer = timers_[id];
+    if (n >= timer.lapCount || timer.lapCount - n > TIMER_MAX_LAPS) return 0;
+    int64_t split = timer.splits[n % TIMER_MAX_LAPS];
+    if (n == 0) return (uint64_t)split;
+    if (timer.lapCount - (n - 1) > TIMER_MAX_LAPS) return 0;  // Lap sebelumnya sudah tergeser
+    return (uint64_t)(split - timer.splits[(n - 1) % TIMER_MAX_LAPS]);
+}
+
+int TimerService::next(TimerKind kind, int after) const {
+    for (int i = 1; i <= TIMER_MAX; i++) {
+        int id = ((after < 0 ? -1 : after) + i) % TIMER_MAX;
+        if (isActive(id) && timers_[id].kind == kind) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+int TimerService::count(TimerKind kind) const {
+    int n = 0;
+    for (int id = 0; id < TIMER_MAX; id++) {
+        if (isActive(id) && timers_[id].kind == kind) n++;
+    }
+    return n;
+}
+
+void TimerService::snapshot(TimerSnapshot* out, int64_t offsetUs) const {
+    for (int id = 0; id < TIMER_MAX; id++) {
+        const Timer& timer = timers_[id];
+        TimerSnapshot& saved = out[id];
+        saved = {};
+        saved.state = timer.state;
+        if (timer.state == TIMER_IDLE) {
+            continue;  // Isi slot kosong tidak ikut, supaya salinan hanya berubah saat ada aksi
+        }
+        saved.kind = timer.kind;
+        saved.lapCount = timer.lapCount;
+        saved.startUs = timer.startUs + offsetUs;
+        saved.accumulatedUs = timer.accumulatedUs;
+        saved.deadlineUs = timer.deadlineUs + offsetUs;
+        saved.remainingUs = timer.remainingUs;
+        memcpy(saved.splits, timer.splits, sizeof(saved.splits));
+    }
+}
+
+void TimerService::restore(const TimerSnapshot* in, int64_t offsetUs) {
+    int64_t now = esp_timer_get_time();
+    for (int id = 0; id < TIMER_MAX; id++) {
+        cancel(id);
+        const TimerSnapshot& saved = in[id];
+        if ((saved.state != TIMER_RUNNING && saved.state != TIMER_PAUSED) ||
+            (saved.kind != TIMER_COUNTDOWN && saved.kind != TIMER_STOPWATCH)) {
+            continue;
+        }
+        Timer& timer = timers_[id];
+        timer.kind = (TimerKind)saved.kind;
+        timer.state = (TimerState)saved.state;
+        timer.lapCount = saved.lapCount;
+        timer.startUs = saved.startUs - offsetUs;
+        timer.accumulatedUs = saved.accumulatedUs;
+        timer.deadlineUs = saved.deadlineUs - offsetUs;
+        timer.remainingUs = saved.remainingUs;
+        memcpy(timer.splits, saved.splits, sizeof(timer.splits));
+        timer.fired.store(false, std::memory_order_relaxed);
+        if (timer.startUs > now) {
+            timer.startUs = now;  // Jam mundur sejak disimpan
+        }
+        if (timer.kind != TIMER_COUNTDOWN || timer.state != TIMER_RUNNING) {
+            continue;
+        }
+        int64_t left = timer.deadlineUs - now;
+        if (left > (int64_t)TIMER_MAX_DURATION_US) {
+            timer.state = TIMER_IDLE;  // Jam tidak cocok dengan saat disimpan
+        } else if (left <= 0) {
+            timer.firedUs = now;  // Tenggat lewat selama mati
+            timer.fired.store(true, std::memory_order_release);
+        } else {
+            esp_timer_start_once(timer.handle, (uint64_t)left);
+        }
+    }
+}
+
+void TimerService::report(Print& out) const {
+    fixedPrintf(out, "timers: %d countdown, %d stopwatch; %lu started, %lu expired (late last %ld us, max %ld us, "
+                "event max %lu us), %lu laps\n",
+                count(TIMER_COUNTDOWN), count(TIMER_STOPWATCH), (unsigned long)stats_.started,
+                (unsigned long)stats_.expired, (long)stats_.lastLateUs, (long)stats_.maxLateUs,
+                (unsigned long)stats_.eventLatencyUsMax, (unsigned long)stats_.laps);
+}
+
+void TimerService::resetStats() {
+    stats_ = {};
+}
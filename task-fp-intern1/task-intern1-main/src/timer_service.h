@@ -0,0 +1,123 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include <atomic>
+
+// Countdown dan stopwatch yang berjalan di latar belakang, beberapa sekaligus.
+// Semua waktu dalam us dari esp_timer_get_time() (64-bit, tidak overflow).
+// Countdown menyimpan tenggat absolut sejak start, jadi sisa waktu dihitung
+// dari tenggat itu dan tidak bergeser oleh waktu render atau periode tick.
+// Setiap countdown punya esp_timer one-shot sendiri; callback-nya hanya
+// mencatat waktu tembak, event selesai diteruskan ke aplikasi dari tick().
+// Stopwatch tidak butuh timer: waktu berjalan = akumulasi + (sekarang - start).
+
+#define TIMER_MAX 4
+#define TIMER_MAX_LAPS 8                               // Lap terakhir yang disimpan per stopwatch
+#define TIMER_MAX_DURATION_US (24ULL * 3600 * 1000000)
+
+enum TimerKind : uint8_t {
+    TIMER_COUNTDOWN,
+    TIMER_STOPWATCH,
+};
+
+enum TimerState : uint8_t {
+    TIMER_IDLE,     // Slot kosong
+    TIMER_RUNNING,
+    TIMER_PAUSED,
+};
+
+struct TimerStats {
+    uint32_t started;
+    uint32_t expired;
+    uint32_t laps;
+    int32_t lastLateUs;  // Waktu tembak esp_timer - tenggat, countdown terakhir
+    int32_t maxLateUs;
+    uint32_t eventLatencyUsMax;  // Tenggat sampai callback aplikasi di tick()
+};
+
+// Salinan satu slot untuk disimpan lewat reset (boot_manager). esp_timer mulai
+// dari nol setiap boot, jadi waktu absolut disimpan sebagai unixtime (us).
+struct TimerSnapshot {
+    uint8_t kind;
+    uint8_t state;
+    uint8_t reserved[2];
+    uint32_t lapCount;
+    int64_t startUs;
+    int64_t accumulatedUs;
+    int64_t deadlineUs;
+    int64_t remainingUs;
+    int64_t splits[TIMER_MAX_LAPS];
+};
+
+typedef void (*TimerCallback)(int id);
+
+class TimerService {
+public:
+    void begin();
+    // Dipanggil periodik; meneruskan countdown yang selesai ke callback
+    void tick();
+
+    // Return id timer, -1 jika semua slot terpakai atau durasi tidak valid
+    int startCountdown(uint64_t durationUs);
+    int startStopwatch();
+    void pause(int id);
+    void resume(int id);
+    // Hentikan dan kosongkan slot
+    void cancel(int id);
+    // Catat lap stopwatch yang sedang berjalan
+    bool lap(int id);
+
+    bool isActive(int id) const { return valid(id) && timers_[id].state != TIMER_IDLE; }
+    bool isRunning(int id) const { return valid(id) && timers_[id].state == TIMER_RUNNING; }
+    TimerKind kind(int id) const { return timers_[id].kind; }
+    // Countdown: sisa waktu; stopwatch: waktu berjalan
+    uint64_t remainingUs(int id) const;
+    uint64_t elapsedUs(int id) const;
+    // Lap ke-n (0 = pertama), durasi sejak lap sebelumnya; 0 jika sudah tergeser
+    uint32_t lapCount(int id) const { return timers_[id].lapCount; }
+    uint64_t lapUs(int id, uint32_t n) const;
+
+    // Timer aktif berikutnya dengan jenis tertentu setelah id `after` (-1: dari awal), melingkar
+    int next(TimerKind kind, int after) const;
+    int count(TimerKind kind) const;
+
+    // Salin/pulihkan semua slot (TIMER_MAX entri, id tetap sama). offsetUs =
+    // unixtime dalam us dikurangi esp_timer_get_time() (ClockService::offsetUs()).
+    // Countdown yang tenggatnya lewat selama mati selesai di tick() berikutnya.
+    void snapshot(TimerSnapshot* out, int64_t offsetUs) const;
+    void restore(const TimerSnapshot* in, int64_t offsetUs);
+
+    // Dipanggil dari tick() saat countdown selesai; slot sudah kosong lagi
+    void onExpire(TimerCallback callback) { onExpire_ = callback; }
+
+    const TimerStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    struct Timer {
+        TimerKind kind;
+        TimerState state;
+        int64_t startUs;        // Start/resume terakhir
+        int64_t accumulatedUs;  // Stopwatch: waktu berjalan sebelum start/resume terakhir
+        int64_t deadlineUs;     // Countdown berjalan: tenggat absolut
+        int64_t remainingUs;    // Countdown dijeda: sisa waktu
+        int64_t splits[TIMER_MAX_LAPS];  // Waktu berjalan saat lap, ring
+        uint32_t lapCount;
+        esp_timer_handle_t handle;
+        int64_t firedUs;        // Ditulis callback esp_timer sebelum fired
+        std::atomic<bool> fired;
+    };
+
+    bool valid(int id) const { return id >= 0 && id < TIMER_MAX; }
+    int allocate(TimerKind kind);
+    static void onTimer(void* arg);
+
+    Timer timers_[TIMER_MAX] = {};
+    TimerCallback onExpire_ = nullptr;
+    TimerStats stats_ = {};
+};
+
+extern TimerService timerService;
@@ -0,0 +1,346 @@
+#include "trace.h"
+
+#include <esp_timer.h>
+#include <math.h>
+
+#include "fixed_print.h"
+
+TraceRecorder traceRecorder;
+
+static size_t putVarint(uint8_t* out, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static bool getVarint(const uint8_t* in, size_t length, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 70 && pos < length; shift += 7) {
+        uint8_t b = in[pos++];
+        value |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+static int64_t unzigzag(uint64_t value) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+size_t TraceWriter::header(uint64_t uptimeUs, uint8_t* out) {
+    TraceHeader header = {TRACE_MAGIC, TRACE_VERSION, 0, uptimeUs};
+    memcpy(out, &header, sizeof(header));
+    return sizeof(header);
+}
+
+size_t TraceWriter::sync(uint32_t frame, uint64_t timeUs, uint8_t* out) {
+    size_t n = 0;
+    out[n++] = TRACE_SYNC << 4;
+    n += putVarint(out + n, frame);
+    n += putVarint(out + n, timeUs);
+    lastUs_ = timeUs;
+    return n;
+}
+
+size_t TraceWriter::encode(const TraceEvent& event, uint8_t* out) {
+    size_t n = 0;
+    out[n++] = (uint8_t)(event.type << 4 | (event.arg & 0x0F));
+    n += putVarint(out + n, zigzag((int64_t)(event.timeUs - lastUs_)));
+    lastUs_ = event.timeUs;
+    switch (event.type) {
+        case TRACE_DHT:
+            if (event.arg) {
+                n += putVarint(out + n, zigzag(event.value));
+                n += putVarint(out + n, (uint32_t)event.value2);
+            }
+            break;
+        case TRACE_LDR:
+        case TRACE_RTC:
+        case TRACE_GAP:
+            n += putVarint(out + n, (uint32_t)event.value);
+            break;
+        case TRACE_COMMAND:
+            out[n++] = event.command;
+            memcpy(out + n, event.payload, event.arg);
+            n += event.arg;
+            break;
+    }
+    return n;
+}
+
+TraceReader::TraceReader(const uint8_t* data, size_t length) : data_(data), length_(length) {
+    TraceHeader header;
+    if (length < sizeof(header)) {
+        return;
+    }
+    memcpy(&header, data, sizeof(header));
+    valid_ = header.magic == TRACE_MAGIC && header.version == TRACE_VERSION;
+    uptimeUs_ = header.uptimeUs;
+    pos_ = sizeof(header);
+}
+
+bool TraceReader::next(TraceEvent& event) {
+    while (valid_ && !corrupt_ && pos_ < length_) {
+        uint8_t tag = data_[pos_++];
+        uint8_t type = tag >> 4;
+        uint64_t a, b = 0;
+        if (type == TRACE_SYNC) {
+            if (!getVarint(data_, length_, pos_, a) || !getVarint(data_, length_, pos_, b)) {
+                corrupt_ = true;
+                return false;
+            }
+            if (a > frame_) lostFrames_ += (uint32_t)(a - frame_);
+            frame_ = (uint32_t)a + 1;
+            timeUs_ = b;
+            continue;
+        }
+        if (type > TRACE_END || !getVarint(data_, length_, pos_, a)) {
+            corrupt_ = true;
+            return false;
+        }
+
+        event = TraceEvent();
+        timeUs_ += unzigzag(a);
+        event.timeUs = timeUs_;
+        event.type = type;
+        event.arg = tag & 0x0F;
+        bool ok = true;
+        switch (type) {
+            case TRACE_DHT:
+                if (event.arg) {
+                    ok = getVarint(data_, length_, pos_, a) && getVarint(data_, length_, pos_, b);
+                    event.value = (int32_t)unzigzag(a);
+                    event.value2 = (int32_t)b;
+                }
+                break;
+            case TRACE_LDR:
+            case TRACE_RTC:
+            case TRACE_GAP:
+                ok = getVarint(data_, length_, pos_, a);
+                event.value = (int32_t)a;
+                break;
+            case TRACE_COMMAND:
+                ok = event.arg <= TRACE_COMMAND_MAX && pos_ + 1 + event.arg <= length_;
+                if (ok) {
+                    event.command = data_[pos_++];
+                    memcpy(event.payload, data_ + pos_, event.arg);
+                    pos_ += event.arg;
+                }
+                break;
+        }
+        if (!ok) {
+            corrupt_ = true;
+            return false;
+        }
+        if (type == TRACE_GAP) {
+            lostEvents_ += event.value;
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+void TraceRecorder::start(uint32_t unixtime, bool dhtValid, float temperature, float humidity, uint16_t ldrBlock) {
+    active_.store(false, std::memory_order_release);
+    TraceEvent stale;
+    while (ui_.pop(stale)) {
+    }
+    while (sensor_.pop(stale)) {
+    }
+    droppedSeen_ = ui_.dropped() + sensor_.dropped();
+    hasHead_[0] = hasHead_[1] = false;
+    stopping_ = false;
+
+    uint32_t now = micros();
+    lastAtUs_ = now;
+    timeUs_ = 0;
+    frame_ = 0;
+    writer_.reset();
+    chunkLength_ = TraceWriter::header(esp_timer_get_time(), chunk_);
+    chunkSynced_ = false;
+    chunkStartMs_ = millis();
+    resetStats();
+    generation_.fetch_add(1, std::memory_order_relaxed);
+
+    TraceEvent event = {};
+    event.timeUs = now;
+    event.type = TRACE_RTC;
+    event.value = (int32_t)unixtime;
+    ui_.push(event);
+    event = {};
+    event.timeUs = now;
+    event.type = TRACE_DHT;
+    event.arg = dhtValid;
+    event.value = dhtValid ? (int32_t)lroundf(temperature * 100) : 0;
+    event.value2 = dhtValid ? (int32_t)lroundf(humidity * 10) : 0;
+    ui_.push(event);
+    event = {};
+    event.timeUs = now;
+    event.type = TRACE_LDR;
+    event.value = ldrBlock;
+    ui_.push(event);
+    active_.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop() {
+    if (active()) {
+        active_.store(false, std::memory_order_release);
+        stopping_ = true;
+    }
+}
+
+void TraceRecorder::button(uint8_t button, uint8_t level, uint32_t timeUs) {
+    if (!active()) return;
+    TraceEvent event = {};
+    event.timeUs = timeUs;
+    event.type = TRACE_BUTTON;
+    event.arg = (uint8_t)(button << 1 | (level ? 1 : 0));
+    ui_.push(event);
+}
+
+void TraceRecorder::rtc(uint32_t unixtime, uint32_t timeUs) {
+    if (!active()) return;
+    TraceEvent event = {};
+    event.timeUs = timeUs;
+    event.type = TRACE_RTC;
+    event.value = (int32_t)unixtime;
+    ui_.push(event);
+}
+
+void TraceRecorder::command(uint8_t type, const uint8_t* payload, size_t length) {
+    if (!active() || length > TRACE_COMMAND_MAX) return;
+    TraceEvent event = {};
+    event.timeUs = micros();
+    event.type = TRACE_COMMAND;
+    event.arg = (uint8_t)length;
+    event.command = type;
+    memcpy(event.payload, payload, length);
+    ui_.push(event);
+}
+
+void TraceRecorder::dht(bool valid, float temperature, float humidity, uint32_t timeUs) {
+    if (!active()) return;
+    TraceEvent event = {};
+    event.timeUs = timeUs;
+    event.type = TRACE_DHT;
+    event.arg = valid;
+    if (valid) {
+        event.value = (int32_t)lroundf(temperature * 100);
+        event.value2 = (int32_t)lroundf(humidity * 10);
+    }
+    sensor_.push(event);
+}
+
+void TraceRecorder::ldr(uint16_t block, uint32_t timeUs) {
+    if (!active()) return;
+    // Blok pertama setiap capture selalu dicatat, sesudahnya hanya yang berubah
+    uint32_t generation = generation_.load(std::memory_order_relaxed);
+    if (generation == ldrGeneration_ && block == ldrLast_) return;
+    ldrGeneration_ = generation;
+    ldrLast_ = block;
+    TraceEvent event = {};
+    event.timeUs = timeUs;
+    event.type = TRACE_LDR;
+    event.value = block;
+    sensor_.push(event);
+}
+
+// Gabungkan kedua ring, yang paling awal lebih dulu; waktu diubah ke us sejak start()
+bool TraceRecorder::nextEvent(TraceEvent& event) {
+    if (!hasHead_[0]) hasHead_[0] = ui_.pop(head_[0]);
+    if (!hasHead_[1]) hasHead_[1] = sensor_.pop(head_[1]);
+    int side;
+    if (hasHead_[0] && hasHead_[1]) {
+        side = (int32_t)((uint32_t)head_[1].timeUs - (uint32_t)head_[0].timeUs) < 0 ? 1 : 0;
+    } else if (hasHead_[0] || hasHead_[1]) {
+        side = hasHead_[0] ? 0 : 1;
+    } else {
+        return false;
+    }
+    event = head_[side];
+    hasHead_[side] = false;
+
+    // Tepi tombol diberi waktu ISR dan bisa sedikit mendahului event sebelumnya
+    uint32_t at = (uint32_t)event.timeUs;
+    timeUs_ += (int32_t)(at - lastAtUs_);
+    if (timeUs_ < 0) timeUs_ = 0;
+    lastAtUs_ = at;
+    event.timeUs = (uint64_t)timeUs_;
+    return true;
+}
+
+void TraceRecorder::append(const TraceEvent& event) {
+    if (chunkLength_ + TRACE_EVENT_MAX_ENCODED > sizeof(chunk_)) {
+        flush();
+    }
+    if (!chunkSynced_) {
+        if (chunkLength_ == 0) chunkStartMs_ = millis();
+        chunkLength_ += writer_.sync(frame_, event.timeUs, chunk_ + chunkLength_);
+        chunkSynced_ = true;
+    }
+    chunkLength_ += writer_.encode(event, chunk_ + chunkLength_);
+}
+
+void TraceRecorder::flush() {
+    if (chunkLength_ == 0) {
+        return;
+    }
+    if (telemetry.send(MSG_TRACE, chunk_, chunkLength_)) {
+        stats_.frames++;
+        stats_.bytes += chunkLength_;
+    } else {
+        stats_.framesDropped++;  // Nomor frame tetap naik, replay melihat lompatannya
+    }
+    frame_++;
+    chunkLength_ = 0;
+    chunkSynced_ = false;
+}
+
+void TraceRecorder::pump() {
+    if (!active() && !stopping_) {
+        return;
+    }
+    uint32_t dropped = ui_.dropped() + sensor_.dropped();
+    if (dropped != droppedSeen_) {
+        TraceEvent gap = {};
+        gap.timeUs = (uint64_t)timeUs_;
+        gap.type = TRACE_GAP;
+        gap.value = (int32_t)(dropped - droppedSeen_);
+        append(gap);
+        stats_.eventsDropped += dropped - droppedSeen_;
+        droppedSeen_ = dropped;
+    }
+
+    TraceEvent event;
+    while (nextEvent(event)) {
+        append(event);
+        stats_.events++;
+    }
+
+    if (stopping_) {
+        TraceEvent end = {};
+        end.timeUs = (uint64_t)timeUs_ + (uint32_t)(micros() - lastAtUs_);
+        end.type = TRACE_END;
+        append(end);
+        flush();
+        stopping_ = false;
+    } else if (chunkLength_ > 0 && millis() - chunkStartMs_ >= TRACE_FLUSH_MS) {
+        flush();
+    }
+}
+
+void TraceRecorder::report(Print& out) const {
+    fixedPrintf(out, "trace: %s, %lu events (%lu dropped), %lu frames (%lu dropped), %lu bytes\n",
+                active() ? "capturing" : "idle", (unsigned long)stats_.events, (unsigned long)stats_.eventsDropped,
+                (unsigned long)stats_.frames, (unsigned long)stats_.framesDropped, (unsigned long)stats_.bytes);
+}
+
+void TraceRecorder::resetStats() {
+    stats_ = {};
+}
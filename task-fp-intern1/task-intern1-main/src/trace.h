@@ -0,0 +1,160 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+#include "ring_buffer.h"
+#include "telemetry.h"
+
+// Rekam input dan sensor untuk replay deterministik di host.
+// Selama capture aktif (CMD_TRACE dari host) tepi tombol, bacaan RTC, perintah
+// host, bacaan DHT dan blok LDR dicatat dengan timestamp micros() ke dua ring
+// SPSC, satu per sisi produsen (UI dan loop kontrol). pump() di sisi UI
+// menggabungkan keduanya, meng-encode ke format biner ringkas dan mengirimnya
+// sebagai frame MSG_TRACE; payload MSG_TRACE berurutan = isi file trace.
+//
+// Format: TraceHeader, lalu event [tag][delta us zigzag varint][isi], tag =
+// tipe << 4 | arg. Setiap frame MSG_TRACE diawali TRACE_SYNC (nomor frame dan
+// waktu absolut), jadi frame yang dibuang ring TX hanya menghilangkan event di
+// dalamnya dan terlihat dari nomor yang melompat.
+// Replay di host: test/test_replay (jam virtual lib/native_hw), host capture:
+// tools/telemetry.py --trace.
+
+#define TRACE_MAGIC 0x31435254         // "TRC1"
+#define TRACE_VERSION 1
+#define TRACE_RING_SIZE 32             // Event per sisi produsen, dikuras setiap run task telemetri
+#define TRACE_FLUSH_MS 250             // Frame yang belum penuh tetap dikirim setelah ini
+#define TRACE_COMMAND_MAX 8            // Payload perintah host yang ikut direkam
+#define TRACE_EVENT_MAX_ENCODED 24     // Tag + delta varint + perintah 1 + 8 byte
+
+enum TraceType : uint8_t {
+    TRACE_SYNC,     // Awal frame: nomor frame, waktu absolut (tidak dikembalikan TraceReader)
+    TRACE_BUTTON,   // arg = tombol << 1 | level pin
+    TRACE_DHT,      // arg = bacaan valid; value = suhu 0.01 C, value2 = kelembapan 0.1 %
+    TRACE_LDR,      // value = blok ADC (jumlah LDR_OVERSAMPLE sampel 12-bit), hanya saat berubah
+    TRACE_RTC,      // value = unixtime yang dibaca dari DS1307
+    TRACE_COMMAND,  // arg = panjang payload; command = tipe perintah
+    TRACE_GAP,      // value = event yang hilang karena ring penuh
+    TRACE_END,      // Capture dihentikan
+};
+
+struct __attribute__((packed)) TraceHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint64_t uptimeUs;  // esp_timer saat capture dimulai; replay memulai pada fase task yang sama
+};
+
+struct TraceEvent {
+    uint64_t timeUs;  // Sejak awal capture; di ring: micros() saat kejadian
+    uint8_t type;     // TraceType
+    uint8_t arg;
+    uint8_t command;
+    int32_t value;
+    int32_t value2;
+    uint8_t payload[TRACE_COMMAND_MAX];
+};
+
+// Encoder satu aliran event; waktu event harus sudah relatif ke awal capture
+class TraceWriter {
+public:
+    void reset() { lastUs_ = 0; }
+    static size_t header(uint64_t uptimeUs, uint8_t* out);
+    // Return panjang hasil encode, paling banyak TRACE_EVENT_MAX_ENCODED
+    size_t encode(const TraceEvent& event, uint8_t* out);
+    // TRACE_SYNC: waktu absolut, delta berikutnya dihitung dari sini
+    size_t sync(uint32_t frame, uint64_t timeUs, uint8_t* out);
+
+private:
+    uint64_t lastUs_ = 0;
+};
+
+// Decoder file trace (isi MSG_TRACE berurutan)
+class TraceReader {
+public:
+    TraceReader(const uint8_t* data, size_t length);
+    bool valid() const { return valid_; }
+    uint64_t uptimeUs() const { return uptimeUs_; }
+    // Event berikutnya, false di akhir data atau jika data rusak
+    bool next(TraceEvent& event);
+    bool corrupt() const { return corrupt_; }
+    uint32_t lostFrames() const { return lostFrames_; }
+    uint32_t lostEvents() const { return lostEvents_; }
+
+private:
+    const uint8_t* data_;
+    size_t length_;
+    size_t pos_ = 0;
+    uint64_t uptimeUs_ = 0;
+    uint64_t timeUs_ = 0;
+    uint32_t frame_ = 0;
+    bool valid_ = false;
+    bool corrupt_ = false;
+    uint32_t lostFrames_ = 0;
+    uint32_t lostEvents_ = 0;
+};
+
+struct TraceStats {
+    uint32_t events;
+    uint32_t eventsDropped;  // Ring penuh, dicatat sebagai TRACE_GAP
+    uint32_t frames;
+    uint32_t framesDropped;  // Ring TX telemetri penuh
+    uint32_t bytes;
+};
+
+class TraceRecorder {
+public:
+    // Dipanggil dari sisi UI; jam dan bacaan sensor terakhir menjadi event pertama
+    void start(uint32_t unixtime, bool dhtValid, float temperature, float humidity, uint16_t ldrBlock);
+    // Sisa event dikirim di pump() berikutnya, diakhiri TRACE_END
+    void stop();
+    bool active() const { return active_.load(std::memory_order_acquire); }
+
+    // Produsen sisi UI (input, jam, telemetri)
+    void button(uint8_t button, uint8_t level, uint32_t timeUs);
+    void rtc(uint32_t unixtime, uint32_t timeUs);
+    void command(uint8_t type, const uint8_t* payload, size_t length);
+    // Produsen sisi kontrol (DHT, LDR)
+    void dht(bool valid, float temperature, float humidity, uint32_t timeUs);
+    void ldr(uint16_t block, uint32_t timeUs);
+
+    // Dipanggil periodik dari task telemetri: encode dan kirim sebagai MSG_TRACE
+    void pump();
+
+    const TraceStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    bool nextEvent(TraceEvent& event);
+    void append(const TraceEvent& event);
+    void flush();
+
+    std::atomic<bool> active_{false};
+    bool stopping_ = false;
+    SpscRing<TraceEvent, TRACE_RING_SIZE> ui_;
+    SpscRing<TraceEvent, TRACE_RING_SIZE> sensor_;
+    uint32_t droppedSeen_ = 0;  // ui_.dropped() + sensor_.dropped() yang sudah dilaporkan
+    std::atomic<uint32_t> generation_{0};  // Naik setiap start()
+
+    // Dipakai produsen sisi kontrol saja
+    uint32_t ldrGeneration_ = 0;
+    uint16_t ldrLast_ = 0;
+
+    // Dipakai pump() saja
+    TraceEvent head_[2];
+    bool hasHead_[2] = {};
+    uint32_t lastAtUs_ = 0;
+    int64_t timeUs_ = 0;
+    TraceWriter writer_;
+    uint8_t chunk_[TELEMETRY_MAX_PAYLOAD];
+    size_t chunkLength_ = 0;
+    bool chunkSynced_ = false;  // TRACE_SYNC sudah ditulis di frame ini
+    uint32_t chunkStartMs_ = 0;
+    uint32_t frame_ = 0;
+
+    TraceStats stats_ = {};
+};
+
+extern TraceRecorder traceRecorder;
@@ -0,0 +1,130 @@
+#include "trend_service.h"
+
+#include "history_log.h"
+
+TrendService trendService;
+
+static const uint32_t TREND_WINDOW_MS[TREND_WINDOWS] = {60000UL, 3600000UL, 86400000UL};
+static const char* const TREND_WINDOW_LABEL[TREND_WINDOWS] = {"1m", "1h", "24h"};
+
+void TrendSeries::reset() {
+    memset(buckets_, 0, sizeof(buckets_));
+    seq_ = 0;
+    minDeque_.head = minDeque_.size = 0;
+    maxDeque_.head = maxDeque_.size = 0;
+    sum_ = 0;
+    count_ = 0;
+}
+
+void TrendSeries::add(int32_t value) {
+    TrendBucket& b = buckets_[seq_ % TREND_COLUMNS];
+    if (b.count == 0) {
+        b.min = b.max = value;
+    } else {
+        if (value < b.min) b.min = value;
+        if (value > b.max) b.max = value;
+    }
+    b.sum += value;
+    b.count++;
+}
+
+void TrendSeries::advance() {
+    const TrendBucket& closed = bucket(seq_);
+    if (closed.count > 0) {
+        // Bucket yang kalah dari bucket lebih baru tidak akan pernah jadi min/max lagi
+        while (minDeque_.size > 0 && bucket(minDeque_.back()).min >= closed.min) minDeque_.popBack();
+        minDeque_.pushBack(seq_);
+        while (maxDeque_.size > 0 && bucket(maxDeque_.back()).max <= closed.max) maxDeque_.popBack();
+        maxDeque_.pushBack(seq_);
+        sum_ += closed.sum;
+        count_ += closed.count;
+    }
+
+    seq_++;
+    // Bucket baru memakai slot bucket tertua: keluarkan dari jendela dulu
+    uint16_t expired = seq_ - TREND_COLUMNS;
+    TrendBucket& slot = buckets_[seq_ % TREND_COLUMNS];
+    if (slot.count > 0) {
+        sum_ -= slot.sum;
+        count_ -= slot.count;
+        if (minDeque_.size > 0 && minDeque_.front() == expired) minDeque_.popFront();
+        if (maxDeque_.size > 0 && maxDeque_.front() == expired) maxDeque_.popFront();
+    }
+    slot = {};
+}
+
+TrendSummary TrendSeries::summary() const {
+    TrendSummary s = {0, 0, 0, count_};
+    int64_t sum = sum_;
+    bool any = false;
+    if (minDeque_.size > 0) {
+        s.min = bucket(minDeque_.front()).min;
+        s.max = bucket(maxDeque_.front()).max;
+        any = true;
+    }
+    const TrendBucket& open = bucket(seq_);
+    if (open.count > 0) {
+        if (!any || open.min < s.min) s.min = open.min;
+        if (!any || open.max > s.max) s.max = open.max;
+        sum += open.sum;
+        s.count += open.count;
+    }
+    s.mean = s.count ? (int32_t)(sum / (int64_t)s.count) : 0;
+    return s;
+}
+
+static bool backfillRecord(const HistoryRecord& record, void* context) {
+    static_cast<TrendService*>(context)->add((uint64_t)record.time * 1000, record.dhtValid,
+                                             record.temperatureCenti, record.humidityDeci, true, record.lux);
+    return true;
+}
+
+void TrendService::begin(uint32_t nowUnix) {
+    for (auto& window : series_) {
+        for (auto& series : window) {
+            series.reset();
+        }
+    }
+    started_ = false;
+    if (historyLog.mounted()) {
+        uint32_t span = TREND_WINDOW_MS[TREND_24HOUR] / 1000;
+        historyLog.query(nowUnix > span ? nowUnix - span : 0, nowUnix, backfillRecord, this);
+    }
+}
+
+void TrendService::add(uint64_t timeMs, bool dhtValid, int32_t temperatureCenti, int32_t humidityDeci,
+                       bool luxValid, int32_t lux) {
+    for (uint8_t w = 0; w < TREND_WINDOWS; w++) {
+        TrendSeries* series = series_[w];
+        uint64_t index = timeMs * TREND_COLUMNS / TREND_WINDOW_MS[w];
+        if (!started_ || index < bucketIndex_[w] || index - bucketIndex_[w] >= TREND_COLUMNS) {
+            // Awal, jam mundur, atau celah lebih panjang dari jendela: mulai dari kosong
+            if (started_) {
+                for (uint8_t m = 0; m < TREND_METRICS; m++) series[m].reset();
+            }
+        } else {
+            for (uint64_t i = bucketIndex_[w]; i < index; i++) {
+                for (uint8_t m = 0; m < TREND_METRICS; m++) series[m].advance();
+            }
+        }
+        bucketIndex_[w] = index;
+
+        if (dhtValid) {
+            series[TREND_TEMPERATURE].add(temperatureCenti);
+            series[TREND_HUMIDITY].add(humidityDeci);
+        }
+        if (luxValid) {
+            series[TREND_LUX].add(lux);
+        }
+    }
+    started_ = true;
+    revision_++;
+}
+
+uint32_t TrendService::windowMs(TrendWindow window) {
+    return TREND_WINDOW_MS[window];
+}
+
+const char* TrendService::windowLabel(TrendWindow window) {
+    return TREND_WINDOW_LABEL[window];
+}
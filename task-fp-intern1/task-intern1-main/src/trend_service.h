@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Statistik jendela geser untuk layar tren.
+// Setiap jendela (1 menit, 1 jam, 24 jam) dibagi menjadi TREND_COLUMNS
+// bucket, satu per kolom piksel OLED, jadi grafik digambar langsung dari
+// bucket tanpa membaca ulang sampel mentah. Min/max jendela dijaga dengan
+// deque monoton berisi bucket tertutup dan rata-rata dengan jumlah berjalan;
+// setiap sampel dan setiap pergeseran bucket O(1) (amortized), memori tetap.
+// Setelah boot, jendela diisi ulang dari riwayat flash (history_log.h).
+
+#define TREND_COLUMNS 128       // Lebar OLED
+#define TREND_SAMPLE_MS 500
+
+enum TrendMetric : uint8_t {
+    TREND_TEMPERATURE,  // 0.01 C
+    TREND_HUMIDITY,     // 0.1 %
+    TREND_LUX,
+    TREND_METRICS
+};
+
+enum TrendWindow : uint8_t {
+    TREND_1MIN,
+    TREND_1HOUR,
+    TREND_24HOUR,
+    TREND_WINDOWS
+};
+
+struct TrendBucket {
+    int32_t min;
+    int32_t max;
+    int32_t sum;
+    uint16_t count;  // 0 = tidak ada sampel (celah di grafik)
+};
+
+struct TrendSummary {
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+    uint32_t count;  // 0 = belum ada data di jendela
+};
+
+// Satu deret nilai dalam satu jendela
+class TrendSeries {
+public:
+    void reset();
+    // Tambahkan sampel ke bucket terbuka (kolom paling kanan)
+    void add(int32_t value);
+    // Tutup bucket terbuka dan buka bucket baru; bucket tertua keluar dari jendela
+    void advance();
+
+    TrendSummary summary() const;
+    // Kolom 0 = bucket tertua, TREND_COLUMNS - 1 = bucket terbuka
+    const TrendBucket& column(uint8_t x) const { return buckets_[(uint16_t)(seq_ + 1 + x) % TREND_COLUMNS]; }
+
+private:
+    // Deque nomor bucket; nilai bucket-nya monoton dari depan ke belakang
+    struct Deque {
+        uint16_t items[TREND_COLUMNS];
+        uint8_t head;
+        uint8_t size;
+
+        uint16_t front() const { return items[head]; }
+        uint16_t back() const { return items[(head + size - 1) % TREND_COLUMNS]; }
+        void pushBack(uint16_t seq) { items[(head + size++) % TREND_COLUMNS] = seq; }
+        void popBack() { size--; }
+        void popFront() {
+            head = (head + 1) % TREND_COLUMNS;
+            size--;
+        }
+    };
+
+    const TrendBucket& bucket(uint16_t seq) const { return buckets_[seq % TREND_COLUMNS]; }
+
+    TrendBucket buckets_[TREND_COLUMNS];
+    uint16_t seq_ = 0;  // Nomor bucket terbuka; TREND_COLUMNS membagi 65536, jadi wrap aman
+    Deque minDeque_;
+    Deque maxDeque_;
+    int64_t sum_ = 0;   // Bucket tertutup di jendela
+    uint32_t count_ = 0;
+};
+
+class TrendService {
+public:
+    // Isi jendela dari riwayat flash (maksimal 24 jam terakhir)
+    void begin(uint32_t nowUnix);
+    // Satu sampel pada waktu unix dalam ms; sampel yang tidak valid dilewati per besaran
+    void add(uint64_t timeMs, bool dhtValid, int32_t temperatureCenti, int32_t humidityDeci, bool luxValid,
+             int32_t lux);
+
+    const TrendSeries& series(TrendWindow window, TrendMetric metric) const { return series_[window][metric]; }
+    TrendSummary summary(TrendWindow window, TrendMetric metric) const { return series_[window][metric].summary(); }
+    // Bertambah setiap ada sampel, untuk melewati render jika grafik tidak berubah
+    uint32_t revision() const { return revision_; }
+
+    static uint32_t windowMs(TrendWindow window);
+    static const char* windowLabel(TrendWindow window);
+
+private:
+    TrendSeries series_[TREND_WINDOWS][TREND_METRICS];
+    uint64_t bucketIndex_[TREND_WINDOWS] = {};  // Bucket terbuka = timeMs * TREND_COLUMNS / windowMs
+    bool started_ = false;
+    uint32_t revision_ = 0;
+};
+
+extern TrendService trendService;
@@ -0,0 +1,322 @@
+#include "ui.h"
+
+#include "fixed_print.h"
+#include "profiler.h"
+
+namespace ui {
+
+Rect Widget::update(Renderer& renderer) {
+    renderer.gfx().fillRect(bounds_.x, bounds_.y, bounds_.w, bounds_.h, BLACK);
+    draw(renderer);
+    return bounds_;
+}
+
+// ---- TextRow ----
+
+void TextRow::place(int16_t x, int16_t y, uint8_t size, uint8_t maxChars) {
+    x_ = x;
+    y_ = y;
+    size_ = size;
+    maxChars_ = maxChars < UI_MAX_CHARS ? maxChars : UI_MAX_CHARS;
+    length_ = 0;
+    text_[0] = '\0';
+}
+
+Rect TextRow::bounds() const {
+    return {x_, y_, (int16_t)(maxChars_ * 6 * size_), (int16_t)(8 * size_)};
+}
+
+void TextRow::draw(Renderer& renderer, const char* text) {
+    length_ = strnlen(text, maxChars_);
+    for (uint8_t i = 0; i < length_; i++) {
+        text_[i] = text[i];
+        if (text[i] != ' ') {
+            renderer.drawGlyph(x_ + i * 6 * size_, y_, size_, text[i]);
+        }
+    }
+    text_[length_] = '\0';
+}
+
+Rect TextRow::update(Renderer& renderer, const char* text) {
+    uint8_t length = strnlen(text, maxChars_);
+    uint8_t cells = length > length_ ? length : length_;
+    int first = -1;
+    int last = -1;
+    for (uint8_t i = 0; i < cells; i++) {
+        char previous = i < length_ ? text_[i] : ' ';
+        char next = i < length ? text[i] : ' ';
+        if (previous != next) {
+            renderer.drawGlyph(x_ + i * 6 * size_, y_, size_, next);
+            if (first < 0) first = i;
+            last = i;
+        }
+    }
+    memcpy(text_, text, length);
+    text_[length] = '\0';
+    length_ = length;
+    if (first < 0) {
+        return {x_, y_, 0, 0};
+    }
+    return {(int16_t)(x_ + first * 6 * size_), y_, (int16_t)((last - first + 1) * 6 * size_), (int16_t)(8 * size_)};
+}
+
+// ---- Widget ----
+
+Label::Label(int16_t x, int16_t y, uint8_t size, const char* text)
+    : Widget({x, y, (int16_t)(strlen(text) * 6 * size), (int16_t)(8 * size)}), text_(text) {
+    row_.place(x, y, size, strlen(text));
+}
+
+ValueField::ValueField(int16_t x, int16_t y, uint8_t size, uint8_t maxChars, TextSource source)
+    : Widget({x, y, (int16_t)(maxChars * 6 * size), (int16_t)(8 * size)}), source_(source) {
+    row_.place(x, y, size, maxChars);
+}
+
+bool ValueField::poll() {
+    source_(next_, sizeof(next_));
+    return !row_.equals(next_);
+}
+
+ProgressBar::ProgressBar(Rect bounds, ValueSource source, int32_t min, int32_t max)
+    : Widget(bounds), source_(source), min_(min), max_(max) {}
+
+bool ProgressBar::poll() {
+    int32_t value = source_();
+    value = value < min_ ? min_ : (value > max_ ? max_ : value);
+    next_ = (int16_t)((int64_t)(value - min_) * bounds_.w / (max_ - min_));
+    return next_ != length_;
+}
+
+void ProgressBar::draw(Renderer& renderer) {
+    renderer.gfx().fillRect(bounds_.x, bounds_.y, next_, bounds_.h, WHITE);
+    length_ = next_;
+}
+
+Rect ProgressBar::update(Renderer& renderer) {
+    Rect changed;
+    if (next_ > length_) {
+        changed = {(int16_t)(bounds_.x + length_), bounds_.y, (int16_t)(next_ - length_), bounds_.h};
+        renderer.gfx().fillRect(changed.x, changed.y, changed.w, changed.h, WHITE);
+    } else {
+        changed = {(int16_t)(bounds_.x + next_), bounds_.y, (int16_t)(length_ - next_), bounds_.h};
+        renderer.gfx().fillRect(changed.x, changed.y, changed.w, changed.h, BLACK);
+    }
+    length_ = next_;
+    return changed;
+}
+
+Menu::Menu(int16_t x, int16_t y, uint8_t rows, uint8_t rowHeight, uint8_t maxChars, int count,
+           ValueSource selection, ItemSource items)
+    : Widget({x, y, (int16_t)(maxChars * 6), (int16_t)(rows * rowHeight)}),
+      selection_(selection),
+      items_(items),
+      rows_(rows < UI_MENU_MAX_ROWS ? rows : UI_MENU_MAX_ROWS),
+      count_(count) {
+    for (uint8_t r = 0; r < rows_; r++) {
+        row_[r].place(x, y + r * rowHeight, 1, maxChars);
+    }
+}
+
+void Menu::format(int top, int selected) {
+    for (uint8_t r = 0; r < rows_; r++) {
+        int index = top + r;
+        if (index >= count_) {
+            next_[r][0] = '\0';
+            continue;
+        }
+        next_[r][0] = index == selected ? '>' : ' ';
+        next_[r][1] = ' ';
+        items_(index, next_[r] + 2, sizeof(next_[r]) - 2);
+    }
+}
+
+bool Menu::poll() {
+    int selected = selection_();
+    if (selected >= 0 && selected < count_) {
+        if (selected < top_) {
+            top_ = selected;
+        } else if (selected >= top_ + rows_) {
+            top_ = selected - rows_ + 1;
+        }
+    }
+    format(top_, selected);
+    bool changed = false;
+    for (uint8_t r = 0; r < rows_; r++) {
+        changed |= !row_[r].equals(next_[r]);
+    }
+    return changed;
+}
+
+void Menu::draw(Renderer& renderer) {
+    for (uint8_t r = 0; r < rows_; r++) {
+        row_[r].draw(renderer, next_[r]);
+    }
+}
+
+Rect Menu::update(Renderer& renderer) {
+    // Kursor pindah satu baris = dua sel; gulir = baris yang teksnya berbeda
+    int16_t top = bounds_.y + bounds_.h;
+    int16_t bottom = bounds_.y;
+    int16_t left = bounds_.x + bounds_.w;
+    int16_t right = bounds_.x;
+    for (uint8_t r = 0; r < rows_; r++) {
+        Rect cells = row_[r].update(renderer, next_[r]);
+        if (cells.w == 0) continue;
+        if (cells.y < top) top = cells.y;
+        if (cells.y + cells.h > bottom) bottom = cells.y + cells.h;
+        if (cells.x < left) left = cells.x;
+        if (cells.x + cells.w > right) right = cells.x + cells.w;
+    }
+    if (right < left) {
+        return {bounds_.x, bounds_.y, 0, 0};
+    }
+    return {left, top, (int16_t)(right - left), (int16_t)(bottom - top)};
+}
+
+Icon::Icon(Rect bounds, ValueSource state, Painter painter) : Widget(bounds), state_(state), painter_(painter) {}
+
+bool Icon::poll() {
+    next_ = state_();
+    return next_ != shown_;
+}
+
+void Icon::draw(Renderer& renderer) {
+    painter_(renderer.gfx(), bounds_, next_);
+    shown_ = next_;
+}
+
+// ---- View ----
+
+View::View(Widget* const* widgets, uint8_t count)
+    : widgets_(widgets), count_(count < UI_VIEW_MAX_WIDGETS ? count : UI_VIEW_MAX_WIDGETS) {}
+
+void View::layout() {
+    stacked_ = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        for (uint8_t j = i + 1; j < count_; j++) {
+            if (widgets_[i]->bounds().intersects(widgets_[j]->bounds())) {
+                stacked_ |= (1u << i) | (1u << j);
+            }
+        }
+    }
+    laidOut_ = true;
+}
+
+// ---- Renderer ----
+
+Renderer::Renderer(Adafruit_SSD1306& oled, Display& display) : oled_(oled), display_(display) {}
+
+void Renderer::begin() {
+    // Glyph digambar sekali dengan drawChar(), lalu kolom page-nya disalin
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+        oled_.fillRect(0, 0, GLYPH_WIDTH, GLYPH_PAGES * 8, BLACK);
+        oled_.drawChar(0, 0, UI_GLYPH_CACHE_CHARS[i], WHITE, BLACK, 2);
+        const uint8_t* buffer = oled_.getBuffer();
+        for (uint8_t page = 0; page < GLYPH_PAGES; page++) {
+            memcpy(glyphs_[i][page], buffer + page * Display::WIDTH, GLYPH_WIDTH);
+        }
+    }
+    oled_.fillRect(0, 0, GLYPH_WIDTH, GLYPH_PAGES * 8, BLACK);
+    cacheReady_ = true;
+}
+
+void Renderer::drawGlyph(int16_t x, int16_t y, uint8_t size, char c) {
+    if (x >= Display::WIDTH) {
+        return;
+    }
+    const char* cached = c != '\0' ? strchr(UI_GLYPH_CACHE_CHARS, c) : nullptr;
+    if (cacheReady_ && cached && size == 2 && y >= 0 && y % 8 == 0 && y + GLYPH_PAGES * 8 <= Display::PAGES * 8) {
+        const uint8_t (*glyph)[GLYPH_WIDTH] = glyphs_[cached - UI_GLYPH_CACHE_CHARS];
+        uint8_t columns = x + GLYPH_WIDTH <= Display::WIDTH ? GLYPH_WIDTH : Display::WIDTH - x;
+        uint8_t* buffer = oled_.getBuffer();
+        for (uint8_t page = 0; page < GLYPH_PAGES; page++) {
+            memcpy(buffer + (y / 8 + page) * Display::WIDTH + x, glyph[page], columns);
+        }
+        stats_.glyphsCached++;
+    } else {
+        oled_.drawChar(x, y, c, WHITE, BLACK, size);
+        stats_.glyphsDrawn++;
+    }
+}
+
+bool Renderer::render(View& view) {
+    PROFILE_SCOPE("ui.render");
+    if (!view.laidOut_) {
+        view.layout();
+    }
+    bool full = current_ != &view;
+    uint16_t changed = 0;
+    for (uint8_t i = 0; i < view.count_; i++) {
+        if (view.widgets_[i]->poll()) {
+            changed |= 1u << i;
+        }
+    }
+    if (!full && changed == 0) {
+        stats_.framesUnchanged++;
+        return false;
+    }
+    if (!display_.beginFrame()) {
+        return false;  // Nilai baru tetap terdeteksi pada render() berikutnya
+    }
+
+    if (full) {
+        oled_.clearDisplay();
+        for (uint8_t i = 0; i < view.count_; i++) {
+            view.widgets_[i]->draw(*this);
+        }
+        display_.flush();
+        current_ = &view;
+        stats_.framesFull++;
+        return true;
+    }
+
+    // Widget yang berdiri sendiri cukup menggambar selisihnya
+    for (uint8_t i = 0; i < view.count_; i++) {
+        if ((changed & ~view.stacked_) & (1u << i)) {
+            Rect area = view.widgets_[i]->update(*this);
+            display_.markDirty(area.x, area.y, area.w, area.h);
+            stats_.widgetsUpdated++;
+        }
+    }
+
+    // Widget bertumpuk: bersihkan areanya, lalu gambar ulang semua yang beririsan sesuai urutan
+    uint16_t stackedChanged = changed & view.stacked_;
+    if (stackedChanged != 0) {
+        for (uint8_t i = 0; i < view.count_; i++) {
+            if (stackedChanged & (1u << i)) {
+                const Rect& area = view.widgets_[i]->bounds();
+                oled_.fillRect(area.x, area.y, area.w, area.h, BLACK);
+                display_.markDirty(area.x, area.y, area.w, area.h);
+            }
+        }
+        for (uint8_t j = 0; j < view.count_; j++) {
+            if (!(view.stacked_ & (1u << j))) continue;
+            bool hit = false;
+            for (uint8_t i = 0; i < view.count_ && !hit; i++) {
+                hit = (stackedChanged & (1u << i)) && view.widgets_[j]->bounds().intersects(view.widgets_[i]->bounds());
+            }
+            if (hit) {
+                view.widgets_[j]->draw(*this);
+                stats_.widgetsStacked++;
+            }
+        }
+    }
+    display_.flushDirty();
+    stats_.framesPartial++;
+    return true;
+}
+
+void Renderer::report(Print& out) const {
+    fixedPrintf(out, "ui: %lu full, %lu partial, %lu unchanged frames, %lu widgets updated, %lu restacked, "
+                "glyphs %lu cached %lu drawn\n",
+                (unsigned long)stats_.framesFull, (unsigned long)stats_.framesPartial,
+                (unsigned long)stats_.framesUnchanged, (unsigned long)stats_.widgetsUpdated,
+                (unsigned long)stats_.widgetsStacked, (unsigned long)stats_.glyphsCached,
+                (unsigned long)stats_.glyphsDrawn);
+}
+
+void Renderer::resetStats() {
+    stats_ = {};
+}
+
+}  // namespace ui
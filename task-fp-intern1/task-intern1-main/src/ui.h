@@ -0,0 +1,222 @@
+#pragma once
+
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+
+#include "display.h"
+
+// Kerangka widget retained untuk layar OLED.
+// Setiap layar dideklarasikan sebagai View berisi widget (label, field nilai,
+// progress bar, menu, ikon) yang terikat ke sumber data lewat function
+// pointer. Setiap render, Renderer membaca ulang semua sumber; hanya widget
+// yang nilainya berubah yang digambar dan ditandai kotor di Display. Teks
+// diperbarui per sel glyph dan bar per selisih panjang. Widget yang bertumpuk
+// dengan widget lain digambar ulang bersama tumpukannya: area yang berubah
+// dibersihkan lalu widget yang beririsan digambar sesuai urutan di View.
+// Tanpa perubahan tidak ada frame sama sekali.
+
+#define UI_MAX_CHARS 21        // Satu baris penuh ukuran 1
+#define UI_MENU_MAX_ROWS 6
+#define UI_VIEW_MAX_WIDGETS 16
+#define UI_GLYPH_CACHE_CHARS "0123456789: "
+
+namespace ui {
+
+struct Rect {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+
+    bool intersects(const Rect& other) const {
+        return x < other.x + other.w && other.x < x + w && y < other.y + other.h && other.y < y + h;
+    }
+};
+
+// Sumber data widget
+typedef void (*TextSource)(char* out, size_t size);
+typedef int32_t (*ValueSource)();
+typedef void (*ItemSource)(int index, char* out, size_t size);
+// Gambar ikon untuk state tertentu; tidak boleh menggambar di luar bounds
+typedef void (*Painter)(Adafruit_SSD1306& gfx, const Rect& bounds, int32_t state);
+
+class Renderer;
+
+class Widget {
+public:
+    explicit Widget(Rect bounds) : bounds_(bounds) {}
+    const Rect& bounds() const { return bounds_; }
+
+    // Baca sumber data; true jika berbeda dari yang terakhir digambar
+    virtual bool poll() = 0;
+    // Gambar penuh nilai dari poll() terakhir di atas area yang sudah bersih
+    virtual void draw(Renderer& renderer) = 0;
+    // Gambar hanya perubahannya, return area yang disentuh.
+    // Default: bersihkan seluruh area widget lalu draw()
+    virtual Rect update(Renderer& renderer);
+
+protected:
+    Rect bounds_;
+};
+
+// Satu baris teks yang mengingat karakter per sel yang terakhir digambar
+class TextRow {
+public:
+    void place(int16_t x, int16_t y, uint8_t size, uint8_t maxChars);
+    Rect bounds() const;
+    bool equals(const char* text) const { return strncmp(text_, text, maxChars_) == 0; }
+    // Framebuffer sudah bersih: gambar semua karakter
+    void draw(Renderer& renderer, const char* text);
+    // Gambar hanya sel yang karakternya berubah; sel di luar teks dianggap spasi
+    Rect update(Renderer& renderer, const char* text);
+
+private:
+    int16_t x_ = 0;
+    int16_t y_ = 0;
+    uint8_t size_ = 1;
+    uint8_t maxChars_ = 0;
+    uint8_t length_ = 0;
+    char text_[UI_MAX_CHARS + 1] = {};
+};
+
+// Teks tetap
+class Label : public Widget {
+public:
+    Label(int16_t x, int16_t y, uint8_t size, const char* text);
+    bool poll() override { return false; }
+    void draw(Renderer& renderer) override { row_.draw(renderer, text_); }
+
+private:
+    const char* text_;
+    TextRow row_;
+};
+
+// Teks dari sumber data, misalnya nilai sensor atau jam
+class ValueField : public Widget {
+public:
+    ValueField(int16_t x, int16_t y, uint8_t size, uint8_t maxChars, TextSource source);
+    bool poll() override;
+    void draw(Renderer& renderer) override { row_.draw(renderer, next_); }
+    Rect update(Renderer& renderer) override { return row_.update(renderer, next_); }
+
+private:
+    TextSource source_;
+    char next_[UI_MAX_CHARS + 1] = {};
+    TextRow row_;
+};
+
+// Bar horizontal sepanjang (value - min) / (max - min) dari lebar bounds
+class ProgressBar : public Widget {
+public:
+    ProgressBar(Rect bounds, ValueSource source, int32_t min, int32_t max);
+    bool poll() override;
+    void draw(Renderer& renderer) override;
+    // Hanya selisih panjang bar yang diisi atau dihapus
+    Rect update(Renderer& renderer) override;
+
+private:
+    ValueSource source_;
+    int32_t min_;
+    int32_t max_;
+    int16_t length_ = 0;
+    int16_t next_ = 0;
+};
+
+// Daftar bergulir dengan kursor "> "; baris digambar ulang per sel seperti TextRow
+class Menu : public Widget {
+public:
+    // selection di luar 0..count-1 berarti tanpa kursor
+    Menu(int16_t x, int16_t y, uint8_t rows, uint8_t rowHeight, uint8_t maxChars, int count,
+         ValueSource selection, ItemSource items);
+    bool poll() override;
+    void draw(Renderer& renderer) override;
+    Rect update(Renderer& renderer) override;
+
+private:
+    void format(int top, int selected);
+
+    ValueSource selection_;
+    ItemSource items_;
+    uint8_t rows_;
+    int count_;
+    int top_ = 0;  // Item di baris pertama, bergeser seminimal mungkin mengikuti kursor
+    char next_[UI_MENU_MAX_ROWS][UI_MAX_CHARS + 1] = {};
+    TextRow row_[UI_MENU_MAX_ROWS];
+};
+
+// Gambar bebas (ikon, animasi, grafik) yang digambar ulang saat state berubah
+class Icon : public Widget {
+public:
+    Icon(Rect bounds, ValueSource state, Painter painter);
+    bool poll() override;
+    void draw(Renderer& renderer) override;
+
+private:
+    ValueSource state_;
+    Painter painter_;
+    int32_t shown_ = 0;
+    int32_t next_ = 0;
+};
+
+// Satu layar: widget digambar sesuai urutan array (yang belakang di atas)
+class View {
+public:
+    View(Widget* const* widgets, uint8_t count);
+    template <size_t N>
+    explicit View(Widget* const (&widgets)[N]) : View(widgets, N) {}
+
+private:
+    friend class Renderer;
+    void layout();
+
+    Widget* const* widgets_;
+    uint8_t count_;
+    bool laidOut_ = false;
+    uint16_t stacked_ = 0;  // Bit i: widget i beririsan dengan widget lain
+};
+
+struct RendererStats {
+    uint32_t framesFull;      // Layar baru atau di-invalidate
+    uint32_t framesPartial;
+    uint32_t framesUnchanged; // render() tanpa widget yang berubah, tanpa frame
+    uint32_t widgetsUpdated;  // Digambar lewat update() (selisih saja)
+    uint32_t widgetsStacked;  // Digambar ulang penuh karena tumpukan berubah
+    uint32_t glyphsCached;    // Disalin dari cache glyph
+    uint32_t glyphsDrawn;     // Digambar lewat drawChar()
+};
+
+class Renderer {
+public:
+    Renderer(Adafruit_SSD1306& oled, Display& display);
+
+    // Render cache glyph lewat framebuffer; panggil sebelum frame pertama
+    void begin();
+    // Gambar view dan serahkan area yang berubah ke Display. Return false jika
+    // tidak ada yang berubah atau frame ditahan frame pacing (dicoba lagi nanti)
+    bool render(View& view);
+    // Framebuffer ditimpa gambar di luar widget; render() berikutnya menggambar penuh
+    void invalidate() { current_ = nullptr; }
+
+    Adafruit_SSD1306& gfx() { return oled_; }
+    // Glyph opak (latar hitam ikut digambar); digit ukuran 2 yang sejajar page
+    // disalin langsung dari cache
+    void drawGlyph(int16_t x, int16_t y, uint8_t size, char c);
+
+    const RendererStats& stats() const { return stats_; }
+    void report(Print& out) const;
+    void resetStats();
+
+private:
+    static const uint8_t GLYPH_WIDTH = 12;  // 6 x 2
+    static const uint8_t GLYPH_PAGES = 2;   // 8 x 2 baris
+    static const uint8_t GLYPH_COUNT = sizeof(UI_GLYPH_CACHE_CHARS) - 1;
+
+    Adafruit_SSD1306& oled_;
+    Display& display_;
+    View* current_ = nullptr;
+    bool cacheReady_ = false;
+    uint8_t glyphs_[GLYPH_COUNT][GLYPH_PAGES][GLYPH_WIDTH];
+    RendererStats stats_ = {};
+};
+
+}  // namespace ui
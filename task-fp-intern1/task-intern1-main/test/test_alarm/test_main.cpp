@@ -0,0 +1,86 @@
+// Alarm dari NVS saat boot: alarm sekali yang waktunya lewat selama mati.
+// Jalankan: pio test -e native -f test_alarm
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <unity.h>
+
+#include "alarm_service.h"
+#include "fake_hw.h"
+
+static const uint32_t BOOT_TIME = 1767258000;  // 2026-01-01 09:00:00
+
+// Isi NVS seperti yang ditulis AlarmService::save() sebelum reset
+static void storeAlarms(const AlarmSpec* alarms) {
+    Preferences prefs;
+    prefs.begin("alarms", false);
+    prefs.putBytes("list", alarms, sizeof(AlarmSpec) * ALARM_MAX);
+    prefs.putUChar("ver", 1);
+}
+
+static AlarmSpec storedAlarm(int slot) {
+    AlarmSpec alarms[ALARM_MAX] = {};
+    Preferences prefs;
+    prefs.begin("alarms", true);
+    prefs.getBytes("list", alarms, sizeof(alarms));
+    return alarms[slot];
+}
+
+void setUp() { fakeHw::clearNvs(); }
+void tearDown() {}
+
+// Alarm sekali yang lewat saat mati dimatikan, dihitung terlewat dan disimpan sekali
+static void test_past_once_alarm_expires_on_boot() {
+    AlarmSpec alarms[ALARM_MAX] = {};
+    alarms[0] = {7, 30, ALARM_DAYS_ONCE, 1, BOOT_TIME - 90 * 60};
+    alarms[1] = {6, 0, ALARM_DAYS_ONCE, 1, BOOT_TIME - 86400};
+    alarms[2] = {10, 0, ALARM_DAYS_DAILY, 1, 0};
+    storeAlarms(alarms);
+
+    AlarmService service;
+    service.begin(BOOT_TIME);
+    TEST_ASSERT_EQUAL_UINT8(0, service.get(0).enabled);
+    TEST_ASSERT_EQUAL_UINT8(0, service.get(1).enabled);
+    TEST_ASSERT_EQUAL_UINT8(1, service.get(2).enabled);
+    TEST_ASSERT_EQUAL_UINT32(2, service.stats().missed);
+    TEST_ASSERT_EQUAL_UINT32(1, service.stats().saves);
+    TEST_ASSERT_EQUAL_UINT8(0, storedAlarm(0).enabled);
+    TEST_ASSERT_EQUAL_UINT8(0, storedAlarm(1).enabled);
+    TEST_ASSERT_EQUAL_UINT32(BOOT_TIME + 3600, service.nextFireTime());
+
+    // Tidak berbunyi belakangan dan boot berikutnya tidak menulis NVS lagi
+    service.tick(BOOT_TIME + 60);
+    TEST_ASSERT_FALSE(service.isRinging());
+    AlarmService rebooted;
+    rebooted.begin(BOOT_TIME + 120);
+    TEST_ASSERT_EQUAL_UINT32(0, rebooted.stats().missed);
+    TEST_ASSERT_EQUAL_UINT32(0, rebooted.stats().saves);
+}
+
+// Alarm sekali yang belum lewat tetap terjadwal tanpa menulis NVS
+static void test_future_once_alarm_survives_boot() {
+    AlarmSpec alarms[ALARM_MAX] = {};
+    alarms[3] = {9, 5, ALARM_DAYS_ONCE, 1, BOOT_TIME + 300};
+    storeAlarms(alarms);
+
+    AlarmService service;
+    service.begin(BOOT_TIME);
+    TEST_ASSERT_EQUAL_UINT8(1, service.get(3).enabled);
+    TEST_ASSERT_EQUAL_UINT32(0, service.stats().missed);
+    TEST_ASSERT_EQUAL_UINT32(0, service.stats().saves);
+    TEST_ASSERT_EQUAL_UINT32(BOOT_TIME + 300, service.nextFireTime());
+
+    service.tick(BOOT_TIME + 300);
+    TEST_ASSERT_TRUE(service.isRinging());
+    TEST_ASSERT_EQUAL_UINT8(0, storedAlarm(3).enabled);
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::serialEcho(false);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_past_once_alarm_expires_on_boot);
+    RUN_TEST(test_future_once_alarm_survives_boot);
+    return UNITY_END();
+}
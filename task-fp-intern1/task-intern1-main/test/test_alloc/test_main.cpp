@@ -0,0 +1,129 @@
+// Heap setelah setup(): loop dijalankan lama di semua mode dan harus nol alokasi.
+// Jalankan: pio test -e native -f test_alloc
+//
+// Butuh hook alokasi dari platformio.ini (-DALLOC_GUARD_WRAP=1 dan
+// -Wl,--wrap=malloc,...); tanpa itu hanya operator new yang terhitung.
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <unity.h>
+
+#include "alloc_guard.h"
+#include "fake_hw.h"
+#include "scheduler.h"
+
+void setup();
+void loop();
+extern int mode;
+extern int selectedMode;
+extern unsigned long lastInputTime;
+
+static const uint8_t PIN_GREEN = 19;
+static const uint8_t PIN_BLUE = 5;
+static const uint8_t PIN_LDR = 13;
+
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(20);
+    }
+}
+
+static void press(uint8_t pin, uint32_t holdMs) {
+    fakeHw::setPin(pin, LOW);
+    runFor(holdMs);
+    fakeHw::setPin(pin, HIGH);
+    runFor(100);
+}
+
+static void assertNoAllocations(const char* where) {
+    AllocStats stats = allocGuard.stats();
+    if (stats.allocations != 0) {
+        printf("%s: %lu allocations (%lu B), last %lu B from 0x%lx\n", where, (unsigned long)stats.allocations,
+               (unsigned long)stats.bytes, (unsigned long)stats.lastSize, (unsigned long)stats.lastCaller);
+    }
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats.allocations, where);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Semua task periodik (statistik, riwayat, tren, telemetri) ikut berjalan
+static void test_idle_loop_is_heap_free() {
+    TEST_ASSERT_EQUAL(ALLOC_GUARD_REPORT, allocGuard.mode());
+    allocGuard.resetStats();
+    runFor(65000);
+    assertNoAllocations("idle");
+}
+
+// Setiap layar dimasuki lewat menu seperti pengguna, termasuk animasi transisi
+static void test_every_mode_is_heap_free() {
+    allocGuard.resetStats();
+    for (int target = 1; target < 5; target++) {
+        while (selectedMode != target) {
+            press(PIN_BLUE, 80);
+        }
+        press(PIN_GREEN, 80);
+        runFor(3000);
+        press(PIN_GREEN, 2300);  // Tekan lama: kembali ke mode 0
+        TEST_ASSERT_EQUAL_INT(0, mode);
+    }
+    fakeHw::setAnalog(PIN_LDR, 300);  // Layar LDR siang dan malam
+    mode = 2;
+    lastInputTime = millis();
+    runFor(3000);
+    fakeHw::setAnalog(PIN_LDR, 3900);
+    runFor(3000);
+    assertNoAllocations("modes");
+}
+
+static void test_guard_counts_allocations() {
+    allocGuard.resetStats();
+    void* volatile block = malloc(24);
+    free(block);
+    int* volatile value = new int(7);
+    delete value;
+    AllocStats stats = allocGuard.stats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.allocations);
+    TEST_ASSERT_EQUAL_UINT32(24 + sizeof(int), stats.bytes);
+    TEST_ASSERT_TRUE(stats.lastCaller != 0);
+
+    // Print::printf di Arduino-ESP32 memakai malloc untuk teks di atas 64 byte
+    Serial.printf("%080d\n", 1);
+    TEST_ASSERT_EQUAL_UINT32(3, allocGuard.stats().allocations);
+
+    {
+        AllocGuard::Allow allow;
+        void* volatile allowed = malloc(8);
+        free(allowed);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, allocGuard.stats().allocations);
+    TEST_ASSERT_EQUAL_UINT32(1, allocGuard.stats().allowed);
+    allocGuard.resetStats();
+}
+
+static void test_heap_stats() {
+    HeapStats heap = AllocGuard::heap();
+    TEST_ASSERT_TRUE(heap.freeHeap > 0);
+    TEST_ASSERT_TRUE(heap.largestFreeBlock <= heap.freeHeap);
+    TEST_ASSERT_TRUE(heap.minFreeHeap <= heap.freeHeap);
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::clearNvs();
+    fakeHw::clearFlash();
+    fakeHw::serialEcho(false);
+    fakeHw::setRtc(DateTime(2024, 1, 1, 12, 0, 0).unixtime());
+    fakeHw::setDht(24.5f, 55.0f);
+    fakeHw::setAnalog(PIN_LDR, 1500);
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_loop_is_heap_free);
+    RUN_TEST(test_every_mode_is_heap_free);
+    RUN_TEST(test_guard_counts_allocations);
+    RUN_TEST(test_heap_stats);
+    return UNITY_END();
+}
@@ -0,0 +1,200 @@
+// Benchmark firmware di atas hardware palsu (env native).
+// Jalankan: pio test -e native -f test_bench -v
+//
+// Semua angka kecuali "render host" diukur dengan jam virtual, jadi bisa
+// diulang persis di CI. Biaya I/O (I2C, DHT, ADC) dimodelkan oleh native_hw;
+// satu iterasi loop() tanpa I/O dihitung BENCH_LOOP_COST_US.
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <unity.h>
+
+#include <chrono>
+
+#include "buttons.h"
+#include "display.h"
+#include "fake_hw.h"
+#include "scheduler.h"
+
+void setup();
+void loop();
+void renderTask();
+extern int mode;
+extern int selectedMode;
+extern int renderedMode;
+extern int statsTaskId;
+extern Display screen;
+
+// Pin sesuai diagram.json
+static const uint8_t PIN_GREEN = 19;
+static const uint8_t PIN_RED = 18;
+static const uint8_t PIN_BLUE = 5;
+static const uint8_t PIN_LDR = 13;
+
+#define BENCH_LOOP_COST_US 20
+#define BENCH_WINDOW_MS 5000
+#define BENCH_RENDER_FRAMES 200
+
+// Batas regresi; gagal jika terlampaui. Frame yang dipicu input bisa ditolak
+// frame pacing dan menunggu periode render berikutnya.
+#define BENCH_MAX_LATENCY_MS 150
+#define BENCH_MAX_BYTES_PER_FRAME 1100
+#define BENCH_MIN_LOOPS_PER_S 5000
+
+struct ModeBench {
+    const char* name;
+    int mode;
+    uint8_t inputPin;     // Tombol yang mengubah isi layar di mode ini
+    uint32_t holdMs;
+    bool onRelease;       // Event tombol hijau singkat muncul saat dilepas
+};
+
+static const ModeBench MODES[] = {
+    {"Time", 0, PIN_BLUE, 80, false},   // Kursor menu pindah
+    {"DHT", 1, PIN_GREEN, 80, true},    // Masuk ulang, animasi transisi
+    {"LDR", 2, PIN_GREEN, 80, true},
+    {"Alarm", 3, PIN_BLUE, 80, false},  // Kursor submenu pindah
+};
+
+static uint32_t loopIterations = 0;
+
+static void step() {
+    loop();
+    loopIterations++;
+    fakeHw::advanceUs(BENCH_LOOP_COST_US);
+}
+
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        step();
+    }
+}
+
+static void press(uint8_t pin, uint32_t holdMs) {
+    fakeHw::setPin(pin, LOW);
+    runFor(holdMs);
+    fakeHw::setPin(pin, HIGH);
+    runFor(100);
+}
+
+// Dari mode 0: pilih mode lewat menu seperti pengguna
+static void enterMode(int target) {
+    if (mode != 0) {
+        press(PIN_GREEN, 2300);  // Tekan lama: kembali ke mode 0
+    }
+    while (selectedMode != target) {
+        press(PIN_BLUE, 80);
+    }
+    if (target != 0) {
+        press(PIN_GREEN, 80);
+    }
+    runFor(1000);  // Lewati animasi transisi
+}
+
+// Waktu dari tepi tombol sampai frame pertama yang digambar setelah event
+// tombol diproses selesai dikirim ke panel. Layar beranimasi selalu berubah,
+// jadi yang dilacak adalah urutan event -> frame, bukan isi panel.
+static uint32_t measureLatencyUs(const ModeBench& bench) {
+    fakeHw::setPin(bench.inputPin, LOW);
+    uint64_t edgeUs = fakeHw::nowUs();
+    if (bench.onRelease) {
+        runFor(bench.holdMs);
+        fakeHw::setPin(bench.inputPin, HIGH);
+        edgeUs = fakeHw::nowUs();
+    }
+
+    uint32_t events = buttons.stats().events;
+    bool handled = false;
+    uint64_t limit = edgeUs + 1000000ULL;
+    while (fakeHw::nowUs() < limit) {
+        uint32_t frames = screen.stats().frames;
+        step();
+        if (!handled) {
+            handled = buttons.stats().events != events;
+        }
+        if (handled && screen.stats().frames != frames) {
+            break;
+        }
+    }
+    uint32_t latency = (uint32_t)(fakeHw::nowUs() - edgeUs);
+
+    if (!bench.onRelease) {
+        runFor(bench.holdMs);
+        fakeHw::setPin(bench.inputPin, HIGH);
+    }
+    runFor(500);
+    return latency;
+}
+
+// Waktu CPU host untuk render + diff satu frame penuh (tidak termasuk waktu bus)
+static uint32_t measureRenderHostNs() {
+    uint32_t framesBefore = screen.stats().frames;
+    uint64_t totalNs = 0;
+    for (int i = 0; i < BENCH_RENDER_FRAMES; i++) {
+        fakeHw::advanceUs(DISPLAY_MIN_FRAME_MS * 1000UL);
+        renderedMode = -1;  // Paksa gambar ulang meski isi layar tidak berubah
+        auto start = std::chrono::steady_clock::now();
+        renderTask();
+        totalNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    uint32_t frames = screen.stats().frames - framesBefore;
+    return frames ? (uint32_t)(totalNs / frames) : 0;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void benchMode(const ModeBench& bench) {
+    enterMode(bench.mode);
+    TEST_ASSERT_EQUAL_INT(bench.mode, mode);
+
+    screen.resetStats();
+    fakeHw::resetI2CStats();
+    loopIterations = 0;
+    uint64_t windowStart = fakeHw::nowUs();
+    runFor(BENCH_WINDOW_MS);
+    double seconds = (fakeHw::nowUs() - windowStart) / 1e6;
+
+    DisplayStats display = screen.stats();
+    fakeHw::I2CStats bus = fakeHw::i2cStats();
+    uint32_t loopsPerSecond = (uint32_t)(loopIterations / seconds);
+    uint32_t bytesPerFrame = display.frames ? display.bytesTotal / display.frames : 0;
+    uint32_t busUsPerFrame = display.frames ? (uint32_t)(bus.busyUs / display.frames) : 0;
+
+    uint32_t latencyUs = measureLatencyUs(bench);
+    uint32_t renderNs = measureRenderHostNs();
+
+    printf("%-6s frames %3lu (%4.1f fps), %4lu B/frame, bus %5lu us/frame, loop %6lu/s, "
+           "latency %5.1f ms, render host %6.1f us\n",
+           bench.name, (unsigned long)display.frames, display.frames / seconds, (unsigned long)bytesPerFrame,
+           (unsigned long)busUsPerFrame, (unsigned long)loopsPerSecond, latencyUs / 1000.0, renderNs / 1000.0);
+
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(BENCH_MAX_LATENCY_MS * 1000UL, latencyUs, "input-to-screen latency");
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(BENCH_MAX_BYTES_PER_FRAME, bytesPerFrame, "bytes per frame");
+    TEST_ASSERT_TRUE_MESSAGE(loopsPerSecond >= BENCH_MIN_LOOPS_PER_S, "loop iterations per second");
+}
+
+static void test_mode_time() { benchMode(MODES[0]); }
+static void test_mode_dht() { benchMode(MODES[1]); }
+static void test_mode_ldr() { benchMode(MODES[2]); }
+static void test_mode_alarm() { benchMode(MODES[3]); }
+
+int main() {
+    fakeHw::reset();
+    fakeHw::clearNvs();
+    fakeHw::serialEcho(false);
+    fakeHw::setRtc(DateTime(2024, 1, 1, 12, 0, 0).unixtime());
+    fakeHw::setDht(24.5f, 55.0f);
+    fakeHw::setAnalog(PIN_LDR, 1500);
+    setup();
+    scheduler.setEnabled(statsTaskId, false);  // Statistik diukur sendiri, jangan di-reset tiap 10 detik
+    runFor(3000);  // Sensor dan jam sudah stabil
+
+    UNITY_BEGIN();
+    RUN_TEST(test_mode_time);
+    RUN_TEST(test_mode_dht);
+    RUN_TEST(test_mode_ldr);
+    RUN_TEST(test_mode_alarm);
+    return UNITY_END();
+}
@@ -0,0 +1,196 @@
+// Boot cepat: frame pertama sebelum inisialisasi tertunda, state UI dan timer
+// dipulihkan dari RTC slow memory/NVS dengan CRC.
+// Jalankan: pio test -e native -f test_boot
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_system.h>
+#include <unity.h>
+
+#include "boot_manager.h"
+#include "control_loop.h"
+#include "fake_hw.h"
+#include "history_log.h"
+#include "scheduler.h"
+#include "timer_service.h"
+#include "trend_service.h"
+
+void setup();
+void loop();
+bool restoreUiState(bool clockValid);
+extern int mode;
+extern int selectedMode;
+extern bool isInAlarmMode;
+extern int countdownId;
+extern int stopwatchId;
+extern bool timerDoneShowing;
+extern TrendWindow trendWindow;
+extern Display screen;
+extern int statsTaskId;
+
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(20);
+    }
+}
+
+// Seperti global setelah reset: nilai awal dan tidak ada timer
+static void forgetUi() {
+    mode = 0;
+    selectedMode = 0;
+    isInAlarmMode = false;
+    trendWindow = TREND_1HOUR;
+    countdownId = -1;
+    stopwatchId = -1;
+    for (int id = 0; id < TIMER_MAX; id++) {
+        timerService.cancel(id);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Frame pertama hanya menunggu panel dan RTC; servo, sensor dan riwayat menyusul
+static void test_first_frame_before_deferred_init() {
+    const BootStats& stats = bootManager.stats();
+    TEST_ASSERT_EQUAL(BOOT_COLD, bootManager.kind());
+    TEST_ASSERT_EQUAL(BOOT_SOURCE_NONE, bootManager.source());
+    TEST_ASSERT_TRUE(stats.setupUs < 5000);
+    TEST_ASSERT_TRUE(stats.firstFrameUs > stats.setupUs);
+    TEST_ASSERT_TRUE(stats.firstFrameUs < 35000);  // Satu frame penuh 1 KB di 400 kHz, tanpa splash
+    TEST_ASSERT_TRUE(stats.readyUs >= stats.firstFrameUs);
+    TEST_ASSERT_TRUE(bootManager.ready());
+    TEST_ASSERT_TRUE(historyLog.mounted());
+    TEST_ASSERT_TRUE(controlLoop.snapshot().tickMs > 0);
+}
+
+// Countdown dan stopwatch disimpan dalam waktu jam; offset lain = perangkat mati selama itu
+static void test_timer_snapshot_follows_clock() {
+    static TimerService timers;
+    timers.begin();
+    int countdown = timers.startCountdown(60000000ULL);
+    int stopwatch = timers.startStopwatch();
+    TimerSnapshot saved[TIMER_MAX];
+    timers.snapshot(saved, 0);
+
+    timers.restore(saved, 10000000);  // 10 detik kemudian menurut jam
+    TEST_ASSERT_TRUE(timers.isRunning(countdown));
+    TEST_ASSERT_UINT32_WITHIN(1000, 50000, (uint32_t)(timers.remainingUs(countdown) / 1000));
+    TEST_ASSERT_UINT32_WITHIN(1000, 10000, (uint32_t)(timers.elapsedUs(stopwatch) / 1000));
+
+    timers.restore(saved, 61000000);  // Tenggat lewat selama mati: selesai di tick()
+    TEST_ASSERT_TRUE(timers.remainingUs(countdown) == 0);
+    timers.tick();
+    TEST_ASSERT_FALSE(timers.isActive(countdown));
+    TEST_ASSERT_TRUE(timers.isRunning(stopwatch));
+}
+
+// Reset software: salinan RTC dipakai, timer berjalan selama perangkat mati
+static void test_ui_and_timers_survive_reset() {
+    uint32_t writes = bootManager.stats().rtcWrites;
+    mode = 4;
+    selectedMode = 4;
+    trendWindow = TREND_24HOUR;
+    countdownId = timerService.startCountdown(60000000ULL);
+    stopwatchId = timerService.startStopwatch();
+    runFor(100);
+    TEST_ASSERT_EQUAL_UINT32(writes + 1, bootManager.stats().rtcWrites);
+    runFor(1000);  // Stopwatch berjalan tanpa mengubah salinan
+    TEST_ASSERT_EQUAL_UINT32(writes + 1, bootManager.stats().rtcWrites);
+    uint64_t remaining = timerService.remainingUs(countdownId);
+
+    forgetUi();
+    fakeHw::advanceUs(5000000);
+    fakeHw::setResetReason(ESP_RST_SW);
+    bootManager.begin(screen);
+    TEST_ASSERT_EQUAL(BOOT_RESET, bootManager.kind());
+    TEST_ASSERT_EQUAL(BOOT_SOURCE_RTC, bootManager.source());
+    TEST_ASSERT_TRUE(restoreUiState(true));
+
+    TEST_ASSERT_EQUAL_INT(4, mode);
+    TEST_ASSERT_EQUAL_INT(4, selectedMode);
+    TEST_ASSERT_EQUAL(TREND_24HOUR, trendWindow);
+    TEST_ASSERT_TRUE(timerService.isRunning(countdownId));
+    TEST_ASSERT_TRUE(timerService.isRunning(stopwatchId));
+    TEST_ASSERT_UINT32_WITHIN(10, (uint32_t)((remaining - 5000000) / 1000),
+                              (uint32_t)(timerService.remainingUs(countdownId) / 1000));
+    TEST_ASSERT_UINT32_WITHIN(150, 6100, (uint32_t)(timerService.elapsedUs(stopwatchId) / 1000));
+}
+
+// Power-on: RTC slow memory diabaikan, salinan NVS ditulis setelah state diam
+static void test_power_on_restores_from_nvs() {
+    uint32_t nvsWrites = bootManager.stats().nvsWrites;
+    selectedMode = 2;
+    runFor(1000);
+    TEST_ASSERT_EQUAL_UINT32(nvsWrites, bootManager.stats().nvsWrites);
+    runFor(BOOT_NVS_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT32(nvsWrites + 1, bootManager.stats().nvsWrites);
+    runFor(BOOT_NVS_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT32(nvsWrites + 1, bootManager.stats().nvsWrites);  // Tidak ada perubahan lagi
+
+    forgetUi();
+    fakeHw::setResetReason(ESP_RST_POWERON);
+    bootManager.begin(screen);
+    TEST_ASSERT_EQUAL(BOOT_COLD, bootManager.kind());
+    TEST_ASSERT_EQUAL(BOOT_SOURCE_NVS, bootManager.source());
+    TEST_ASSERT_TRUE(restoreUiState(true));
+    TEST_ASSERT_EQUAL_INT(2, selectedMode);
+    TEST_ASSERT_TRUE(timerService.isRunning(countdownId));
+}
+
+// Salinan rusak (mis. listrik padam saat menulis) ditolak, UI mulai dari default
+static void test_corrupted_copy_is_rejected() {
+    Preferences prefs;
+    prefs.begin("boot");
+    uint8_t blob[sizeof(BootRecord)];
+    size_t length = prefs.getBytes("state", blob, sizeof(blob));
+    TEST_ASSERT_TRUE(length > 0);
+    blob[length - 1] ^= 0x40;
+    prefs.putBytes("state", blob, length);
+
+    uint32_t rejected = bootManager.stats().rejected;
+    forgetUi();
+    fakeHw::setResetReason(ESP_RST_POWERON);
+    bootManager.begin(screen);
+    TEST_ASSERT_EQUAL(BOOT_SOURCE_NONE, bootManager.source());
+    TEST_ASSERT_EQUAL_UINT32(rejected + 1, bootManager.stats().rejected);
+    TEST_ASSERT_FALSE(restoreUiState(true));
+    TEST_ASSERT_EQUAL_INT(0, selectedMode);
+}
+
+// Bangun dari deep sleep setelah tenggat: layar countdown selesai langsung muncul
+static void test_countdown_expires_while_off() {
+    countdownId = timerService.startCountdown(3000000ULL);
+    runFor(100);
+    forgetUi();
+    fakeHw::advanceUs(10000000);
+    fakeHw::setResetReason(ESP_RST_DEEPSLEEP);
+    bootManager.begin(screen);
+    TEST_ASSERT_EQUAL(BOOT_WAKE, bootManager.kind());
+    TEST_ASSERT_TRUE(restoreUiState(true));
+    runFor(100);
+    TEST_ASSERT_TRUE(timerDoneShowing);
+    TEST_ASSERT_EQUAL_INT(0, timerService.count(TIMER_COUNTDOWN));
+    timerDoneShowing = false;
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::clearNvs();
+    fakeHw::serialEcho(false);
+    fakeHw::setDht(24.5f, 55.0f);
+    setup();
+    scheduler.setEnabled(statsTaskId, false);  // Laporan berkala ikut me-reset statistik
+    runFor(2000);  // Fase detik RTC terkunci; koreksi jam ikut mengubah salinan timer
+
+    UNITY_BEGIN();
+    RUN_TEST(test_first_frame_before_deferred_init);
+    RUN_TEST(test_timer_snapshot_follows_clock);
+    RUN_TEST(test_ui_and_timers_survive_reset);
+    RUN_TEST(test_power_on_restores_from_nvs);
+    RUN_TEST(test_corrupted_copy_is_rejected);
+    RUN_TEST(test_countdown_expires_while_off);
+    return UNITY_END();
+}
@@ -0,0 +1,264 @@
+// Loop kontrol terpisah dari UI: perintah lewat ring SPSC, snapshot lewat seqlock, jitter.
+// Jalankan: pio test -e native -f test_control
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <thread>
+
+#include "control_loop.h"
+#include "fake_hw.h"
+#include "jitter.h"
+#include "scheduler.h"
+#include "seqlock.h"
+#include "servo_planner.h"
+
+void setup();
+void loop();
+extern int mode;
+extern unsigned long lastInputTime;
+extern bool timerDoneShowing;
+extern unsigned long timerDoneSince;
+extern JitterMeter renderJitter;
+extern int statsTaskId;
+
+static const uint8_t PIN_GREEN_LED = 16;
+static const uint8_t PIN_RED_LED = 17;
+
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(20);
+    }
+}
+
+void setUp() {
+    lastInputTime = millis();
+}
+void tearDown() {}
+
+static void test_outputs_follow_temperature_in_dht_mode() {
+    fakeHw::setDht(30.0, 50.0);
+    mode = 1;
+    runFor(3500);  // Satu periode sampling DHT + gerak servo
+    ControlSnapshot state = controlLoop.snapshot();
+    TEST_ASSERT_TRUE(state.dht.valid);
+    TEST_ASSERT_EQUAL_INT(135, state.servo);  // 15-35 C -> 0-180
+    TEST_ASSERT_TRUE(state.greenLed);
+    TEST_ASSERT_FALSE(state.redLed);
+    TEST_ASSERT_EQUAL_INT(HIGH, fakeHw::pinOutput(PIN_GREEN_LED));
+    TEST_ASSERT_EQUAL_INT(LOW, fakeHw::pinOutput(PIN_RED_LED));
+}
+
+// Di layar lain servo dan LED tetap di posisi terakhir walau sensor berubah
+static void test_outputs_hold_outside_sensor_modes() {
+    mode = 0;
+    fakeHw::setDht(16.0, 50.0);
+    runFor(2500);
+    ControlSnapshot state = controlLoop.snapshot();
+    TEST_ASSERT_TRUE(state.dht.temperature < 17.0);
+    TEST_ASSERT_EQUAL_INT(135, state.servo);
+    TEST_ASSERT_TRUE(state.greenLed);
+
+    mode = 1;
+    runFor(2000);  // 126 derajat dengan kecepatan terbatas
+    state = controlLoop.snapshot();
+    TEST_ASSERT_EQUAL_INT(9, state.servo);
+    TEST_ASSERT_TRUE(state.redLed);
+    mode = 0;
+}
+
+// Pola indikator menimpa LED mode, lalu LED kembali mengikuti sensor
+static void test_indicator_overrides_leds() {
+    mode = 1;
+    timerDoneShowing = true;
+    timerDoneSince = millis();
+    uint32_t changes = 0;
+    bool last = controlLoop.snapshot().greenLed;
+    for (int i = 0; i < 20; i++) {
+        runFor(100);
+        ControlSnapshot state = controlLoop.snapshot();
+        TEST_ASSERT_TRUE(state.greenLed != state.redLed);
+        changes += state.greenLed != last;
+        last = state.greenLed;
+    }
+    TEST_ASSERT_TRUE(changes >= 4);  // Kedip 250 ms selama 2 detik
+
+    timerDoneShowing = false;
+    runFor(50);
+    ControlSnapshot state = controlLoop.snapshot();
+    TEST_ASSERT_TRUE(state.redLed);  // 16 C: dingin
+    TEST_ASSERT_FALSE(state.greenLed);
+    mode = 0;
+}
+
+// Suhu di sekitar titik tengah (25 C) tidak membuat LED berganti-ganti; LED yang sama tidak ditulis ulang
+static void test_led_hysteresis_and_coalescing() {
+    mode = 1;
+    fakeHw::setDht(24.0, 50.0);
+    runFor(2500);
+    TEST_ASSERT_TRUE(controlLoop.snapshot().redLed);
+
+    fakeHw::setDht(25.1, 50.0);
+    uint32_t redWrites = fakeHw::pinWriteCount(PIN_RED_LED);
+    uint32_t greenWrites = fakeHw::pinWriteCount(PIN_GREEN_LED);
+    runFor(4500);
+    TEST_ASSERT_TRUE(controlLoop.snapshot().dht.temperature > 25.0);
+    TEST_ASSERT_TRUE(controlLoop.snapshot().redLed);  // Masih di dalam pita hysteresis
+    TEST_ASSERT_EQUAL_UINT32(redWrites, fakeHw::pinWriteCount(PIN_RED_LED));
+    TEST_ASSERT_EQUAL_UINT32(greenWrites, fakeHw::pinWriteCount(PIN_GREEN_LED));
+
+    fakeHw::setDht(25.3, 50.0);
+    runFor(2500);
+    TEST_ASSERT_TRUE(controlLoop.snapshot().greenLed);
+    TEST_ASSERT_EQUAL_UINT32(redWrites + 1, fakeHw::pinWriteCount(PIN_RED_LED));
+    TEST_ASSERT_EQUAL_UINT32(greenWrites + 1, fakeHw::pinWriteCount(PIN_GREEN_LED));
+    mode = 0;
+}
+
+// Di luar rentang 15-35 C servo berhenti di ujung, bukan diam di posisi terakhir
+static void test_cold_reading_drives_servo_to_end() {
+    mode = 1;
+    fakeHw::setDht(30.0, 50.0);
+    runFor(3500);
+    TEST_ASSERT_EQUAL_INT(135, controlLoop.snapshot().servo);
+
+    fakeHw::setDht(10.0, 50.0);
+    runFor(4000);
+    ControlSnapshot state = controlLoop.snapshot();
+    TEST_ASSERT_TRUE(state.dht.valid);
+    TEST_ASSERT_TRUE(state.dht.temperature < 11.0);
+    TEST_ASSERT_EQUAL_INT(0, state.servo);
+    TEST_ASSERT_TRUE(state.redLed);
+
+    fakeHw::setDht(40.0, 50.0);
+    runFor(4000);
+    TEST_ASSERT_EQUAL_INT(180, controlLoop.snapshot().servo);
+    mode = 0;
+}
+
+// Gerak 0 -> 180 derajat digerakkan timer saja: kecepatan dan percepatan terbatas, tiba tanpa overshoot
+static void test_servo_motion_is_rate_limited() {
+    static ServoPlanner planner;
+    planner.begin(25, 500, 2400, 0);
+    planner.moveTo(180);
+    TEST_ASSERT_TRUE(planner.moving());
+
+    int32_t lastMilli = 0;
+    int32_t lastSpeed = 0;
+    uint32_t elapsedMs = 0;
+    int32_t maxSpeed = 0;
+    int32_t maxAccel = 0;
+    while (planner.moving() && elapsedMs < 5000) {
+        fakeHw::advanceUs(SERVO_STEP_US);
+        elapsedMs += SERVO_STEP_US / 1000;
+        int32_t milli = planner.position() * 1000;
+        int32_t speed = milli - lastMilli;  // Per langkah, pembulatan 1 derajat
+        TEST_ASSERT_TRUE(planner.position() <= 180);
+        if (speed > maxSpeed) maxSpeed = speed;
+        if (abs(speed - lastSpeed) > maxAccel) maxAccel = abs(speed - lastSpeed);
+        lastMilli = milli;
+        lastSpeed = speed;
+    }
+    TEST_ASSERT_EQUAL_INT(180, planner.position());
+    // Trapesium: 0,25 s naik, 1,25 s jelajah 120 derajat/detik, 0,25 s turun
+    TEST_ASSERT_TRUE(elapsedMs >= 1600 && elapsedMs <= 1900);
+    TEST_ASSERT_TRUE(maxSpeed <= SERVO_MAX_SPEED * SERVO_STEP_US / 1000 + 1000);
+    TEST_ASSERT_TRUE(maxAccel <= 2000);
+
+    // Sampai di target timer berhenti; target dalam deadband tidak menggerakkan servo
+    uint32_t steps = planner.stats().steps;
+    uint32_t writes = planner.stats().writes;
+    planner.moveTo(179);
+    fakeHw::advanceUs(200000);
+    TEST_ASSERT_FALSE(planner.moving());
+    TEST_ASSERT_EQUAL_UINT32(steps, planner.stats().steps);
+    TEST_ASSERT_EQUAL_UINT32(writes, planner.stats().writes);
+    TEST_ASSERT_EQUAL_UINT32(1, planner.stats().deadbandSkips);
+}
+
+static void test_jitter_meter_statistics() {
+    JitterMeter meter("test");
+    meter.mark(0, 1000);      // Acuan pertama, tidak dihitung
+    meter.mark(1000, 1000);   // Tepat waktu
+    meter.mark(2300, 1000);   // Terlambat 300 us
+    meter.mark(2900, 1000);   // Terlalu cepat 400 us
+    meter.sync(10000);        // Run di luar jadwal: hanya acuan baru
+    meter.mark(11000, 1000);
+    const JitterStats& stats = meter.stats();
+    TEST_ASSERT_EQUAL_UINT32(4, stats.samples);
+    TEST_ASSERT_EQUAL_INT(-400, stats.minUs);
+    TEST_ASSERT_EQUAL_INT(300, stats.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(175, meter.meanAbsUs());
+    TEST_ASSERT_EQUAL_UINT32(250, meter.rmsUs());
+}
+
+// Build native menjalankan kontrol di loop yang sama dengan transfer display sinkron,
+// jadi yang diuji di sini hanya jadwalnya; deviasi maksimum baru berarti di ESP32
+static void test_control_loop_runs_on_schedule() {
+    scheduler.setEnabled(statsTaskId, false);  // Laporan berkala ikut me-reset statistik
+    runFor(100);  // Acuan baru setelah jam dimajukan tanpa loop() di test sebelumnya
+    controlLoop.resetStats();
+    renderJitter.resetStats();
+    runFor(3000);
+    scheduler.setEnabled(statsTaskId, true);
+    const JitterStats& control = controlLoop.jitter().stats();
+    TEST_ASSERT_TRUE(control.samples >= 250);
+    TEST_ASSERT_EQUAL_UINT32(CONTROL_PERIOD_MS * 1000, control.periodUs);
+    TEST_ASSERT_TRUE(controlLoop.jitter().meanAbsUs() <= 1000);
+    TEST_ASSERT_TRUE(renderJitter.stats().samples > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, controlLoop.uiStats().snapshotRetries);
+}
+
+struct Triple {
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+// Penulis di thread lain: pembaca tidak pernah melihat salinan setengah jadi
+static void test_seqlock_reader_never_sees_torn_value() {
+    static SeqLock<Triple> lock;
+    const uint32_t writes = 200000;
+    std::thread writer([] {
+        for (uint32_t i = 1; i <= writes; i++) {
+            lock.write({i, ~i, i * 3});
+        }
+    });
+    uint32_t torn = 0;
+    uint32_t last = 0;
+    uint32_t backwards = 0;
+    while (last < writes) {
+        Triple value;
+        lock.read(value);
+        if (value.b != ~value.a && value.a != 0) torn++;
+        if (value.c != value.a * 3) torn++;
+        if (value.a < last) backwards++;
+        last = value.a;
+    }
+    writer.join();
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards);
+    TEST_ASSERT_EQUAL_UINT32(writes, lock.version());
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::serialEcho(false);
+    fakeHw::setDht(24.5f, 55.0f);
+    setup();
+    runFor(2000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_outputs_follow_temperature_in_dht_mode);
+    RUN_TEST(test_outputs_hold_outside_sensor_modes);
+    RUN_TEST(test_indicator_overrides_leds);
+    RUN_TEST(test_led_hysteresis_and_coalescing);
+    RUN_TEST(test_cold_reading_drives_servo_to_end);
+    RUN_TEST(test_servo_motion_is_rate_limited);
+    RUN_TEST(test_jitter_meter_statistics);
+    RUN_TEST(test_control_loop_runs_on_schedule);
+    RUN_TEST(test_seqlock_reader_never_sees_torn_value);
+    return UNITY_END();
+}
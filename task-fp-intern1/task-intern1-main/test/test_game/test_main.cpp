@@ -0,0 +1,238 @@
+// Sprite 1bpp langsung ke framebuffer dan mode game dengan langkah fisika tetap.
+// Jalankan: pio test -e native -f test_game
+
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#include "buttons.h"
+#include "display.h"
+#include "fake_hw.h"
+#include "game.h"
+#include "scheduler.h"
+#include "sprite.h"
+
+void setup();
+void loop();
+extern int mode;
+extern int selectedMode;
+extern Adafruit_SSD1306 oled;
+extern Display screen;
+extern Game game;
+extern int renderTaskId;
+extern int statsTaskId;
+
+static const uint8_t PIN_GREEN_BUTTON = 19;
+static const uint8_t PIN_BLUE_BUTTON = 5;
+
+static constexpr sprite::Bitmap<8, 8> BLOCK(
+    "########"
+    "########"
+    "########"
+    "########"
+    "########"
+    "########"
+    "########"
+    "########");
+
+// Dua page: kolom 0 menyala di baris 0 dan 9, kolom 2 di semua baris
+static constexpr sprite::Bitmap<3, 10> TALL(
+    "#.#"
+    "..#"
+    "..#"
+    "..#"
+    "..#"
+    "..#"
+    "..#"
+    "..#"
+    "..#"
+    "#.#");
+
+static_assert(TALL.PAGES == 2, "10 baris = 2 page");
+static_assert(TALL.column[0][0] == 0x01 && TALL.column[1][0] == 0x02, "bit 0 = baris teratas page");
+static_assert(TALL.column[0][2] == 0xFF && TALL.column[1][2] == 0x03, "kolom penuh");
+
+// Framebuffer dengan penjaga di kedua sisi untuk menangkap tulisan di luar layar
+struct GuardedBuffer {
+    uint8_t before[16];
+    uint8_t pixels[Display::BUFFER_SIZE];
+    uint8_t after[16];
+};
+static GuardedBuffer frame;
+
+static void clearFrame() {
+    memset(&frame, 0, sizeof(frame));
+}
+
+static bool guardsIntact() {
+    for (uint8_t i = 0; i < 16; i++) {
+        if (frame.before[i] || frame.after[i]) return false;
+    }
+    return true;
+}
+
+static uint32_t litPixels() {
+    uint32_t count = 0;
+    for (int i = 0; i < Display::BUFFER_SIZE; i++) {
+        count += __builtin_popcount(frame.pixels[i]);
+    }
+    return count;
+}
+
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(20);
+    }
+}
+
+static void press(uint8_t pin, uint32_t holdMs) {
+    fakeHw::setPin(pin, LOW);
+    runFor(holdMs);
+    fakeHw::setPin(pin, HIGH);
+    runFor(100);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Geseran y % 8 membagi setiap kolom ke dua page; XOR dua kali kembali bersih
+static void test_blit_spans_pages() {
+    clearFrame();
+    sprite::blit(frame.pixels, BLOCK.ref(), 10, 4, sprite::BLIT_SET);
+    for (int x = 10; x < 18; x++) {
+        TEST_ASSERT_EQUAL_HEX32(0xF0, frame.pixels[x]);
+        TEST_ASSERT_EQUAL_HEX32(0x0F, frame.pixels[Display::WIDTH + x]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(64, litPixels());
+
+    sprite::blit(frame.pixels, TALL.ref(), 40, 13, sprite::BLIT_SET);  // Dua page sumber ke tiga page tujuan
+    TEST_ASSERT_EQUAL_HEX32(0x20, frame.pixels[Display::WIDTH + 40]);
+    TEST_ASSERT_EQUAL_HEX32(0x40, frame.pixels[2 * Display::WIDTH + 40]);
+    TEST_ASSERT_EQUAL_HEX32(0xE0, frame.pixels[Display::WIDTH + 42]);
+    TEST_ASSERT_EQUAL_HEX32(0x7F, frame.pixels[2 * Display::WIDTH + 42]);
+
+    sprite::blit(frame.pixels, BLOCK.ref(), 14, 8, sprite::BLIT_XOR);
+    sprite::blit(frame.pixels, BLOCK.ref(), 14, 8, sprite::BLIT_XOR);
+    sprite::blit(frame.pixels, BLOCK.ref(), 10, 4, sprite::BLIT_CLEAR);
+    sprite::blit(frame.pixels, TALL.ref(), 40, 13, sprite::BLIT_CLEAR);
+    TEST_ASSERT_EQUAL_UINT32(0, litPixels());
+}
+
+// Sprite di tepi dipotong tanpa menulis di luar framebuffer atau melipat ke baris lain
+static void test_blit_clips_at_edges() {
+    clearFrame();
+    sprite::blit(frame.pixels, BLOCK.ref(), -3, -3, sprite::BLIT_SET);
+    TEST_ASSERT_EQUAL_UINT32(25, litPixels());
+    TEST_ASSERT_EQUAL_HEX32(0x1F, frame.pixels[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x1F, frame.pixels[4]);
+    TEST_ASSERT_EQUAL_HEX32(0x00, frame.pixels[5]);
+
+    clearFrame();
+    sprite::blit(frame.pixels, BLOCK.ref(), 125, 60, sprite::BLIT_SET);
+    TEST_ASSERT_EQUAL_UINT32(12, litPixels());
+    TEST_ASSERT_EQUAL_HEX32(0xF0, frame.pixels[7 * Display::WIDTH + 127]);
+    TEST_ASSERT_TRUE(guardsIntact());
+
+    clearFrame();
+    sprite::blit(frame.pixels, BLOCK.ref(), 128, 0, sprite::BLIT_SET);
+    sprite::blit(frame.pixels, BLOCK.ref(), 0, 64, sprite::BLIT_SET);
+    sprite::blit(frame.pixels, BLOCK.ref(), -8, -8, sprite::BLIT_SET);
+    TEST_ASSERT_EQUAL_UINT32(0, litPixels());
+    TEST_ASSERT_TRUE(guardsIntact());
+}
+
+// Tile page-aligned menimpa isi lama (opaque)
+static void test_tile_replaces_columns() {
+    clearFrame();
+    memset(frame.pixels, 0xFF, Display::BUFFER_SIZE);
+    sprite::tile(frame.pixels, TALL.ref(), 126, 6);
+    TEST_ASSERT_EQUAL_HEX32(0x01, frame.pixels[6 * Display::WIDTH + 126]);
+    TEST_ASSERT_EQUAL_HEX32(0x00, frame.pixels[6 * Display::WIDTH + 127]);
+    TEST_ASSERT_EQUAL_HEX32(0x02, frame.pixels[7 * Display::WIDTH + 126]);
+    TEST_ASSERT_EQUAL_HEX32(0xFF, frame.pixels[6 * Display::WIDTH + 125]);
+    TEST_ASSERT_TRUE(guardsIntact());
+}
+
+static void test_bounds_collide() {
+    ui::Rect a = sprite::bounds(BLOCK.ref(), 10, 10);
+    TEST_ASSERT_TRUE(a.intersects(sprite::bounds(BLOCK.ref(), 17, 17)));
+    TEST_ASSERT_FALSE(a.intersects(sprite::bounds(BLOCK.ref(), 18, 10)));  // Hanya bersinggungan
+    TEST_ASSERT_FALSE(a.intersects(sprite::bounds(TALL.ref(), 10, 0)));
+}
+
+// Masuk dari menu, bermain sambil menahan biru: frame stabil dan hanya sprite yang dikirim
+static void test_game_holds_frame_rate() {
+    selectedMode = 5;
+    press(PIN_GREEN_BUTTON, 80);
+    TEST_ASSERT_EQUAL_INT(5, mode);
+    TEST_ASSERT_EQUAL(GAME_READY, game.state());
+    TEST_ASSERT_EQUAL_UINT32(GAME_FRAME_MS, scheduler.period(renderTaskId));
+
+    press(PIN_GREEN_BUTTON, 80);
+    TEST_ASSERT_EQUAL(GAME_PLAYING, game.state());
+    runFor(500);
+    game.resetStats();
+    fakeHw::setPin(PIN_BLUE_BUTTON, LOW);
+    runFor(2000);
+    fakeHw::setPin(PIN_BLUE_BUTTON, HIGH);
+    TEST_ASSERT_EQUAL(GAME_PLAYING, game.state());
+
+    const GameStats& stats = game.stats();
+    TEST_ASSERT_TRUE(stats.frames >= 2000 / GAME_FRAME_MS - 1);
+    TEST_ASSERT_TRUE(stats.intervals * 10000 / stats.intervalMsTotal >= 295);  // 29.5 fps
+    TEST_ASSERT_TRUE(stats.intervalMsMax <= GAME_FRAME_MS + 2);
+    TEST_ASSERT_UINT32_WITHIN(3, stats.intervalMsTotal / GAME_STEP_MS, stats.steps);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.stepsDropped);
+    TEST_ASSERT_TRUE(stats.updateUsMax + stats.drawUsMax < GAME_FRAME_MS * 1000);
+    TEST_ASSERT_TRUE(screen.stats().bytesLastFrame < 200);  // Bukan 1 KB layar penuh
+
+    // Kapal sampai di tepi kanan; panel sama dengan framebuffer setelah transfer parsial
+    runFor(100);
+    TEST_ASSERT_TRUE(screen.isIdle());
+    TEST_ASSERT_EQUAL_MEMORY(oled.getBuffer(), fakeHw::panelRam(), Display::BUFFER_SIZE);
+    TEST_ASSERT_TRUE(fakeHw::panelRam()[8 * Display::WIDTH - 1] != 0);
+}
+
+// Tanpa menghindar batu akhirnya menabrak; hijau memulai putaran baru
+static void test_collision_ends_round() {
+    uint32_t waited = 0;
+    while (game.state() == GAME_PLAYING && waited < 60000) {
+        runFor(500);
+        waited += 500;
+    }
+    TEST_ASSERT_EQUAL(GAME_OVER, game.state());
+    TEST_ASSERT_EQUAL_UINT32(game.score(), game.best());
+
+    press(PIN_GREEN_BUTTON, 80);
+    TEST_ASSERT_EQUAL(GAME_PLAYING, game.state());
+    TEST_ASSERT_EQUAL_UINT32(0, game.score());
+}
+
+// Hijau lama kembali ke layar jam dengan periode render biasa
+static void test_long_press_leaves_game() {
+    press(PIN_GREEN_BUTTON, BUTTON_LONG_PRESS_MS + 100);
+    TEST_ASSERT_EQUAL_INT(0, mode);
+    runFor(200);
+    TEST_ASSERT_EQUAL_UINT32(100, scheduler.period(renderTaskId));
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::serialEcho(false);
+    fakeHw::setDht(24.5f, 55.0f);
+    setup();
+    scheduler.setEnabled(statsTaskId, false);  // Laporan berkala ikut me-reset statistik
+    runFor(1000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_blit_spans_pages);
+    RUN_TEST(test_blit_clips_at_edges);
+    RUN_TEST(test_tile_replaces_columns);
+    RUN_TEST(test_bounds_collide);
+    RUN_TEST(test_game_holds_frame_rate);
+    RUN_TEST(test_collision_ends_round);
+    RUN_TEST(test_long_press_leaves_game);
+    return UNITY_END();
+}
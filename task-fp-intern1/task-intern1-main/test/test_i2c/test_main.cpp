@@ -0,0 +1,127 @@
+// Pengelola bus I2C: clock per perangkat, chunk framebuffer, retry dan pemulihan bus.
+// Jalankan: pio test -e native -f test_i2c
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "clock_service.h"
+#include "display.h"
+#include "fake_hw.h"
+#include "i2c_bus.h"
+
+void setup();
+void loop();
+extern Adafruit_SSD1306 oled;
+extern Display screen;
+
+static const uint8_t PANEL_ADDRESS = 0x3C;
+
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(20);
+    }
+}
+
+static int rtcDevice() {
+    return i2cBus.addDevice("ds1307", CLOCK_RTC_ADDRESS, CLOCK_RTC_I2C_CLOCK);
+}
+
+static void drawPattern(uint8_t seed) {
+    uint8_t* buffer = oled.getBuffer();
+    for (int i = 0; i < Display::BUFFER_SIZE; i++) {
+        buffer[i] = (uint8_t)(i * 7 + seed);
+    }
+}
+
+void setUp() {}
+void tearDown() {
+    fakeHw::failI2C(0, 0, 0);
+}
+
+static void test_each_device_runs_at_its_clock() {
+    runFor(2000);
+    TEST_ASSERT_EQUAL_UINT32(DISPLAY_I2C_CLOCK, fakeHw::i2cClock(PANEL_ADDRESS));
+    TEST_ASSERT_EQUAL_UINT32(CLOCK_RTC_I2C_CLOCK, fakeHw::i2cClock(CLOCK_RTC_ADDRESS));
+}
+
+// Layar penuh (1 KB) tidak boleh memegang bus lebih lama dari satu chunk
+static void test_full_frame_is_split_into_chunks() {
+    drawPattern(1);
+    screen.invalidate();
+    fakeHw::resetI2CStats();
+    screen.flush();
+
+    // Start + alamat + control byte + chunk + stop, 9 bit per byte
+    uint32_t chunkUs = (9 * (I2C_BUS_CHUNK + 2) + 2) * 1000000UL / DISPLAY_I2C_CLOCK + 1;
+    fakeHw::I2CStats stats = fakeHw::i2cStats();
+    TEST_ASSERT_TRUE(stats.bytesWritten >= (uint32_t)Display::BUFFER_SIZE);
+    TEST_ASSERT_TRUE(stats.longestUs <= chunkUs);
+    TEST_ASSERT_EQUAL_MEMORY(oled.getBuffer(), fakeHw::panelRam(), Display::BUFFER_SIZE);
+}
+
+static void test_nack_is_retried_then_reported() {
+    i2cBus.resetStats();
+    fakeHw::failI2C(CLOCK_RTC_ADDRESS, 2, 100);
+    const uint8_t pointer = 0x00;
+    uint8_t regs[7];
+    TEST_ASSERT_FALSE(i2cBus.writeRead(rtcDevice(), &pointer, 1, regs, sizeof(regs), I2C_PRIORITY_TIME));
+
+    const I2CDeviceStats& stats = i2cBus.deviceStats(rtcDevice());
+    TEST_ASSERT_EQUAL_UINT32(I2C_BUS_RETRIES + 1, stats.errors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.failures);
+    TEST_ASSERT_EQUAL_UINT32(0, i2cBus.stats().recoveries);  // NACK bukan bus macet
+    TEST_ASSERT_EQUAL_UINT8(2, i2cBus.stats().lastError);
+}
+
+// Slave menahan SDA: timeout memicu 9 pulsa SCL, lalu transaksi diulang dan berhasil
+static void test_timeout_recovers_bus() {
+    i2cBus.resetStats();
+    fakeHw::failI2C(CLOCK_RTC_ADDRESS, 5, 1);
+    fakeHw::setPin(I2C_SDA_PIN, LOW);
+    uint32_t sclWrites = fakeHw::pinWriteCount(I2C_SCL_PIN);
+
+    const uint8_t pointer = 0x00;
+    uint8_t regs[7];
+    bool ok = i2cBus.writeRead(rtcDevice(), &pointer, 1, regs, sizeof(regs), I2C_PRIORITY_TIME);
+    fakeHw::setPin(I2C_SDA_PIN, HIGH);
+
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL_UINT32(1, i2cBus.stats().recoveries);
+    TEST_ASSERT_EQUAL_UINT32(1, i2cBus.deviceStats(rtcDevice()).errors);
+    TEST_ASSERT_EQUAL_UINT32(0, i2cBus.deviceStats(rtcDevice()).failures);
+    TEST_ASSERT_TRUE(fakeHw::pinWriteCount(I2C_SCL_PIN) - sclWrites >= 18);
+    // Clock dipasang ulang setelah Wire dimulai ulang
+    TEST_ASSERT_EQUAL_UINT32(CLOCK_RTC_I2C_CLOCK, fakeHw::i2cClock(CLOCK_RTC_ADDRESS));
+}
+
+// Transfer panel yang gagal membuat frame berikutnya dikirim penuh
+static void test_failed_transfer_forces_full_refresh() {
+    screen.resetStats();
+    drawPattern(2);
+    fakeHw::failI2C(PANEL_ADDRESS, 2, I2C_BUS_RETRIES + 1);
+    screen.flush();
+    TEST_ASSERT_EQUAL_UINT32(1, screen.stats().transferErrors);
+
+    oled.drawPixel(0, 0, !oled.getPixel(0, 0));
+    screen.flush();
+    TEST_ASSERT_EQUAL_MEMORY(oled.getBuffer(), fakeHw::panelRam(), Display::BUFFER_SIZE);
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::clearNvs();
+    fakeHw::clearFlash();
+    fakeHw::serialEcho(false);
+    fakeHw::setDht(24.5f, 55.0f);
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_each_device_runs_at_its_clock);
+    RUN_TEST(test_full_frame_is_split_into_chunks);
+    RUN_TEST(test_nack_is_retried_then_reported);
+    RUN_TEST(test_timeout_recovers_bus);
+    RUN_TEST(test_failed_transfer_forces_full_refresh);
+    return UNITY_END();
+}
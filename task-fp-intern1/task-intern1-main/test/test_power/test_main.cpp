@@ -0,0 +1,155 @@
+// Light sleep di antara event: bangun oleh tick detik, tombol dan esp_timer; layar redup/mati.
+// Jalankan: pio test -e native -f test_power
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "control_loop.h"
+#include "display.h"
+#include "fake_hw.h"
+#include "power_manager.h"
+#include "scheduler.h"
+#include "timer_service.h"
+
+void setup();
+void loop();
+extern int mode;
+extern int selectedMode;
+extern unsigned long lastInputTime;
+extern bool timerDoneShowing;
+extern Display screen;
+extern int statsTaskId;
+
+static const uint8_t PIN_BLUE_BUTTON = 5;
+static const uint8_t PIN_RED_BUTTON = 18;
+static const uint8_t PIN_LDR = 13;
+static const uint32_t TIMEOUT_MS = 30000;  // TIMEOUT_DURATION di main.cpp: layar redup
+
+// Output telemetri dibuang seperti dibaca host; ring TX yang tertahan menunda tidur
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    uint8_t sink[256];
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(20);
+        while (fakeHw::serialOutput(sink, sizeof(sink)) > 0) {
+        }
+    }
+}
+
+// Tekan tombol selama holdMs, mulai delayMs dari sekarang (bisa di tengah light sleep)
+static void pressAt(uint8_t pin, uint32_t delayMs, uint32_t holdMs) {
+    uint64_t at = fakeHw::nowUs() + delayMs * 1000ULL;
+    fakeHw::setPinAt(at, pin, LOW);
+    fakeHw::setPinAt(at + holdMs * 1000ULL, pin, HIGH);
+}
+
+void setUp() {
+    mode = 0;
+    selectedMode = 0;
+    lastInputTime = millis();
+    runFor(200);  // Layar menyala lagi dari test sebelumnya
+    powerManager.resetStats();
+}
+void tearDown() {}
+
+// Layar jam: CPU tidur di antara detik dan sampel, jam tetap digambar setiap detik
+static void test_time_screen_sleeps_between_events() {
+    fakeHw::SleepStats before = fakeHw::lightSleepStats();
+    uint32_t frames = screen.stats().frames;
+    uint32_t dhtReads = fakeHw::dhtReadCount();
+    fakeHw::setAnalog(PIN_LDR, 3000);
+    runFor(6000);
+
+    fakeHw::SleepStats after = fakeHw::lightSleepStats();
+    TEST_ASSERT_TRUE(after.sleeps - before.sleeps >= 30);  // Sampel 200 ms dan tick detik
+    TEST_ASSERT_TRUE(after.sleepUs - before.sleepUs >= 6000000ULL * 80 / 100);
+    TEST_ASSERT_TRUE(screen.stats().frames - frames >= 5);
+    TEST_ASSERT_TRUE(fakeHw::dhtReadCount() - dhtReads >= 2);  // Sampel DHT 2 detik tetap berjalan
+
+    // LDR tanpa timer 1 kHz tetap mengikuti ADC
+    ControlSnapshot state = controlLoop.snapshot();
+    TEST_ASSERT_TRUE(state.ldr.adc >= 2900 && state.ldr.adc <= 3100);
+
+    const PowerStats& stats = powerManager.stats();
+    TEST_ASSERT_TRUE(stats.frame[WAKE_TIMER].count >= 5);
+    TEST_ASSERT_TRUE(stats.frame[WAKE_TIMER].usMax < 10000);  // Termasuk transfer digit ke panel
+    TEST_ASSERT_TRUE(powerManager.averageCurrentUa() < POWER_OLED_ON_UA + 10000);
+}
+
+// Tombol membangunkan CPU walau interupsi tepi mati selama tidur; tekanan tidak hilang
+static void test_button_wakes_from_light_sleep() {
+    uint32_t gpioWakes = fakeHw::lightSleepStats().gpioWakes;
+    pressAt(PIN_RED_BUTTON, 333, 80);
+    runFor(1000);
+
+    TEST_ASSERT_EQUAL_INT(5, selectedMode);  // Merah: pilihan menu mundur satu (ke Game)
+    TEST_ASSERT_EQUAL_UINT32(gpioWakes + 1, fakeHw::lightSleepStats().gpioWakes);
+    const PowerStats& stats = powerManager.stats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.wakes[WAKE_BUTTON]);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.frame[WAKE_BUTTON].count);
+    // Debounce 30 ms + periode input 10 ms
+    TEST_ASSERT_TRUE(stats.frame[WAKE_BUTTON].usMax < 45000);
+}
+
+// Tanpa input layar redup lalu mati; tekanan pertama hanya menyalakan layar
+static void test_display_dims_then_turns_off() {
+    runFor(TIMEOUT_MS + 1000);
+    TEST_ASSERT_TRUE(fakeHw::panelOn());
+    TEST_ASSERT_EQUAL_UINT8(0, fakeHw::panelContrast());
+
+    runFor(30000);
+    TEST_ASSERT_FALSE(fakeHw::panelOn());
+
+    // Layar mati: tidak ada frame dan tidak bangun setiap detik
+    uint32_t frames = screen.stats().frames;
+    powerManager.resetStats();
+    runFor(5000);
+    TEST_ASSERT_EQUAL_UINT32(frames, screen.stats().frames);
+    TEST_ASSERT_EQUAL_UINT32(0, powerManager.stats().frame[WAKE_TIMER].count);
+    TEST_ASSERT_TRUE(powerManager.displayCurrentUa() <= POWER_OLED_OFF_UA);
+
+    pressAt(PIN_BLUE_BUTTON, 100, 80);
+    runFor(500);
+    TEST_ASSERT_TRUE(fakeHw::panelOn());
+    TEST_ASSERT_EQUAL_UINT8(DISPLAY_CONTRAST, fakeHw::panelContrast());
+    TEST_ASSERT_EQUAL_INT(0, selectedMode);  // Tekanan tidak diteruskan ke menu
+    TEST_ASSERT_TRUE(screen.stats().frames > frames);
+
+    pressAt(PIN_BLUE_BUTTON, 100, 80);
+    runFor(500);
+    TEST_ASSERT_EQUAL_INT(1, selectedMode);
+}
+
+// Countdown di esp_timer: tidur dipendekkan ke tenggatnya, jadi tidak terlambat
+static void test_countdown_expires_on_time_while_sleeping() {
+    runFor(TIMEOUT_MS + 31000);
+    TEST_ASSERT_FALSE(fakeHw::panelOn());
+
+    // Countdown dari host berjalan di background, layar jam tetap boleh tidur
+    powerManager.resetStats();
+    TEST_ASSERT_TRUE(timerService.startCountdown(3000000ULL) >= 0);
+    runFor(3500);
+    TEST_ASSERT_TRUE(timerDoneShowing);
+    TEST_ASSERT_TRUE(fakeHw::panelOn());
+    TEST_ASSERT_TRUE(timerService.stats().lastLateUs < 1000);
+    TEST_ASSERT_TRUE(powerManager.stats().sleeps >= 10);
+    timerDoneShowing = false;
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::serialEcho(false);
+    fakeHw::setDht(24.5f, 55.0f);
+    setup();
+    runFor(POWER_HOST_GRACE_MS);  // Jendela host setelah boot
+    scheduler.setEnabled(statsTaskId, false);  // Laporan berkala ikut me-reset statistik
+    powerManager.setEnabled(true);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_time_screen_sleeps_between_events);
+    RUN_TEST(test_button_wakes_from_light_sleep);
+    RUN_TEST(test_display_dims_then_turns_off);
+    RUN_TEST(test_countdown_expires_on_time_while_sleeping);
+    return UNITY_END();
+}
@@ -0,0 +1,524 @@
+// Record/replay: input dan sensor direkam lewat MSG_TRACE, lalu diputar ulang
+// ke firmware baru di bawah jam virtual; hash frame dan statistik waktu dari
+// dua replay trace yang sama harus identik.
+// Jalankan: pio test -e native -f test_replay
+// Trace dari perangkat (tools/telemetry.py --trace):
+//   REPLAY_TRACE=capture.trc pio test -e native -f test_replay -v
+
+#include <Arduino.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "alarm_service.h"
+#include "buttons.h"
+#include "cobs.h"
+#include "control_loop.h"
+#include "display.h"
+#include "fake_hw.h"
+#include "scheduler.h"
+#include "telemetry.h"
+#include "trace.h"
+
+void setup();
+void loop();
+uint8_t handleTelemetryCommand(uint8_t type, const uint8_t* payload, size_t length);
+extern int mode;
+extern Display screen;
+extern int statsTaskId;
+
+static const uint8_t BUTTON_PINS[BUTTON_COUNT] = {19, 18, 5};  // Hijau, merah, biru
+static const uint8_t PIN_LDR = 13;
+static const uint32_t START_UNIX = 1709276378;  // 2024-03-01 06:59:38
+static const uint32_t BOOT_MS = 2000;           // Boot dan kunci fase RTC sebelum capture
+static const uint64_t ALIGN_MAX_US = 60000000;  // Capture lebih lama dari ini setelah boot: fase dalam 1 detik
+static const uint32_t TAIL_MS = 500;            // Setelah event terakhir
+static const size_t TRACE_MAX = 64 * 1024;
+
+struct ReplayResult {
+    uint32_t events;
+    uint32_t lost;              // Frame MSG_TRACE dan event yang hilang saat capture
+    uint32_t frames;
+    uint32_t frameHash;         // FNV-1a berantai atas GDDRAM panel setiap frame
+    uint32_t virtualMs;
+    uint32_t hostMs;            // Satu-satunya nilai yang tidak deterministik
+    uint32_t loopMaxUs;
+    uint32_t transferUsMax;
+    uint32_t inputLatencyUsMax; // Tepi tombol sampai event dibaca mode
+    uint32_t darkChanges;       // Keputusan Gelap/Terang di layar LDR
+    uint32_t alarmsFired;
+    uint32_t alarmsDismissed;
+    int32_t finalMode;
+    bool sawLdrMode;
+};
+
+// Output proses anak: hasil lalu isi trace (hanya saat merekam)
+struct ChildOutput {
+    ReplayResult result;
+    uint32_t traceLength;
+    uint8_t trace[TRACE_MAX];
+};
+
+static ChildOutput output;
+static uint8_t traceInput[TRACE_MAX];  // Trace yang diputar anak berikutnya
+static size_t traceInputLength = 0;
+
+// ---- Proses anak: satu firmware baru per run, global firmware hanya bisa di-setup() sekali ----
+
+typedef void (*ChildFn)();
+
+static bool runIsolated(ChildFn fn) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        memset(&output, 0, sizeof(output));
+        fn();
+        size_t length = offsetof(ChildOutput, trace) + output.traceLength;
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&output);
+        while (length > 0) {
+            ssize_t n = write(fds[1], p, length);
+            if (n <= 0) _exit(1);
+            p += n;
+            length -= n;
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    memset(&output, 0, sizeof(output));
+    uint8_t* p = reinterpret_cast<uint8_t*>(&output);
+    size_t received = 0;
+    ssize_t n;
+    while (received < sizeof(output) && (n = read(fds[0], p + received, sizeof(output) - received)) > 0) {
+        received += n;
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 && received >= offsetof(ChildOutput, trace);
+}
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t hostMs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// Ujung host UART: perintah masuk sebagai frame, MSG_TRACE dikumpulkan ke output.trace
+static uint8_t hostSeq = 0;
+static uint8_t rxPending[TELEMETRY_MAX_ENCODED];
+static size_t rxLength = 0;
+
+static void hostSend(uint8_t type, const void* payload, size_t length) {
+    uint8_t raw[TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD];
+    raw[0] = type;
+    raw[1] = hostSeq++;
+    memcpy(raw + 2, payload, length);
+    uint16_t crc = crc16(raw, length + 2);
+    raw[length + 2] = crc & 0xFF;
+    raw[length + 3] = crc >> 8;
+    uint8_t encoded[TELEMETRY_MAX_ENCODED];
+    size_t n = cobsEncode(raw, length + TELEMETRY_FRAME_OVERHEAD, encoded);
+    encoded[n++] = 0x00;
+    fakeHw::serialInput(encoded, n);
+}
+
+static void hostReceive() {
+    uint8_t buffer[512];
+    size_t n;
+    while ((n = fakeHw::serialOutput(buffer, sizeof(buffer))) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (buffer[i] != 0x00) {
+                if (rxLength < sizeof(rxPending)) rxPending[rxLength++] = buffer[i];
+                continue;
+            }
+            uint8_t raw[TELEMETRY_MAX_ENCODED];
+            size_t length = cobsDecode(rxPending, rxLength, raw);
+            rxLength = 0;
+            if (length < TELEMETRY_FRAME_OVERHEAD || raw[0] != MSG_TRACE) continue;
+            if (crc16(raw, length - 2) != (uint16_t)(raw[length - 2] | raw[length - 1] << 8)) continue;
+            size_t payload = length - TELEMETRY_FRAME_OVERHEAD;
+            if (output.traceLength + payload <= TRACE_MAX) {
+                memcpy(output.trace + output.traceLength, raw + 2, payload);
+                output.traceLength += payload;
+            }
+        }
+    }
+}
+
+// ---- Firmware di bawah jam virtual ----
+
+static uint32_t lastFrames = 0;
+static bool lastDark = false;
+
+static void step(ReplayResult& result) {
+    loop();
+    hostReceive();
+    uint32_t frames = screen.stats().frames;
+    if (frames != lastFrames) {
+        lastFrames = frames;
+        result.frames++;
+        result.frameHash = fnv1a(result.frameHash, fakeHw::panelRam(), 1024);
+    }
+    bool dark = controlLoop.snapshot().ldr.dark;
+    if (mode == 2) {
+        result.sawLdrMode = true;
+        if (dark != lastDark) result.darkChanges++;
+    }
+    lastDark = dark;
+    fakeHw::advanceUs(20);
+}
+
+static void runUntil(uint64_t us, ReplayResult& result) {
+    while (fakeHw::nowUs() < us) {
+        step(result);
+    }
+}
+
+static void boot(uint32_t unixtime, float temperature, float humidity, uint16_t ldrAdc) {
+    fakeHw::reset();
+    fakeHw::clearNvs();
+    fakeHw::clearFlash();
+    fakeHw::serialEcho(false);
+    fakeHw::setRtc(unixtime);
+    fakeHw::setDht(temperature, humidity);
+    fakeHw::setAnalog(PIN_LDR, ldrAdc);
+    setup();
+    scheduler.setEnabled(statsTaskId, false);  // Laporan berkala ikut me-reset statistik
+}
+
+// Jalankan sampai uptime tertentu tanpa menghitung frame
+static void settle(uint64_t uptimeUs) {
+    ReplayResult warmup = {};
+    runUntil(uptimeUs, warmup);
+    lastFrames = screen.stats().frames;
+    lastDark = controlLoop.snapshot().ldr.dark;
+}
+
+static void finish(ReplayResult& result, uint64_t startUs, uint32_t startHostMs) {
+    result.virtualMs = (uint32_t)((fakeHw::nowUs() - startUs) / 1000);
+    result.hostMs = hostMs() - startHostMs;
+    result.loopMaxUs = scheduler.loopMaxUs();
+    result.transferUsMax = screen.stats().transferUsMax;
+    result.inputLatencyUsMax = buttons.stats().latencyUsMax;
+    result.alarmsFired = alarmService.stats().fired;
+    result.alarmsDismissed = alarmService.stats().dismissed;
+    result.finalMode = mode;
+}
+
+// ---- Anak perekam: skenario di sekitar batas yang sulit diulang di perangkat ----
+
+struct Stimulus {
+    uint32_t atMs;  // Sejak capture dimulai
+    enum { PRESS, ADC, DHT, ALARM, STOP } kind;
+    uint32_t a;
+    uint32_t b;
+};
+
+static const Stimulus SCRIPT[] = {
+    {0, Stimulus::ALARM, 7, 0},             // Alarm slot 0 07:00 setiap hari, cocok 20 detik lagi
+    {500, Stimulus::PRESS, BUTTON_BLUE, 80},
+    {1000, Stimulus::PRESS, BUTTON_BLUE, 80},
+    {1500, Stimulus::PRESS, BUTTON_GREEN, 80},   // Masuk layar LDR
+    {3000, Stimulus::ADC, 1000, 0},         // Sekitar 500 lux: di dalam hysteresis, tetap Gelap
+    {4000, Stimulus::ADC, 900, 0},          // Sekitar 610 lux: Terang
+    {5000, Stimulus::ADC, 1000, 0},
+    {6000, Stimulus::ADC, 1100, 0},         // Sekitar 430 lux: Gelap lagi
+    {7000, Stimulus::DHT, 2750, 480},
+    {8000, Stimulus::PRESS, BUTTON_GREEN, 2300},  // Tekan lama: kembali ke layar jam
+    {22000, Stimulus::PRESS, BUTTON_BLUE, 80},    // Alarm berbunyi sejak 07:00, biru = matikan
+    {23500, Stimulus::STOP, 0, 0},
+};
+
+static void recordChild() {
+    boot(START_UNIX, 24.5f, 55.0f, 1100);
+    settle(BOOT_MS * 1000ULL);
+    ReplayResult& result = output.result;
+    uint8_t enable = 1;
+    hostSend(CMD_TRACE, &enable, 1);
+    uint64_t startUs = fakeHw::nowUs();
+    uint32_t startHost = hostMs();
+
+    for (const Stimulus& s : SCRIPT) {
+        uint64_t at = startUs + s.atMs * 1000ULL;
+        runUntil(at, result);
+        switch (s.kind) {
+            case Stimulus::PRESS:
+                fakeHw::setPinAt(at, BUTTON_PINS[s.a], LOW);
+                fakeHw::setPinAt(at + s.b * 1000ULL, BUTTON_PINS[s.a], HIGH);
+                break;
+            case Stimulus::ADC:
+                fakeHw::setAnalog(PIN_LDR, s.a);
+                break;
+            case Stimulus::DHT:
+                fakeHw::setDht(s.a / 100.0f, s.b / 10.0f);
+                break;
+            case Stimulus::ALARM: {
+                SetAlarmPayload cmd = {0, (uint8_t)s.a, (uint8_t)s.b, ALARM_DAYS_DAILY, 1};
+                hostSend(CMD_SET_ALARM, &cmd, sizeof(cmd));
+                break;
+            }
+            case Stimulus::STOP:
+                enable = 0;
+                hostSend(CMD_TRACE, &enable, 1);
+                break;
+        }
+    }
+    runUntil(fakeHw::nowUs() + TAIL_MS * 1000ULL, result);
+    finish(result, startUs, startHost);
+}
+
+// ---- Driver replay: event trace diberikan ke hardware palsu pada waktunya ----
+
+static void replayChild() {
+    TraceReader reader(traceInput, traceInputLength);
+    TraceEvent event;
+
+    // Event awal capture menjadi kondisi saat boot
+    uint32_t unixtime = START_UNIX;
+    float temperature = 24.5f, humidity = 55.0f;
+    uint16_t adc = 2048;
+    while (reader.next(event) && event.timeUs == 0) {
+        if (event.type == TRACE_RTC) unixtime = event.value;
+        if (event.type == TRACE_DHT && event.arg) {
+            temperature = event.value / 100.0f;
+            humidity = event.value2 / 10.0f;
+        }
+        if (event.type == TRACE_LDR) adc = (uint16_t)((event.value + LDR_OVERSAMPLE / 2) / LDR_OVERSAMPLE);
+    }
+
+    // Mulai pada uptime capture: fase task scheduler terhadap event sama dengan di perangkat
+    uint64_t startUs = reader.uptimeUs();
+    if (startUs > ALIGN_MAX_US) {
+        startUs = BOOT_MS * 1000ULL + startUs % 1000000;
+    }
+    boot(unixtime - (uint32_t)(startUs / 1000000), temperature, humidity, adc);
+    if (startUs < fakeHw::nowUs()) {
+        startUs = fakeHw::nowUs();
+    }
+    settle(startUs);
+
+    ReplayResult& result = output.result;
+    uint32_t startHost = hostMs();
+    uint32_t rtcBase = unixtime;  // DS1307 palsu: rtcBase pada rtcAtUs
+    uint64_t rtcAtUs = startUs;
+
+    TraceReader replay(traceInput, traceInputLength);
+    while (replay.next(event)) {
+        uint64_t at = startUs + event.timeUs;
+        runUntil(at, result);
+        result.events++;
+        switch (event.type) {
+            case TRACE_BUTTON:
+                fakeHw::setPin(BUTTON_PINS[(event.arg >> 1) % BUTTON_COUNT], event.arg & 1);
+                break;
+            case TRACE_DHT:
+                fakeHw::setDhtFailing(!event.arg);
+                if (event.arg) fakeHw::setDht(event.value / 100.0f, event.value2 / 10.0f);
+                break;
+            case TRACE_LDR:
+                fakeHw::setAnalog(PIN_LDR, (uint16_t)((event.value + LDR_OVERSAMPLE / 2) / LDR_OVERSAMPLE));
+                break;
+            case TRACE_RTC:
+                // Hanya lompatan (jam diubah, drift kristal) yang diterapkan; fase RTC palsu tetap
+                if (rtcBase + (uint32_t)((fakeHw::nowUs() - rtcAtUs) / 1000000) != (uint32_t)event.value) {
+                    fakeHw::setRtc(event.value);
+                    rtcBase = event.value;
+                    rtcAtUs = fakeHw::nowUs();
+                }
+                break;
+            case TRACE_COMMAND:
+                handleTelemetryCommand(event.command, event.payload, event.arg);
+                break;
+        }
+    }
+    runUntil(fakeHw::nowUs() + TAIL_MS * 1000ULL, result);
+    result.lost = replay.lostFrames() + replay.lostEvents();
+    finish(result, startUs, startHost);
+}
+
+static void printResult(const char* name, const ReplayResult& r) {
+    printf("%s: %lu events (%lu lost), %lu frames hash %08lx, %lu ms virtual in %lu ms host, "
+           "loop max %lu us, transfer max %lu us, input latency max %lu us\n",
+           name, (unsigned long)r.events, (unsigned long)r.lost, (unsigned long)r.frames,
+           (unsigned long)r.frameHash, (unsigned long)r.virtualMs, (unsigned long)r.hostMs,
+           (unsigned long)r.loopMaxUs, (unsigned long)r.transferUsMax,
+           (unsigned long)r.inputLatencyUsMax);
+}
+
+static bool replay(const uint8_t* trace, size_t length, ReplayResult& result) {
+    memcpy(traceInput, trace, length);
+    traceInputLength = length;
+    bool ok = runIsolated(replayChild);
+    result = output.result;
+    return ok;
+}
+
+// ---- Test ----
+
+static ReplayResult recorded;
+static uint8_t recordedTrace[TRACE_MAX];
+static size_t recordedLength = 0;
+
+void setUp() {}
+void tearDown() {}
+
+// Encode/decode: delta negatif, perintah, frame hilang terlihat dari nomor SYNC
+static void test_format_roundtrip() {
+    uint8_t data[128];
+    TraceWriter writer;
+    size_t n = TraceWriter::header(BOOT_MS * 1000ULL, data);
+    n += writer.sync(0, 0, data + n);
+    TraceEvent events[4] = {};
+    events[0].timeUs = 1500;
+    events[0].type = TRACE_BUTTON;
+    events[0].arg = BUTTON_RED << 1;
+    events[1].timeUs = 1400;  // Waktu ISR mendahului event sebelumnya
+    events[1].type = TRACE_DHT;
+    events[1].arg = 1;
+    events[1].value = -1250;
+    events[1].value2 = 875;
+    events[2].timeUs = 2000000;
+    events[2].type = TRACE_COMMAND;
+    events[2].arg = 2;
+    events[2].command = CMD_SET_MODE;
+    events[2].payload[0] = 3;
+    events[2].payload[1] = 9;
+    for (int i = 0; i < 3; i++) {
+        n += writer.encode(events[i], data + n);
+    }
+    n += writer.sync(2, 5000000, data + n);  // Frame 1 dibuang ring TX
+    events[3].timeUs = 5000100;
+    events[3].type = TRACE_RTC;
+    events[3].value = (int32_t)START_UNIX;
+    n += writer.encode(events[3], data + n);
+
+    TraceReader reader(data, n);
+    TEST_ASSERT_TRUE(reader.valid());
+    TEST_ASSERT_TRUE(reader.uptimeUs() == BOOT_MS * 1000ULL);
+    TraceEvent event;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(reader.next(event));
+        TEST_ASSERT_TRUE(event.timeUs == events[i].timeUs);
+        TEST_ASSERT_EQUAL_UINT8(events[i].type, event.type);
+        TEST_ASSERT_EQUAL_UINT8(events[i].arg, event.arg);
+        TEST_ASSERT_EQUAL_INT(events[i].value, event.value);
+        TEST_ASSERT_EQUAL_INT(events[i].value2, event.value2);
+        TEST_ASSERT_EQUAL_MEMORY(events[i].payload, event.payload, TRACE_COMMAND_MAX);
+    }
+    TEST_ASSERT_FALSE(reader.next(event));
+    TEST_ASSERT_FALSE(reader.corrupt());
+    TEST_ASSERT_EQUAL_UINT32(1, reader.lostFrames());
+
+    data[n - 1] = 0x80;  // Varint terpotong
+    TraceReader broken(data, n);
+    while (broken.next(event)) {
+    }
+    TEST_ASSERT_TRUE(broken.corrupt());
+}
+
+// Capture: semua jenis event ada, ringkas dan tanpa kehilangan
+static void test_capture_records_inputs_and_sensors() {
+    TEST_ASSERT_TRUE(runIsolated(recordChild));
+    recorded = output.result;
+    recordedLength = output.traceLength;
+    memcpy(recordedTrace, output.trace, recordedLength);
+
+    TraceReader reader(recordedTrace, recordedLength);
+    TEST_ASSERT_TRUE(reader.valid());
+    TEST_ASSERT_TRUE(reader.uptimeUs() >= BOOT_MS * 1000ULL);
+    uint32_t counts[TRACE_END + 1] = {};
+    TraceEvent event;
+    uint64_t endUs = 0;
+    while (reader.next(event)) {
+        counts[event.type]++;
+        recorded.events++;
+        endUs = event.timeUs;
+    }
+    printResult("record", recorded);
+    printf("trace: %lu bytes\n", (unsigned long)recordedLength);
+    TEST_ASSERT_FALSE(reader.corrupt());
+    TEST_ASSERT_EQUAL_UINT32(0, reader.lostFrames() + reader.lostEvents());
+    TEST_ASSERT_EQUAL_UINT32(10, counts[TRACE_BUTTON]);  // 5 tekanan tanpa pantulan
+    TEST_ASSERT_EQUAL_UINT32(1, counts[TRACE_COMMAND]);  // CMD_TRACE sendiri tidak direkam
+    TEST_ASSERT_TRUE(counts[TRACE_DHT] >= 10);           // Setiap 2 detik
+    TEST_ASSERT_TRUE(counts[TRACE_LDR] >= 5);            // Hanya blok yang berubah
+    TEST_ASSERT_TRUE(counts[TRACE_RTC] >= 1);            // Awal capture, lalu setiap resync
+    TEST_ASSERT_EQUAL_UINT32(1, counts[TRACE_END]);
+    TEST_ASSERT_UINT32_WITHIN(50, 23500, (uint32_t)(endUs / 1000));
+    TEST_ASSERT_TRUE(recordedLength < 1024);
+}
+
+// Dua replay trace yang sama: frame dan statistik waktu virtual identik bit per bit
+static void test_replay_is_deterministic() {
+    ReplayResult first, second;
+    TEST_ASSERT_TRUE(replay(recordedTrace, recordedLength, first));
+    TEST_ASSERT_TRUE(replay(recordedTrace, recordedLength, second));
+    printResult("replay", first);
+    TEST_ASSERT_TRUE(first.frames > 100);
+    TEST_ASSERT_EQUAL_UINT32(first.frames, second.frames);
+    TEST_ASSERT_EQUAL_HEX32(first.frameHash, second.frameHash);
+    TEST_ASSERT_EQUAL_UINT32(first.virtualMs, second.virtualMs);
+    TEST_ASSERT_EQUAL_UINT32(first.loopMaxUs, second.loopMaxUs);
+    TEST_ASSERT_EQUAL_UINT32(first.transferUsMax, second.transferUsMax);
+    TEST_ASSERT_EQUAL_UINT32(first.inputLatencyUsMax, second.inputLatencyUsMax);
+}
+
+// Replay mengulang perilaku rekaman: batas 500 lux, tekan lama dan alarm 07:00.
+// Hash frame boleh berbeda dari rekaman: nilai LDR diterapkan per blok, bukan per sampel.
+static void test_replay_reproduces_recording() {
+    ReplayResult result;
+    TEST_ASSERT_TRUE(replay(recordedTrace, recordedLength, result));
+    TEST_ASSERT_TRUE(recorded.sawLdrMode && result.sawLdrMode);
+    TEST_ASSERT_EQUAL_UINT32(2, recorded.darkChanges);  // Gelap -> Terang -> Gelap, 500 lux tidak bergetar
+    TEST_ASSERT_EQUAL_UINT32(recorded.darkChanges, result.darkChanges);
+    TEST_ASSERT_EQUAL_UINT32(1, recorded.alarmsFired);
+    TEST_ASSERT_EQUAL_UINT32(recorded.alarmsFired, result.alarmsFired);
+    TEST_ASSERT_EQUAL_UINT32(recorded.alarmsDismissed, result.alarmsDismissed);
+    TEST_ASSERT_EQUAL_INT(0, result.finalMode);  // Tekan lama hijau kembali ke layar jam
+    TEST_ASSERT_UINT32_WITHIN(recorded.frames / 20, recorded.frames, result.frames);
+    TEST_ASSERT_UINT32_WITHIN(1000, recorded.inputLatencyUsMax, result.inputLatencyUsMax);
+}
+
+// Trace lapangan dari REPLAY_TRACE: diputar dua kali, laporan dicetak
+static void test_field_trace() {
+    const char* path = getenv("REPLAY_TRACE");
+    FILE* file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    static uint8_t trace[TRACE_MAX];
+    size_t length = fread(trace, 1, sizeof(trace), file);
+    fclose(file);
+    TraceReader reader(trace, length);
+    TEST_ASSERT_TRUE_MESSAGE(reader.valid(), "Bukan file trace");
+
+    ReplayResult first, second;
+    TEST_ASSERT_TRUE(replay(trace, length, first));
+    TEST_ASSERT_TRUE(replay(trace, length, second));
+    printResult(path, first);
+    TEST_ASSERT_EQUAL_HEX32(first.frameHash, second.frameHash);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_format_roundtrip);
+    RUN_TEST(test_capture_records_inputs_and_sensors);
+    RUN_TEST(test_replay_is_deterministic);
+    RUN_TEST(test_replay_reproduces_recording);
+    if (getenv("REPLAY_TRACE")) {
+        RUN_TEST(test_field_trace);
+    }
+    return UNITY_END();
+}
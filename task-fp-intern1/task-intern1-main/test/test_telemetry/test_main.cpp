@@ -0,0 +1,276 @@
+// Loopback protokol telemetri: host palsu di sisi lain UART palsu.
+// Jalankan: pio test -e native -f test_telemetry
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "alarm_service.h"
+#include "cobs.h"
+#include "fake_hw.h"
+#include "history_log.h"
+#include "telemetry.h"
+#include "timer_service.h"
+
+void setup();
+void loop();
+extern int mode;
+
+struct HostFrame {
+    uint8_t type;
+    uint8_t seq;
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    size_t length;
+};
+
+// Decoder sisi host, sama seperti tools/telemetry.py
+class HostLink {
+public:
+    void sendCommand(uint8_t type, const void* payload, size_t length) {
+        uint8_t raw[TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD];
+        raw[0] = type;
+        raw[1] = seq_++;
+        memcpy(raw + 2, payload, length);
+        uint16_t crc = crc16(raw, length + 2);
+        raw[length + 2] = crc & 0xFF;
+        raw[length + 3] = crc >> 8;
+        uint8_t encoded[TELEMETRY_MAX_ENCODED];
+        size_t n = cobsEncode(raw, length + TELEMETRY_FRAME_OVERHEAD, encoded);
+        encoded[n++] = 0x00;
+        fakeHw::serialInput(encoded, n);
+    }
+
+    // Ambil semua byte dari UART dan decode frame yang lengkap
+    void receive() {
+        uint8_t buffer[1024];
+        size_t n;
+        while ((n = fakeHw::serialOutput(buffer, sizeof(buffer))) > 0) {
+            for (size_t i = 0; i < n; i++) {
+                if (buffer[i] != 0x00) {
+                    if (length_ < sizeof(pending_)) pending_[length_++] = buffer[i];
+                    continue;
+                }
+                decode();
+                length_ = 0;
+            }
+        }
+    }
+
+    // Frame terakhir dengan tipe tertentu, nullptr jika tidak ada
+    const HostFrame* last(uint8_t type) const {
+        for (int i = count_ - 1; i >= 0; i--) {
+            if (frames_[i].type == type) return &frames_[i];
+        }
+        return nullptr;
+    }
+    int count(uint8_t type) const {
+        int n = 0;
+        for (int i = 0; i < count_; i++) n += frames_[i].type == type;
+        return n;
+    }
+    void clear() { count_ = 0; }
+
+    uint32_t crcErrors = 0;
+
+private:
+    void decode() {
+        uint8_t raw[TELEMETRY_MAX_ENCODED];
+        size_t n = cobsDecode(pending_, length_, raw);
+        if (n < TELEMETRY_FRAME_OVERHEAD) return;
+        uint16_t crc = raw[n - 2] | (raw[n - 1] << 8);
+        if (crc16(raw, n - 2) != crc) {
+            crcErrors++;
+            return;
+        }
+        if (count_ >= 256) return;
+        HostFrame& frame = frames_[count_++];
+        frame.type = raw[0];
+        frame.seq = raw[1];
+        frame.length = n - TELEMETRY_FRAME_OVERHEAD;
+        memcpy(frame.payload, raw + 2, frame.length);
+    }
+
+    uint8_t seq_ = 0;
+    uint8_t pending_[TELEMETRY_MAX_ENCODED];
+    size_t length_ = 0;
+    HostFrame frames_[256];
+    int count_ = 0;
+};
+
+static HostLink host;
+
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(50);
+    }
+    host.receive();
+}
+
+static const AckPayload* lastAck() {
+    const HostFrame* frame = host.last(MSG_ACK);
+    return frame ? reinterpret_cast<const AckPayload*>(frame->payload) : nullptr;
+}
+
+void setUp() {
+    host.clear();
+}
+
+void tearDown() {}
+
+static void test_cobs_roundtrip() {
+    uint8_t data[600];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (i % 300 == 0) ? 0 : (uint8_t)i;  // Blok panjang tanpa nol dan nol di batas blok
+    }
+    const size_t lengths[] = {0, 1, 253, 254, 255, 600};
+    for (size_t length : lengths) {
+        uint8_t encoded[COBS_MAX_ENCODED(600)];
+        uint8_t decoded[600];
+        size_t n = cobsEncode(data, length, encoded);
+        TEST_ASSERT_TRUE(n <= COBS_MAX_ENCODED(length));
+        TEST_ASSERT_TRUE(memchr(encoded, 0, n) == nullptr);
+        TEST_ASSERT_EQUAL(length, cobsDecode(encoded, n, decoded));
+        TEST_ASSERT_EQUAL_MEMORY(data, decoded, length);
+    }
+}
+
+static void test_crc_check_value() {
+    TEST_ASSERT_EQUAL_HEX32(0x29B1, crc16((const uint8_t*)"123456789", 9));
+}
+
+static void test_samples_stream() {
+    runFor(1000);
+    TEST_ASSERT_TRUE(host.count(MSG_SAMPLE) >= 4);
+    const HostFrame* frame = host.last(MSG_SAMPLE);
+    TEST_ASSERT_EQUAL(sizeof(SamplePayload), frame->length);
+    SamplePayload sample;
+    memcpy(&sample, frame->payload, sizeof(sample));
+    TEST_ASSERT_EQUAL_INT(2450, sample.temperatureCenti);
+    TEST_ASSERT_EQUAL_INT(553, sample.humidityDeci);
+    TEST_ASSERT_TRUE(sample.flags & SAMPLE_DHT_VALID);
+    TEST_ASSERT_EQUAL_UINT32(0, host.crcErrors);
+}
+
+static void test_set_mode_command() {
+    ModePayload cmd = {2};
+    host.sendCommand(CMD_SET_MODE, &cmd, sizeof(cmd));
+    runFor(50);
+    TEST_ASSERT_EQUAL_INT(2, mode);
+    TEST_ASSERT_NOT_NULL(lastAck());
+    TEST_ASSERT_EQUAL(CMD_SET_MODE, lastAck()->command);
+    TEST_ASSERT_EQUAL(ACK_OK, lastAck()->status);
+
+    ModePayload bad = {9};
+    host.sendCommand(CMD_SET_MODE, &bad, sizeof(bad));
+    runFor(50);
+    TEST_ASSERT_EQUAL(ACK_INVALID, lastAck()->status);
+    TEST_ASSERT_EQUAL_INT(2, mode);
+}
+
+static void test_set_alarm_command() {
+    SetAlarmPayload cmd = {4, 6, 45, ALARM_DAYS_WEEKDAYS, 1};
+    host.sendCommand(CMD_SET_ALARM, &cmd, sizeof(cmd));
+    runFor(50);
+    TEST_ASSERT_EQUAL(ACK_OK, lastAck()->status);
+    const AlarmSpec& spec = alarmService.get(4);
+    TEST_ASSERT_EQUAL_UINT8(6, spec.hour);
+    TEST_ASSERT_EQUAL_UINT8(45, spec.minute);
+    TEST_ASSERT_EQUAL_UINT8(ALARM_DAYS_WEEKDAYS, spec.days);
+}
+
+static void test_countdown_command() {
+    CountdownPayload cmd = {90};
+    host.sendCommand(CMD_START_COUNTDOWN, &cmd, sizeof(cmd));
+    runFor(50);
+    TEST_ASSERT_EQUAL(ACK_OK, lastAck()->status);
+    TEST_ASSERT_EQUAL_INT(1, timerService.count(TIMER_COUNTDOWN));
+    TEST_ASSERT_EQUAL_INT(3, mode);
+}
+
+static void test_query_stats_command() {
+    host.sendCommand(CMD_QUERY_STATS, nullptr, 0);
+    runFor(50);
+    const HostFrame* frame = host.last(MSG_STATS);
+    TEST_ASSERT_NOT_NULL(frame);
+    TEST_ASSERT_EQUAL(sizeof(StatsPayload), frame->length);
+    StatsPayload stats;
+    memcpy(&stats, frame->payload, sizeof(stats));
+    TEST_ASSERT_TRUE(stats.frames > 0);
+}
+
+static void test_corrupted_frame_rejected() {
+    uint32_t errors = telemetry.stats().rxErrors;
+    const uint8_t garbage[] = {0x05, 0x12, 0x34, 0x56, 0x78, 0x00};
+    fakeHw::serialInput(garbage, sizeof(garbage));
+    runFor(50);
+    TEST_ASSERT_EQUAL_UINT32(errors + 1, telemetry.stats().rxErrors);
+    TEST_ASSERT_TRUE(lastAck() == nullptr);
+
+    // Frame berikutnya tetap diterima setelah sampah
+    host.sendCommand(CMD_QUERY_STATS, nullptr, 0);
+    runFor(50);
+    TEST_ASSERT_NOT_NULL(lastAck());
+}
+
+static void test_full_ring_drops_whole_frames() {
+    // UART tidak dikuras: ring TX penuh, send() menolak tanpa menunggu
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD] = {};
+    uint32_t dropped = telemetry.stats().framesDropped;
+    int accepted = 0;
+    for (int i = 0; i < 100; i++) {
+        accepted += telemetry.send(MSG_LOG, payload, sizeof(payload));
+    }
+    TEST_ASSERT_TRUE(accepted < 100);
+    TEST_ASSERT_EQUAL_UINT32(dropped + (100 - accepted), telemetry.stats().framesDropped);
+
+    runFor(200);
+    TEST_ASSERT_EQUAL_UINT32(0, host.crcErrors);  // Tidak ada frame terpotong
+}
+
+static void test_history_export() {
+    // 100 titik sintetis, ekspor 50 titik di tengah
+    const uint32_t base = 1700000000;
+    for (uint32_t i = 0; i < 100; i++) {
+        HistoryRecord record = {base + i * 10, (int16_t)(2000 + i), 500, i * 3, true};
+        historyLog.append(record);
+    }
+    HistoryQueryPayload cmd = {base + 250, base + 740};
+    host.sendCommand(CMD_HISTORY, &cmd, sizeof(cmd));
+    runFor(500);
+    TEST_ASSERT_EQUAL(ACK_OK, lastAck()->status);
+
+    int frames = host.count(MSG_HISTORY);
+    TEST_ASSERT_EQUAL_INT(50 / HISTORY_POINTS_PER_FRAME + 1, frames);
+    const HostFrame* end = host.last(MSG_HISTORY);
+    TEST_ASSERT_TRUE(end->length < HISTORY_POINTS_PER_FRAME * sizeof(HistoryPointPayload));
+
+    HistoryPointPayload last;
+    memcpy(&last, end->payload + end->length - sizeof(last), sizeof(last));
+    TEST_ASSERT_EQUAL_UINT32(base + 740, last.time);
+    TEST_ASSERT_EQUAL_INT(2074, last.temperatureCenti);
+    TEST_ASSERT_EQUAL_UINT32(222, last.lux);
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::clearNvs();
+    fakeHw::clearFlash();
+    fakeHw::serialEcho(false);
+    fakeHw::setDht(24.5f, 55.3f);
+    setup();
+    runFor(3000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_cobs_roundtrip);
+    RUN_TEST(test_crc_check_value);
+    RUN_TEST(test_samples_stream);
+    RUN_TEST(test_set_mode_command);
+    RUN_TEST(test_set_alarm_command);
+    RUN_TEST(test_countdown_command);
+    RUN_TEST(test_query_stats_command);
+    RUN_TEST(test_corrupted_frame_rejected);
+    RUN_TEST(test_full_ring_drops_whole_frames);
+    RUN_TEST(test_history_export);
+    return UNITY_END();
+}
@@ -0,0 +1,183 @@
+// Countdown dan stopwatch di timerService: drift, event selesai di mode lain, lap.
+// Jalankan: pio test -e native -f test_timer
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "fake_hw.h"
+#include "timer_service.h"
+
+void setup();
+void loop();
+extern int mode;
+extern int selectedMode;
+extern unsigned long lastInputTime;
+extern bool timerDoneShowing;
+
+static const uint8_t PIN_GREEN = 19;
+static const uint8_t PIN_RED = 18;
+static const uint8_t PIN_BLUE = 5;
+static const uint8_t PIN_GREEN_LED = 16;
+
+#define TIMER_LOOP_COST_US 20
+
+static void runFor(uint32_t ms) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(TIMER_LOOP_COST_US);
+    }
+}
+
+// Jalankan loop dengan langkah besar; cukup untuk menguji drift selama satu jam
+static void runCoarse(uint32_t ms, uint32_t stepUs) {
+    uint64_t end = fakeHw::nowUs() + ms * 1000ULL;
+    while (fakeHw::nowUs() < end) {
+        loop();
+        fakeHw::advanceUs(stepUs);
+    }
+}
+
+static void press(uint8_t pin, uint32_t holdMs) {
+    fakeHw::setPin(pin, LOW);
+    runFor(holdMs);
+    fakeHw::setPin(pin, HIGH);
+    runFor(100);
+}
+
+void setUp() {
+    for (int id = 0; id < TIMER_MAX; id++) {
+        timerService.cancel(id);
+    }
+    timerService.resetStats();
+}
+void tearDown() {}
+
+// Satu jam di latar belakang sambil layar lain digambar: tenggat tidak bergeser
+static void test_one_hour_countdown_has_no_drift() {
+    uint64_t start = fakeHw::nowUs();
+    int id = timerService.startCountdown(3600ULL * 1000000);
+    TEST_ASSERT_TRUE(id >= 0);
+    runCoarse(1800000, 1000);
+    uint64_t left = timerService.remainingUs(id);
+    uint64_t expected = start + 3600ULL * 1000000 - fakeHw::nowUs();
+    TEST_ASSERT_TRUE(left == expected);
+
+    runCoarse(1800100, 1000);
+    TEST_ASSERT_FALSE(timerService.isActive(id));
+    TEST_ASSERT_EQUAL_UINT32(1, timerService.stats().expired);
+    TEST_ASSERT_TRUE(timerService.stats().maxLateUs >= 0);
+    TEST_ASSERT_TRUE(timerService.stats().maxLateUs <= 2000);
+    // Event sampai ke aplikasi paling lambat satu periode task jam (10 ms) + satu langkah loop
+    TEST_ASSERT_TRUE(timerService.stats().eventLatencyUsMax <= 12000);
+    timerDoneShowing = false;
+}
+
+static void test_expiry_raises_event_in_other_mode() {
+    mode = 1;  // Layar DHT
+    lastInputTime = millis();
+    int id = timerService.startCountdown(2000000);
+    runFor(1990);
+    TEST_ASSERT_TRUE(timerService.isActive(id));
+    TEST_ASSERT_FALSE(timerDoneShowing);
+    runFor(50);
+    TEST_ASSERT_FALSE(timerService.isActive(id));
+    TEST_ASSERT_TRUE(timerDoneShowing);
+    TEST_ASSERT_EQUAL_INT(1, mode);  // Layar selesai menimpa mode, bukan menggantinya
+
+    // LED berkedip, tombol apa pun menutup layar selesai
+    uint32_t ledWrites = fakeHw::pinWriteCount(PIN_GREEN_LED);
+    runFor(1000);
+    TEST_ASSERT_TRUE(fakeHw::pinWriteCount(PIN_GREEN_LED) > ledWrites);
+    press(PIN_RED, 80);
+    TEST_ASSERT_FALSE(timerDoneShowing);
+    TEST_ASSERT_EQUAL_INT(1, mode);
+    mode = 0;
+}
+
+static void test_several_countdowns_and_pause() {
+    int a = timerService.startCountdown(3000000);
+    int b = timerService.startCountdown(1000000);
+    TEST_ASSERT_TRUE(a >= 0 && b >= 0 && a != b);
+    TEST_ASSERT_EQUAL_INT(2, timerService.count(TIMER_COUNTDOWN));
+
+    timerService.pause(a);
+    runFor(1500);
+    TEST_ASSERT_FALSE(timerService.isActive(b));
+    TEST_ASSERT_TRUE(timerService.isActive(a));
+    TEST_ASSERT_TRUE(timerService.remainingUs(a) > 2990000);  // Tidak berkurang saat dijeda
+
+    timerService.resume(a);
+    runFor(3100);
+    TEST_ASSERT_FALSE(timerService.isActive(a));
+    TEST_ASSERT_EQUAL_UINT32(2, timerService.stats().expired);
+    timerDoneShowing = false;
+}
+
+static void test_full_slots_are_rejected() {
+    for (int i = 0; i < TIMER_MAX; i++) {
+        TEST_ASSERT_TRUE(timerService.startCountdown(60000000) >= 0);
+    }
+    TEST_ASSERT_EQUAL_INT(-1, timerService.startCountdown(60000000));
+    TEST_ASSERT_EQUAL_INT(-1, timerService.startStopwatch());
+}
+
+static void test_stopwatch_laps_in_microseconds() {
+    int id = timerService.startStopwatch();
+    fakeHw::advanceUs(1234567);
+    TEST_ASSERT_TRUE(timerService.lap(id));
+    fakeHw::advanceUs(250001);
+    timerService.pause(id);
+    fakeHw::advanceUs(5000000);  // Dijeda: tidak dihitung
+    timerService.resume(id);
+    fakeHw::advanceUs(100);
+    TEST_ASSERT_TRUE(timerService.lap(id));
+
+    TEST_ASSERT_EQUAL_UINT32(2, timerService.lapCount(id));
+    TEST_ASSERT_TRUE(timerService.lapUs(id, 0) == 1234567);
+    TEST_ASSERT_TRUE(timerService.lapUs(id, 1) == 250101);
+    TEST_ASSERT_TRUE(timerService.elapsedUs(id) == 1484668);
+}
+
+// Stopwatch dari tombol tetap berjalan setelah keluar dari layarnya
+static void test_stopwatch_runs_in_background() {
+    while (selectedMode != 3) {
+        press(PIN_BLUE, 80);
+    }
+    press(PIN_GREEN, 80);  // Masuk menu alarm
+    press(PIN_BLUE, 80);
+    press(PIN_BLUE, 80);   // Pilih Stopwatch
+    press(PIN_GREEN, 80);
+    press(PIN_BLUE, 80);   // Mulai
+    TEST_ASSERT_EQUAL_INT(1, timerService.count(TIMER_STOPWATCH));
+    press(PIN_RED, 80);    // Lap
+    press(PIN_GREEN, 2300);  // Kembali ke menu alarm
+    press(PIN_GREEN, 2300);  // Kembali ke mode 0
+    TEST_ASSERT_EQUAL_INT(0, mode);
+
+    int id = timerService.next(TIMER_STOPWATCH, -1);
+    uint64_t before = timerService.elapsedUs(id);
+    runFor(1000);
+    TEST_ASSERT_TRUE(timerService.isRunning(id));
+    TEST_ASSERT_EQUAL_UINT32(1, timerService.lapCount(id));
+    TEST_ASSERT_TRUE(timerService.elapsedUs(id) - before >= 1000000);
+}
+
+int main() {
+    fakeHw::reset();
+    fakeHw::clearNvs();
+    fakeHw::clearFlash();
+    fakeHw::serialEcho(false);
+    fakeHw::setDht(24.5f, 55.0f);
+    setup();
+    runFor(2000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_one_hour_countdown_has_no_drift);
+    RUN_TEST(test_expiry_raises_event_in_other_mode);
+    RUN_TEST(test_several_countdowns_and_pause);
+    RUN_TEST(test_full_slots_are_rejected);
+    RUN_TEST(test_stopwatch_laps_in_microseconds);
+    RUN_TEST(test_stopwatch_runs_in_background);
+    return UNITY_END();
+}
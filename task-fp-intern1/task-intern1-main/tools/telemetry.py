@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""Decoder telemetri biner dan pengirim perintah (lihat src/telemetry.h).
+
+Contoh:
+    python tools/telemetry.py /dev/ttyUSB0
+    python tools/telemetry.py /dev/ttyUSB0 --mode 2
+    python tools/telemetry.py /dev/ttyUSB0 --alarm 0 6 30 weekdays
+    python tools/telemetry.py /dev/ttyUSB0 --countdown 90 --stats --profile
+    python tools/telemetry.py /dev/ttyUSB0 --history 24 > riwayat.csv
+    python tools/telemetry.py /dev/ttyUSB0 --trace sesi.trc 60
+"""
+
+import argparse
+import calendar
+import struct
+import sys
+import time
+
+import serial  # pyserial
+
+BAUD = 921600
+
+MSG_SAMPLE = 0x01
+MSG_LOG = 0x02
+MSG_ACK = 0x03
+MSG_STATS = 0x04
+MSG_HISTORY = 0x05
+MSG_TRACE = 0x06
+
+CMD_SET_ALARM = 0x10
+CMD_START_COUNTDOWN = 0x11
+CMD_SET_MODE = 0x12
+CMD_QUERY_STATS = 0x13
+CMD_PROFILE = 0x14
+CMD_HISTORY = 0x15
+CMD_TRACE = 0x16
+
+ACK_STATUS = {0: "ok", 1: "invalid", 2: "unknown", 3: "busy"}
+DAYS = {"once": 0x00, "daily": 0x7F, "weekdays": 0x3E, "weekend": 0x41}
+
+SAMPLE = struct.Struct("<IhHIBBB")
+ACK = struct.Struct("<BBB")
+STATS = struct.Struct("<11I")
+HISTORY_POINT = struct.Struct("<IhHIB")
+HISTORY_POINTS_PER_FRAME = 120 // HISTORY_POINT.size
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, sama dengan crc16() di src/cobs.cpp."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_index = 0
+    code = 1
+    for byte in data:
+        if byte == 0:
+            out[code_index] = code
+            code_index = len(out)
+            out.append(0)
+            code = 1
+            continue
+        out.append(byte)
+        code += 1
+        if code == 0xFF:
+            out[code_index] = code
+            code_index = len(out)
+            out.append(0)
+            code = 1
+    out[code_index] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class Link:
+    def __init__(self, port):
+        self.port = serial.Serial(port, BAUD, timeout=0.05)
+        self.seq = 0
+        self.pending = bytearray()
+        self.crc_errors = 0
+
+    def send(self, msg_type, payload=b""):
+        raw = bytes([msg_type, self.seq]) + payload
+        raw += struct.pack("<H", crc16(raw))
+        self.port.write(cobs_encode(raw) + b"\x00")
+        self.seq = (self.seq + 1) & 0xFF
+
+    def frames(self):
+        """Frame valid yang sudah lengkap: (type, seq, payload)."""
+        self.pending += self.port.read(4096)
+        while b"\x00" in self.pending:
+            encoded, _, self.pending = self.pending.partition(b"\x00")
+            raw = cobs_decode(encoded) if encoded else None
+            if raw is None or len(raw) < 4:
+                continue
+            if crc16(raw[:-2]) != struct.unpack("<H", raw[-2:])[0]:
+                self.crc_errors += 1
+                continue
+            yield raw[0], raw[1], raw[2:-2]
+
+
+def show(msg_type, seq, payload):
+    if msg_type == MSG_SAMPLE and len(payload) == SAMPLE.size:
+        uptime, temp, hum, lux, servo, mode, flags = SAMPLE.unpack(payload)
+        dht = f"{temp / 100:6.2f} C {hum / 10:5.1f} %" if flags & 0x01 else "   DHT error   "
+        print(f"[{uptime / 1000:9.3f}] mode {mode} {dht} {lux:6d} lx servo {servo:3d}"
+              f"{' dark' if flags & 0x02 else ''}{' ALARM' if flags & 0x04 else ''}")
+    elif msg_type == MSG_LOG:
+        print(payload.decode("ascii", "replace"))
+    elif msg_type == MSG_ACK and len(payload) == ACK.size:
+        command, command_seq, status = ACK.unpack(payload)
+        print(f"ack 0x{command:02x} #{command_seq}: {ACK_STATUS.get(status, status)}")
+    elif msg_type == MSG_STATS and len(payload) == STATS.size:
+        fields = ("uptime_ms", "loop_avg_us", "loop_max_us", "frames", "frames_dropped",
+                  "tx_dropped", "rx_errors", "free_heap", "min_free_heap", "largest_free_block",
+                  "allocations")
+        print("stats: " + ", ".join(f"{k} {v}" for k, v in zip(fields, STATS.unpack(payload))))
+    elif msg_type == MSG_HISTORY:
+        for offset in range(0, len(payload) - HISTORY_POINT.size + 1, HISTORY_POINT.size):
+            stamp, temp, hum, lux, flags = HISTORY_POINT.unpack_from(payload, offset)
+            when = time.strftime("%Y-%m-%d %H:%M:%S", time.gmtime(stamp))
+            dht = f"{temp / 100:.2f},{hum / 10:.1f}" if flags & 0x01 else ","
+            print(f"{when},{dht},{lux}")
+    else:
+        print(f"type 0x{msg_type:02x} #{seq}: {payload.hex()}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("--mode", type=int, help="pindah ke mode 0-5")
+    parser.add_argument("--alarm", nargs=4, metavar=("SLOT", "HOUR", "MINUTE", "DAYS"),
+                        help="DAYS: once, daily, weekdays, weekend atau mask angka")
+    parser.add_argument("--alarm-off", type=int, metavar="SLOT")
+    parser.add_argument("--countdown", type=int, metavar="SECONDS")
+    parser.add_argument("--stats", action="store_true", help="minta frame MSG_STATS")
+    parser.add_argument("--profile", action="store_true", help="cetak histogram profiler")
+    parser.add_argument("--profile-reset", action="store_true")
+    parser.add_argument("--history", type=float, metavar="HOURS", help="ekspor riwayat N jam terakhir (CSV)")
+    parser.add_argument("--trace", nargs=2, metavar=("FILE", "SECONDS"),
+                        help="rekam input dan sensor untuk replay (test_replay)")
+    parser.add_argument("--once", action="store_true", help="keluar setelah perintah dibalas")
+    args = parser.parse_args()
+
+    link = Link(args.port)
+    if args.mode is not None:
+        link.send(CMD_SET_MODE, struct.pack("<B", args.mode))
+    if args.alarm:
+        slot, hour, minute, days = args.alarm
+        mask = DAYS[days] if days in DAYS else int(days, 0)
+        link.send(CMD_SET_ALARM, struct.pack("<5B", int(slot), int(hour), int(minute), mask, 1))
+    if args.alarm_off is not None:
+        link.send(CMD_SET_ALARM, struct.pack("<5B", args.alarm_off, 0, 0, 0, 0))
+    if args.countdown is not None:
+        link.send(CMD_START_COUNTDOWN, struct.pack("<I", args.countdown))
+    if args.stats:
+        link.send(CMD_QUERY_STATS)
+    if args.profile or args.profile_reset:
+        link.send(CMD_PROFILE, struct.pack("<B", 1 if args.profile_reset else 0))
+    if args.history is not None:
+        # RTC perangkat menyimpan waktu lokal, jadi "sekarang" juga waktu lokal
+        now = calendar.timegm(time.localtime())
+        link.send(CMD_HISTORY, struct.pack("<II", now - int(args.history * 3600), 0xFFFFFFFF))
+        print("time,temperature,humidity,lux")
+
+    trace = None
+    trace_stop = None
+    if args.trace:
+        # Isi MSG_TRACE ditulis apa adanya; frame yang hilang terlihat saat replay
+        trace = open(args.trace[0], "wb")
+        link.send(CMD_TRACE, struct.pack("<B", 1))
+        trace_stop = time.monotonic() + float(args.trace[1])
+
+    deadline = time.monotonic() + 1.0 if args.once else None
+    try:
+        while deadline is None or time.monotonic() < deadline:
+            if trace_stop is not None and time.monotonic() >= trace_stop:
+                link.send(CMD_TRACE, struct.pack("<B", 0))
+                trace_stop = None
+                deadline = time.monotonic() + 1.0  # Sisa ring dan TRACE_END
+            for frame in link.frames():
+                if frame[0] == MSG_TRACE and trace is not None:
+                    trace.write(frame[2])
+                    continue
+                if (args.once or args.history is not None) and frame[0] in (MSG_SAMPLE, MSG_LOG):
+                    continue
+                if args.history is not None and frame[0] == MSG_ACK:
+                    continue
+                show(*frame)
+                if args.history is not None and frame[0] == MSG_HISTORY and \
+                        len(frame[2]) < HISTORY_POINTS_PER_FRAME * HISTORY_POINT.size:
+                    deadline = 0  # Frame tidak penuh = akhir ekspor
+                    break
+    except KeyboardInterrupt:
+        if trace_stop is not None:
+            link.send(CMD_TRACE, struct.pack("<B", 0))
+    if trace is not None:
+        print(f"trace: {trace.tell()} byte ke {args.trace[0]}", file=sys.stderr)
+        trace.close()
+    if link.crc_errors:
+        print(f"{link.crc_errors} frame rusak", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()